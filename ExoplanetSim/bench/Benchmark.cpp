@@ -0,0 +1,178 @@
+// Benchmark.cpp
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Set by CMake from `git rev-parse`; lets results be matched to commits
+#ifndef EXOSIM_GIT_REVISION
+#define EXOSIM_GIT_REVISION "unknown"
+#endif
+
+namespace {
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void writeJsonString(std::ostream& out, const std::string& text)
+{
+    out << '"';
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '"' || text[i] == '\\')
+            out << '\\';
+        out << text[i];
+    }
+    out << '"';
+}
+} // namespace
+
+BenchmarkSuite::BenchmarkSuite(const std::string& name)
+    : name(name), sampleSeconds(0.05), sampleCount(7)
+{
+}
+
+bool BenchmarkSuite::parseArgs(int argc, char** argv, std::vector<std::string>* rest)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(arg, "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(arg, "--quick") == 0) {
+            sampleSeconds = 0.01;
+            sampleCount = 3;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            std::cout << "Usage: " << argv[0] << " [options]\n"
+                      << "  --out PATH     Write the JSON results to PATH instead of stdout\n"
+                      << "  --filter TEXT  Only run benchmarks whose name contains TEXT\n"
+                      << "  --quick        Fewer, shorter samples" << std::endl;
+            return false;
+        } else if (rest != nullptr) {
+            rest->push_back(arg);
+        } else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BenchmarkSuite::isSelected(const std::string& benchmark) const
+{
+    return filter.empty() || benchmark.find(filter) != std::string::npos;
+}
+
+void BenchmarkSuite::run(const std::string& benchmark, const std::function<void()>& body)
+{
+    if (!isSelected(benchmark))
+        return;
+
+    // Warm up, then double the iterations until a sample is long enough
+    body();
+    long long iterations = 1;
+    for (;;) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i)
+            body();
+        double elapsed = secondsSince(start);
+        if (elapsed >= sampleSeconds || iterations >= (1LL << 40))
+            break;
+        // Jump close to the target once the timing is meaningful
+        iterations = elapsed > sampleSeconds / 100.0
+            ? std::max(iterations * 2, static_cast<long long>(iterations * sampleSeconds / elapsed * 1.1))
+            : iterations * 2;
+    }
+
+    std::vector<double> samples;
+    for (int s = 0; s < sampleCount; ++s) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i)
+            body();
+        samples.push_back(secondsSince(start) * 1e9 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = benchmark;
+    result.unit = "ns";
+    result.iterations = iterations;
+    result.median = samples[samples.size() / 2];
+    result.min = samples.front();
+    result.max = samples.back();
+    results.push_back(result);
+
+    std::cerr << std::left << std::setw(40) << benchmark << std::right << std::fixed
+              << std::setprecision(1) << std::setw(14) << result.median << " ns/op  (min "
+              << result.min << ", " << iterations << " iterations)" << std::endl;
+}
+
+void BenchmarkSuite::addValue(const std::string& benchmark, const std::string& unit, double value)
+{
+    if (!isSelected(benchmark))
+        return;
+
+    Result result;
+    result.name = benchmark;
+    result.unit = unit;
+    result.iterations = 0;
+    result.median = result.min = result.max = value;
+    results.push_back(result);
+
+    std::cerr << std::left << std::setw(40) << benchmark << std::right << std::fixed
+              << std::setprecision(3) << std::setw(14) << value << ' ' << unit << std::endl;
+}
+
+bool BenchmarkSuite::writeJson() const
+{
+    std::ostringstream json;
+    json << std::setprecision(6);
+
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    json << "{\n  \"suite\": ";
+    writeJsonString(json, name);
+    json << ",\n  \"revision\": ";
+    writeJsonString(json, EXOSIM_GIT_REVISION);
+    json << ",\n  \"date\": ";
+    writeJsonString(json, date);
+#ifdef NDEBUG
+    json << ",\n  \"optimized\": true";
+#else
+    json << ",\n  \"optimized\": false";
+#endif
+    json << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeJsonString(json, result.name);
+        json << ", \"unit\": ";
+        writeJsonString(json, result.unit);
+        json << ", \"iterations\": " << result.iterations << ", \"median\": " << result.median
+             << ", \"min\": " << result.min << ", \"max\": " << result.max << "}";
+    }
+    json << "\n  ]\n}\n";
+
+    if (outputPath.empty()) {
+        std::cout << json.str();
+        return true;
+    }
+    std::ofstream file(outputPath.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not write results to " << outputPath << std::endl;
+        return false;
+    }
+    file << json.str();
+    std::cerr << "Results written to " << outputPath << std::endl;
+    return true;
+}
@@ -0,0 +1,62 @@
+// Benchmark.h
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark runner. Each benchmark is timed in several
+// samples of a calibrated number of iterations; results go to stdout (or
+// --out PATH) as JSON so runs of different commits can be diffed, and a
+// readable table goes to stderr.
+class BenchmarkSuite {
+public:
+    explicit BenchmarkSuite(const std::string& name);
+
+    // --out PATH, --filter TEXT, --quick; false on --help or bad input.
+    // Unrecognized arguments are kept in order for the caller.
+    bool parseArgs(int argc, char** argv, std::vector<std::string>* rest = nullptr);
+
+    // Time body(), which performs one operation per call
+    void run(const std::string& name, const std::function<void()>& body);
+
+    // Record a value measured by other means (e.g. frame times)
+    void addValue(const std::string& name, const std::string& unit, double value);
+
+    bool isSelected(const std::string& name) const;
+
+    bool writeJson() const;
+
+private:
+    struct Result {
+        std::string name;
+        std::string unit;
+        long long iterations; // 0 for recorded values
+        double median;        // Per operation
+        double min;
+        double max;
+    };
+
+    std::string name;
+    std::string outputPath;
+    std::string filter;
+    double sampleSeconds; // Target duration of one sample
+    int sampleCount;
+    std::vector<Result> results;
+};
+
+// Keeps the compiler from removing a computation whose result is unused
+template <typename T>
+inline void keepResult(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+#endif // BENCHMARK_H
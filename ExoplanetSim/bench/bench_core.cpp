@@ -0,0 +1,147 @@
+// bench_core.cpp
+//
+// CPU kernels of the simulation. Needs no window and no GL context: the
+// code under test only builds data that the GL classes would upload.
+
+#include "Benchmark.h"
+#include "Orbit.h"
+#include "Photometry.h"
+#include "PlanetModel.h"
+#include "RingMesh.h"
+#include "SphereMesh.h"
+#include "StarModel.h"
+#include "ThreadPool.h"
+#include "stb_image.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+static std::vector<unsigned char> readFile(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)),
+                                      std::istreambuf_iterator<char>());
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSuite suite("core");
+    if (!suite.parseArgs(argc, argv))
+        return 1;
+
+    // Orbit positions, as PlanetModel::update solves them every frame
+    KeplerOrbit circular(5.0, 0.0167, 65.25);
+    KeplerOrbit eccentric(5.0, 0.9, 65.25);
+    double time = 0.0;
+    suite.run("orbit/position e=0.0167", [&] {
+        time += 0.37;
+        keepResult(circular.getOffset(time));
+    });
+    suite.run("orbit/position e=0.9", [&] {
+        time += 0.37;
+        keepResult(eccentric.getOffset(time));
+    });
+
+    // Star color over the slider range
+    float temperature = 1000.0f;
+    suite.run("star/temperatureToColor", [&] {
+        temperature = temperature < 40000.0f ? temperature + 97.0f : 1000.0f;
+        keepResult(StarModel::temperatureToColor(temperature));
+    });
+
+    // A whole planet step (orbit solve plus bookkeeping), as the
+    // simulation core runs it without any render state
+    PlanetModel planet(1.0f, 1.0f, 288.0f, 0.0167f, 5.0f, 65.25f, 5.0f, "Terrestrial",
+                       glm::dvec3(0.0));
+    suite.run("planet/update", [&] {
+        planet.update(0.37f);
+        keepResult(planet.getPosition());
+    });
+
+    // Meshes at the quality governor's extremes
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    suite.run("mesh/sphere 16x8", [&] {
+        SphereMesh::generateSphere(1.0f, 16, 8, vertices, indices);
+        keepResult(indices.size());
+    });
+    suite.run("mesh/sphere 64x32", [&] {
+        SphereMesh::generateSphere(1.0f, 64, 32, vertices, indices);
+        keepResult(indices.size());
+    });
+    suite.run("mesh/sphere 256x128", [&] {
+        SphereMesh::generateSphere(1.0f, 256, 128, vertices, indices);
+        keepResult(indices.size());
+    });
+
+    std::vector<glm::vec3> ringVertices;
+    suite.run("mesh/ring 64", [&] {
+        RingMesh::GenerateRing(1.0f, 2.0f, 64, ringVertices, indices);
+        keepResult(indices.size());
+    });
+    suite.run("mesh/ring 1024", [&] {
+        RingMesh::GenerateRing(1.0f, 2.0f, 1024, ringVertices, indices);
+        keepResult(indices.size());
+    });
+
+    // Orbit paths as PlanetModel::generateOrbitPath builds them after an edit
+    std::vector<glm::vec3> path;
+    suite.run("orbit/path 1000 serial", [&] {
+        eccentric.samplePath(1000, path);
+        keepResult(path.data());
+    });
+    ThreadPool pool;
+    suite.run("orbit/path 1000 pooled", [&] {
+        eccentric.samplePath(1000, path, &pool);
+        keepResult(path.data());
+    });
+    suite.run("orbit/path 10000 pooled", [&] {
+        eccentric.samplePath(10000, path, &pool);
+        keepResult(path.data());
+    });
+
+    // Synthetic magnitudes of a whole catalog, every loaded band
+    Photometry photometry;
+    const char* filters[] = { "../data/filters/B.csv", "../data/filters/V.csv",
+                              "../data/filters/R.csv", "../data/filters/I.csv" };
+    for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); ++i)
+        photometry.loadFilter(filters[i]);
+    if (photometry.getFilterCount() > 0) {
+        const int catalogSize = 10000;
+        std::vector<float> temperatures(catalogSize), radii(catalogSize), distances(catalogSize);
+        for (int i = 0; i < catalogSize; ++i) {
+            temperatures[i] = 2500.0f + 37.0f * (i % 1000);
+            radii[i] = 0.2f + 0.01f * (i % 300);
+            distances[i] = 1.0f + 0.5f * (i % 2000);
+        }
+        std::vector<float> magnitudes(photometry.getFilterCount() * catalogSize);
+        suite.run("photometry/catalog 10000", [&] {
+            photometry.evaluate(catalogSize, &temperatures[0], &radii[0], &distances[0], &magnitudes[0]);
+            keepResult(magnitudes.data());
+        });
+    } else {
+        std::cerr << "Skipping photometry (no filters in ../data/filters)" << std::endl;
+    }
+
+    // Image decode as the texture loader's workers run it (from memory,
+    // so the disk is not measured)
+    const char* images[] = { "../textures/star.jpg", "../textures/image1.png" };
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); ++i) {
+        std::vector<unsigned char> encoded = readFile(images[i]);
+        if (encoded.empty()) {
+            std::cerr << "Skipping decode of " << images[i] << " (not found)" << std::endl;
+            continue;
+        }
+        suite.run(std::string("texture/decode ") + images[i], [&] {
+            int width, height, channels;
+            unsigned char* pixels = stbi_load_from_memory(&encoded[0], static_cast<int>(encoded.size()),
+                                                          &width, &height, &channels, 0);
+            keepResult(pixels);
+            stbi_image_free(pixels);
+        });
+    }
+
+    return suite.writeJson() ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// bench_render.cpp
+//
+// Full frames of the default scene, rendered headless. Takes the
+// application's options (size, --skybox, --target-ms, ...) besides the
+// benchmark ones; the frame count defaults to 300 of which the profiler's
+// history (the last 240) is reported.
+
+#include "Benchmark.h"
+#include "Application.h"
+
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    BenchmarkSuite suite("render");
+    std::vector<std::string> rest;
+    if (!suite.parseArgs(argc, argv, &rest))
+        return 1;
+
+    std::vector<char*> appArgs(1, argv[0]);
+    for (size_t i = 0; i < rest.size(); ++i)
+        appArgs.push_back(&rest[i][0]);
+
+    AppOptions options;
+    options.frames = 300;
+    if (!AppOptions::parse(static_cast<int>(appArgs.size()), &appArgs[0], options))
+        return 1;
+    options.headless = true;
+
+    Application app(options);
+    if (!app.initialize())
+        return 1;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    app.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const FrameProfiler& profiler = app.getProfiler();
+    FrameProfiler::Summary frame = profiler.getCpuSummary(FrameProfiler::CPU_FRAME);
+    suite.addValue("frame/cpu avg", "ms", frame.average);
+    suite.addValue("frame/cpu p95", "ms", frame.p95);
+    suite.addValue("frame/cpu p99", "ms", frame.p99);
+    suite.addValue("frame/throughput", "fps", seconds > 0.0 ? options.frames / seconds : 0.0);
+    suite.addValue("startup/first frame", "ms", app.getTimeToFirstFrame() * 1000.0);
+
+    for (int i = 0; i < FrameProfiler::CPU_SECTION_COUNT; ++i) {
+        FrameProfiler::CpuSection section = static_cast<FrameProfiler::CpuSection>(i);
+        FrameProfiler::Summary summary = profiler.getCpuSummary(section);
+        if (section != FrameProfiler::CPU_FRAME && summary.samples > 0)
+            suite.addValue(std::string("cpu/") + FrameProfiler::getCpuSectionName(section), "ms",
+                           summary.average);
+    }
+    for (int i = 0; i < FrameProfiler::GPU_SECTION_COUNT; ++i) {
+        FrameProfiler::GpuSection section = static_cast<FrameProfiler::GpuSection>(i);
+        FrameProfiler::Summary summary = profiler.getGpuSummary(section);
+        if (summary.samples > 0)
+            suite.addValue(std::string("gpu/") + FrameProfiler::getGpuSectionName(section), "ms",
+                           summary.average);
+    }
+
+    return suite.writeJson() ? 0 : 1;
+}
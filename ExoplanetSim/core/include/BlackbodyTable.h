@@ -0,0 +1,47 @@
+// BlackbodyTable.h
+
+#ifndef BLACKBODYTABLE_H
+#define BLACKBODYTABLE_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Display colors of blackbodies from MIN_TEMPERATURE to MAX_TEMPERATURE.
+// Every entry is a Planck spectrum integrated against the CIE 1931 color
+// matching functions, converted to sRGB and scaled so its brightest
+// channel is 1: the table holds chromaticity, brightness is up to the
+// caller.
+//
+// Entries are evenly spaced in 1 / T, which follows how fast the color
+// changes (quickly among cool stars, hardly at all among hot ones). The
+// same table is uploaded as a 1D texture (BlackbodyTexture); shaders map
+// a temperature to a texture coordinate exactly like getCoordinate.
+class BlackbodyTable {
+public:
+    static const int SIZE = 256;
+    static const float MIN_TEMPERATURE; // Kelvin
+    static const float MAX_TEMPERATURE;
+
+    // The table, built on first use
+    static const BlackbodyTable& get();
+
+    // Interpolated color; temperatures outside the range are clamped
+    glm::vec3 lookup(float temperature) const;
+
+    // SIZE rgb triples, coolest first
+    const float* getData() const;
+
+    // Position of a temperature in the table (0..1)
+    static float getCoordinate(float temperature);
+
+    // Planck's law for a wavelength in nanometers, up to a constant
+    // factor (shared by everything that only compares spectra)
+    static double planck(double wavelength, double temperature);
+
+private:
+    std::vector<float> rgb;
+
+    BlackbodyTable();
+};
+
+#endif // BLACKBODYTABLE_H
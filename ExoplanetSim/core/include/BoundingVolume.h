@@ -0,0 +1,42 @@
+// BoundingVolume.h
+
+#ifndef BOUNDINGVOLUME_H
+#define BOUNDINGVOLUME_H
+
+#include <glm/glm.hpp>
+
+// Sphere used to bound stars and planets
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+
+    BoundingSphere() : center(0.0f), radius(0.0f) {}
+    BoundingSphere(const glm::vec3& center, float radius)
+        : center(center), radius(radius) {}
+};
+
+// Axis-aligned box used to bound orbit paths and whole systems
+struct BoundingBox {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    BoundingBox() : min(0.0f), max(0.0f) {}
+    BoundingBox(const glm::vec3& min, const glm::vec3& max)
+        : min(min), max(max) {}
+
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+
+    // Grow the box so that it also contains the given box
+    void expand(const BoundingBox& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    // Grow the box so that it also contains the given sphere
+    void expand(const BoundingSphere& sphere) {
+        expand(BoundingBox(sphere.center - glm::vec3(sphere.radius),
+                           sphere.center + glm::vec3(sphere.radius)));
+    }
+};
+
+#endif // BOUNDINGVOLUME_H
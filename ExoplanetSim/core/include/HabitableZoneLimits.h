@@ -0,0 +1,22 @@
+// HabitableZoneLimits.h
+
+#ifndef HABITABLEZONELIMITS_H
+#define HABITABLEZONELIMITS_H
+
+// Edges of a star's habitable zone, in AU: the distances at which the
+// star delivers 1.1 (inner) and 0.53 (outer) times the flux Earth gets
+// from the Sun
+struct HabitableZoneLimits {
+    float inner;
+    float outer;
+
+    HabitableZoneLimits() : inner(0.0f), outer(0.0f) {}
+    HabitableZoneLimits(float inner, float outer) : inner(inner), outer(outer) {}
+
+    // Luminosity in solar units
+    static HabitableZoneLimits fromLuminosity(float luminosity);
+
+    bool contains(float distance) const { return distance >= inner && distance <= outer; }
+};
+
+#endif // HABITABLEZONELIMITS_H
@@ -0,0 +1,40 @@
+// MoonModel.h
+
+#ifndef MOONMODEL_H
+#define MOONMODEL_H
+
+#include <glm/glm.hpp>
+
+// Small body on a circular, inclined orbit around a planet. Needs no GL
+// context; the Moon render class adds the mesh and color on top.
+class MoonModel {
+public:
+    MoonModel(float radius, float distance, float period, float phase, float inclination);
+
+    // Advance along the orbit
+    void update(float deltaTime);
+
+    // Multiply the radius and orbit distance (the parent planet was
+    // resized); the period and the place along the orbit are kept
+    void setScale(float factor);
+
+    // Position around the parent (double precision world space)
+    glm::dvec3 getPosition(const glm::dvec3& parentPosition) const;
+
+    float getRadius() const;
+    float getDistance() const;
+    float getPeriod() const;
+
+    // Fraction of the current period traveled (0..1)
+    float getOrbitPhase() const;
+
+private:
+    float radius;
+    float distance;    // Orbit radius around the parent
+    float period;
+    float phase;       // Starting angle, radians
+    float inclination; // Tilt of the orbit plane from the ecliptic, radians
+    float currentTime;
+};
+
+#endif // MOONMODEL_H
@@ -0,0 +1,30 @@
+// Orbit.h
+
+#ifndef ORBIT_H
+#define ORBIT_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+class ThreadPool;
+
+// Keplerian orbit in the xz plane with the focus at the origin. Pure math:
+// no rendering state, so it can be used and measured without a context.
+class KeplerOrbit {
+public:
+    KeplerOrbit(double distance, double eccentricity, double period);
+
+    // Position relative to the focus, time since periapsis
+    glm::dvec3 getOffset(double time) const;
+
+    // segments + 1 points over one period; the pool, if any, splits the
+    // points between its workers
+    void samplePath(int segments, std::vector<glm::vec3>& path, ThreadPool* pool = nullptr) const;
+
+private:
+    double distance;
+    double eccentricity;
+    double period;
+};
+
+#endif // ORBIT_H
@@ -0,0 +1,83 @@
+// Photometry.h
+
+#ifndef PHOTOMETRY_H
+#define PHOTOMETRY_H
+
+#include <string>
+#include <vector>
+
+// Passband loaded from a CSV of wavelength_nm,response rows. Comment
+// lines name the band and give the Sun's absolute magnitude in it, which
+// sets the zero point:
+//   # name V
+//   # solar_absolute_magnitude 4.81
+struct PhotometricFilter {
+    std::string name;
+    float solarAbsoluteMagnitude;
+    std::vector<double> wavelength; // Nanometers, increasing
+    std::vector<double> response;
+
+    PhotometricFilter() : solarAbsoluteMagnitude(0.0f) {}
+
+    static bool load(const std::string& path, PhotometricFilter& filter);
+};
+
+// Synthetic magnitudes of blackbody stars. For every filter a table of
+// the band flux over temperature (relative to the Sun, 1/T spacing like
+// BlackbodyTable) is integrated once; a magnitude is then one table
+// interpolation plus the radius and distance terms.
+//
+// Magnitudes are zero-pointed on a solar blackbody (SOLAR_TEMPERATURE,
+// one solar radius) having the Sun's absolute magnitude in each band.
+class Photometry {
+public:
+    static const int TABLE_SIZE = 512;
+    static const float SOLAR_TEMPERATURE; // Kelvin
+
+    // Integrate the filter's response table; false if it has no usable
+    // curve
+    bool addFilter(const PhotometricFilter& filter);
+    bool loadFilter(const std::string& path);
+
+    int getFilterCount() const;
+    const std::string& getFilterName(int filter) const;
+    int findFilter(const std::string& name) const; // -1 if missing
+
+    // Radius in solar radii, distance in parsecs (clamped to a tiny
+    // minimum, so zero gives a finite magnitude)
+    float absoluteMagnitude(int filter, float temperature, float radius) const;
+    float apparentMagnitude(int filter, float temperature, float radius, float distance) const;
+
+    // Magnitude in one filter minus another (e.g. B - V) for a temperature
+    float colorIndex(int filter, int reference, float temperature) const;
+
+    // Whole catalogs, structure of arrays: magnitudes[f * count + i] is
+    // star i in filter f. The loops are branch-free over contiguous
+    // arrays so the compiler vectorizes them (the core builds with -O3 in
+    // the default Release configuration).
+    void evaluate(int count, const float* temperature, const float* radius,
+                  const float* distance, float* magnitudes) const;
+
+    // colors[f * count + i]: filter f minus the reference for star i
+    void evaluateColors(int count, const float* temperature, int reference,
+                        float* colors) const;
+
+private:
+    struct Band {
+        std::string name;
+        float solarAbsoluteMagnitude;
+        // -2.5 log10 of the band flux per unit area relative to the
+        // solar blackbody's, over 1/T
+        std::vector<float> magnitudeOffset;
+    };
+
+    std::vector<Band> bands;
+
+    float offsetAt(const Band& band, float temperature) const;
+
+    // Table position of each temperature (0..TABLE_SIZE - 1)
+    static void tablePositions(int count, const float* temperature, float* positions);
+    static void gatherOffsets(const Band& band, int count, const float* positions, float* out);
+};
+
+#endif // PHOTOMETRY_H
@@ -0,0 +1,109 @@
+// PlanetModel.h
+
+#ifndef PLANETMODEL_H
+#define PLANETMODEL_H
+
+#include "BoundingVolume.h"
+#include "ThreadPool.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Physical state and Keplerian orbit of a planet. Needs no GL context;
+// the Planet render class adds the mesh and surface texture on top.
+class PlanetModel {
+public:
+    PlanetModel(
+        float mass,
+        float radius,
+        float temperature,
+        float eccentricity,
+        float orbitalDistance,
+        float orbitalPeriod,
+        float semiMajorAxis,
+        const std::string& planetType,
+        const glm::dvec3& orbitCenter
+    );
+
+    // Update the planet's position
+    void update(float deltaTime);
+
+    // Setters and Getters
+    void setMass(float mass);
+    float getMass() const;
+
+    void setRadius(float radius);
+    float getRadius() const;
+
+    void setTemperature(float temperature);
+    float getTemperature() const;
+
+    void setEccentricity(float eccentricity);
+    float getEccentricity() const;
+
+    void setOrbitalDistance(float distance);
+    float getOrbitalDistance() const;
+
+    void setOrbitalPeriod(float period);
+    float getOrbitalPeriod() const;
+
+    void setSemiMajorAxis(float sma);
+    float getSemiMajorAxis() const;
+
+    void setPlanetType(const std::string& type);
+    std::string getPlanetType() const;
+
+    // Detail used by the quality governor
+    void setOrbitSegments(int segments);
+
+    // Generate the orbit path (on the pool's workers once one is set)
+    void generateOrbitPath(int segments);
+    void setThreadPool(ThreadPool* pool);
+
+    // Orbit path relative to the orbit center, one point per time step;
+    // drawn through the shared OrbitBatch
+    const std::vector<glm::vec3>& getOrbitPath() const;
+
+    // Incremented whenever the path is regenerated
+    unsigned int getOrbitRevision() const;
+
+    // Fraction of the current period already traveled (0..1)
+    float getOrbitPhase() const;
+
+    // Getter for current position (double precision world space)
+    glm::dvec3 getPosition() const;
+
+    // Center of the orbit; orbit path vertices are stored relative to it
+    glm::dvec3 getOrbitCenter() const;
+
+    // Bounding box of the precomputed orbit path, relative to the orbit center
+    BoundingBox getOrbitBounds() const;
+
+private:
+    // Fundamental parameters
+    float mass;
+    float radius;
+    float temperature;
+    float eccentricity;
+    float orbitalDistance;
+    float orbitalPeriod;
+    float semiMajorAxis;
+    std::string planetType;
+
+    glm::dvec3 orbitCenter;
+    glm::dvec3 position;
+    float currentTime;
+
+    // Orbit path data (relative to orbitCenter so floats stay precise)
+    std::vector<glm::vec3> orbitPositions;
+    BoundingBox orbitBounds;
+    unsigned int orbitRevision;
+    size_t maxOrbitPoints; // Maximum number of points to store
+    ThreadPool* pool;      // Optional; orbit points are independent
+
+    // Utility functions
+    glm::dvec3 calculateOrbitalPosition(double time) const;
+    glm::dvec3 calculateOrbitalOffset(double time) const;
+};
+
+#endif // PLANETMODEL_H
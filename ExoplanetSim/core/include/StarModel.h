@@ -0,0 +1,80 @@
+// StarModel.h
+
+#ifndef STARMODEL_H
+#define STARMODEL_H
+
+#include "HabitableZoneLimits.h"
+#include <glm/glm.hpp>
+#include <string>
+
+// Physical state of a star. Needs no GL context; the Star render class
+// adds the mesh and texture on top.
+class StarModel {
+public:
+    StarModel(
+        float mass,
+        float radius,
+        float effectiveTemperature,
+        float luminosity,
+        float surfaceGravity,
+        float metallicity,
+        const glm::dvec3& position,
+        const glm::vec3& velocity,
+        const std::string& chemicalComposition
+    );
+
+    // Update the star's position based on motion
+    void update(float deltaTime);
+
+    // Setters and Getters for hyperparameters
+    void setMass(float mass);
+    float getMass() const;
+
+    void setRadius(float radius);
+    float getRadius() const;
+
+    void setEffectiveTemperature(float temperature);
+    float getEffectiveTemperature() const;
+
+    void setLuminosity(float luminosity);
+    float getLuminosity() const;
+
+    void setSurfaceGravity(float gravity);
+    float getSurfaceGravity() const;
+
+    void setMetallicity(float metallicity);
+    float getMetallicity() const;
+
+    void setPosition(const glm::dvec3& position);
+    glm::dvec3 getPosition() const;
+
+    void setVelocity(const glm::vec3& velocity);
+    glm::vec3 getVelocity() const;
+
+    void setChemicalComposition(const std::string& composition);
+    std::string getChemicalComposition() const;
+
+    glm::vec3 getColor() const;
+
+    // Habitable zone for the current luminosity
+    HabitableZoneLimits getHabitableZone() const;
+
+    // Blackbody color of a temperature (BlackbodyTable)
+    static glm::vec3 temperatureToColor(float temperature);
+
+private:
+    // Fundamental parameters
+    float mass;
+    float radius;
+    float effectiveTemperature;
+    float luminosity;
+    float surfaceGravity;
+    float metallicity;
+    std::string chemicalComposition;
+
+    // Position (double precision world space) and motion
+    glm::dvec3 position;
+    glm::vec3 velocity;
+};
+
+#endif // STARMODEL_H
@@ -0,0 +1,123 @@
+// StateFeed.h
+
+#ifndef STATEFEED_H
+#define STATEFEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Live simulation state in a POSIX shared-memory object, for local
+// analysis tools (tools/statefeed.py reads it from Python). One process
+// writes; any number of readers map the object and take the newest
+// frame without sockets or serialization.
+//
+// The layout below is the contract with the readers: fixed-size,
+// native-endian structs, versioned by STATE_FEED_VERSION. Change it only
+// together with the version and the Python reader.
+//
+// Frames go round a ring of slots, each guarded by a sequence lock: the
+// sequence is odd while the writer fills the slot, and a reader whose
+// copy saw two different sequences retries. The writer never waits for
+// readers.
+
+const uint32_t STATE_FEED_VERSION = 1;
+const uint32_t STATE_FEED_MAX_BODIES = 8;
+
+enum StateFeedBodyKind {
+    FEED_STAR = 0,
+    FEED_PLANET = 1,
+    FEED_MOON = 2
+};
+
+// 72 bytes
+struct StateFeedBody {
+    uint32_t kind;               // StateFeedBodyKind
+    int32_t parent;              // Index of the body it orbits, -1 for none
+    double position[3];          // World space, AU
+    float mass;                  // Solar masses
+    float radius;
+    float temperature;           // Kelvin (effective temperature for stars)
+    float semiMajorAxis;         // Orbit around the parent, AU (0 for stars)
+    float eccentricity;
+    float period;                // Days
+    float phase;                 // Fraction of the period traveled (0..1)
+    float starDistance;          // AU
+    float flux;                  // Stellar flux relative to Earth's
+    float equilibriumTemperature; // Kelvin, zero albedo
+};
+
+// 32 + 8 * 72 bytes
+struct StateFeedFrame {
+    uint64_t frame;              // Frames published before this one
+    double time;                 // Simulation time, days
+    float luminosity;            // Of the star, solar units
+    float habitableInner;        // AU
+    float habitableOuter;
+    uint32_t bodyCount;
+    StateFeedBody bodies[STATE_FEED_MAX_BODIES];
+};
+
+// 64 bytes at offset 0; the slots follow it
+struct StateFeedHeader {
+    char magic[8];               // "EXOFEED\0"
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    uint32_t maxBodies;
+    uint32_t writerPid;
+    std::atomic<uint64_t> published; // The newest frame is in slot (published - 1) % slotCount
+    uint8_t reserved[24];
+};
+
+struct StateFeedSlot {
+    std::atomic<uint32_t> sequence; // Odd while the writer fills the slot
+    uint32_t reserved;
+    StateFeedFrame frame;
+};
+
+class StateFeed {
+public:
+    StateFeed();
+    ~StateFeed();
+
+    // Create the shared-memory object (replacing a stale one) and become
+    // its writer; the name is "/" followed by up to 30 characters
+    bool create(const std::string& name, uint32_t slotCount = 8);
+
+    // Map an existing feed for reading
+    bool open(const std::string& name);
+
+    // Unmap; the writer also removes the name
+    void close();
+
+    bool isOpen() const;
+    const std::string& getName() const;
+
+    // Writer: copy the frame into the next slot
+    void publish(const StateFeedFrame& frame);
+
+    // Reader: the newest complete frame; false if nothing was published
+    // yet or the writer kept overwriting the slot
+    bool readLatest(StateFeedFrame& frame) const;
+
+    // Frames published so far
+    uint64_t getPublishedCount() const;
+
+private:
+    std::string name;
+    bool writer;
+    void* mapping;
+    size_t mappingSize;
+    StateFeedHeader* header;
+    StateFeedSlot* slots;
+
+    bool map(int fd, size_t size, bool writable);
+
+    StateFeed(const StateFeed&);
+    StateFeed& operator=(const StateFeed&);
+};
+
+#endif // STATEFEED_H
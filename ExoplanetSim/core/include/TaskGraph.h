@@ -0,0 +1,72 @@
+// TaskGraph.h
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Tasks with dependencies, run on a ThreadPool. A task starts as soon as
+// everything it depends on has finished; independent tasks run in
+// parallel. The graph can be run again (e.g. once per frame) without
+// rebuilding it.
+//
+// Caller tasks run on the thread that calls run() instead, interleaved
+// with the pool's work as they become ready; that is how GL work (which
+// needs the context's thread) joins a graph.
+class TaskGraph {
+public:
+    TaskGraph();
+
+    // Add a task; returns its handle
+    int add(std::function<void()> task);
+
+    // Add a task that runs on the thread calling run()
+    int addOnCaller(std::function<void()> task);
+
+    // 'after' does not start before 'before' has finished
+    void precede(int before, int after);
+
+    // Run every task and wait for all of them. With caller tasks, call it
+    // from outside the pool.
+    void run(ThreadPool& pool);
+
+    void clear();
+    size_t size() const;
+
+private:
+    struct Node {
+        std::function<void()> task;
+        std::vector<int> successors;
+        int dependencies;
+        std::atomic<int> remaining; // Dependencies not finished in this run
+        bool onCaller;
+
+        Node() : dependencies(0), remaining(0), onCaller(false) {}
+    };
+
+    // One run; shared with the tasks, which may finish after run() returns
+    struct Run {
+        TaskCounter finished;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<int> callerReady; // Caller tasks whose dependencies are done
+
+        explicit Run(int count) : finished(count) {}
+    };
+
+    std::vector<std::unique_ptr<Node> > nodes;
+    bool hasCallerTasks;
+
+    void submit(ThreadPool& pool, int node, const std::shared_ptr<Run>& state);
+    void execute(ThreadPool& pool, int node, const std::shared_ptr<Run>& state);
+};
+
+#endif // TASKGRAPH_H
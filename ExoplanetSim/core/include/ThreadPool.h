@@ -0,0 +1,109 @@
+// ThreadPool.h
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Outstanding work that a thread can wait for. Shared with the tasks that
+// signal it, so it may outlive the waiter.
+class TaskCounter {
+public:
+    explicit TaskCounter(int count = 0);
+
+    void add(int count);
+    void done();
+    bool isDone() const;
+
+private:
+    friend class ThreadPool;
+
+    std::atomic<int> remaining;
+    std::mutex mutex;
+    std::condition_variable zero;
+};
+
+// Job system for CPU-only work (simulation, orbit generation, image
+// decode and encode). Tasks must not touch OpenGL: the context lives on
+// the main thread.
+//
+// Every worker owns a deque: tasks it spawns go to the back and are taken
+// from the back (hot in cache), and idle workers steal from the front of
+// the others'. A worker that waits for work it spawned runs other tasks
+// meanwhile, so nested parallelFor and task graphs cannot deadlock.
+// Other threads never run queued tasks: the main thread only runs the
+// chunks of its own parallelFor, so a long decode can never delay a
+// frame.
+class ThreadPool {
+public:
+    // 0 picks hardware_concurrency - 1 (at least one worker)
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    void enqueue(std::function<void()> task);
+
+    // Tasks queued or running
+    size_t getPendingCount() const;
+
+    // Block until every queued task has finished. Must not be called from
+    // a worker thread.
+    void waitIdle();
+
+    // Block until the counter reaches zero; workers run tasks meanwhile
+    void wait(TaskCounter& counter);
+
+    // Run body(i) for every i in [0, count) and wait for those calls only.
+    // Indices are handed out in chunks of grainSize; the calling thread
+    // takes chunks too.
+    void parallelFor(int count, const std::function<void(int)>& body, int grainSize = 1);
+
+    unsigned int getThreadCount() const;
+
+    // Index of the calling worker in this pool, -1 on any other thread
+    int getWorkerIndex() const;
+
+    // Tasks taken from another worker's deque since startup
+    size_t getStealCount() const;
+
+    // Whether threads outside the pool take chunks of their own
+    // parallelFor (default) or only wait, leaving all work to the workers
+    void setExternalThreadsHelp(bool help);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker> > queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> pending;  // Queued or running
+    std::atomic<size_t> queued;   // Waiting in a deque
+    std::atomic<unsigned int> nextQueue; // Round-robin target for outside threads
+    std::atomic<size_t> steals;
+    std::atomic<bool> externalThreadsHelp;
+
+    std::mutex sleepMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable idle;
+    bool stopping;
+
+    // Take a task from the worker's own deque, or steal one
+    bool takeTask(int worker, std::function<void()>& task);
+    bool runOne(int worker);
+    void finishTask();
+    void workerLoop(int index);
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif // THREADPOOL_H
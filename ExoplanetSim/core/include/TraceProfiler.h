@@ -0,0 +1,78 @@
+// TraceProfiler.h
+
+#ifndef TRACEPROFILER_H
+#define TRACEPROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped CPU zones for the Chrome trace viewer (chrome://tracing,
+// ui.perfetto.dev). Every thread writes its zones to its own ring buffer
+// without locks; export copies the rings while the threads keep running,
+// so a trace can be taken at any time. The ring keeps the newest
+// RING_SIZE zones of each thread.
+//
+// A zone costs two clock reads, three relaxed stores and one release
+// store (plus a release fence, free on x86), and nothing while tracing
+// is disabled, so the zones stay in release builds. Define
+// EXOSIM_NO_TRACE to compile them out entirely.
+//
+// Zone names must be string literals: only the pointer is stored.
+class TraceProfiler {
+public:
+    static const uint32_t RING_SIZE = 1u << 14; // Zones kept per thread
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Name shown for the calling thread
+    static void setThreadName(const std::string& name);
+
+    // Nanoseconds since the profiler's epoch
+    static uint64_t now();
+
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    // Write every thread's zones as trace_event JSON
+    static bool exportChromeTrace(const std::string& path);
+
+    // Zones recorded since startup, including overwritten ones
+    static uint64_t getZoneCount();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// Records the lifetime of the object as a zone
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name(TraceProfiler::isEnabled() ? name : nullptr),
+          start(this->name ? TraceProfiler::now() : 0) {}
+
+    ~TraceScope() {
+        if (name)
+            TraceProfiler::record(name, start, TraceProfiler::now());
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+};
+
+#define EXOSIM_TRACE_CONCAT_(a, b) a##b
+#define EXOSIM_TRACE_CONCAT(a, b) EXOSIM_TRACE_CONCAT_(a, b)
+
+#ifdef EXOSIM_NO_TRACE
+#define TRACE_ZONE(name) ((void)0)
+#else
+#define TRACE_ZONE(name) TraceScope EXOSIM_TRACE_CONCAT(traceZone, __LINE__)(name)
+#endif
+
+#define TRACE_FUNCTION() TRACE_ZONE(__FUNCTION__)
+
+#endif // TRACEPROFILER_H
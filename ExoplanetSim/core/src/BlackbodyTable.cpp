@@ -0,0 +1,120 @@
+// BlackbodyTable.cpp
+
+#include "BlackbodyTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float BlackbodyTable::MIN_TEMPERATURE = 1000.0f;
+const float BlackbodyTable::MAX_TEMPERATURE = 40000.0f;
+
+namespace {
+
+// Visible range and integration step, nanometers
+const double FIRST_WAVELENGTH = 360.0;
+const double LAST_WAVELENGTH = 830.0;
+const double WAVELENGTH_STEP = 1.0;
+
+// Second radiation constant hc / k, nanometer kelvin
+const double C2 = 1.4387769e7;
+
+// Piecewise Gaussian with separate widths left and right of the peak
+double lobe(double wavelength, double peak, double left, double right)
+{
+    double t = (wavelength - peak) / (wavelength < peak ? left : right);
+    return std::exp(-0.5 * t * t);
+}
+
+// CIE 1931 2-degree color matching functions, multi-lobe fit of Wyman,
+// Sloan and Shirley (2013); within the tabulated data's own precision
+// for integrating smooth spectra
+void colorMatching(double wavelength, double& x, double& y, double& z)
+{
+    x = 1.056 * lobe(wavelength, 599.8, 37.9, 31.0) +
+        0.362 * lobe(wavelength, 442.0, 16.0, 26.7) -
+        0.065 * lobe(wavelength, 501.1, 20.4, 26.2);
+    y = 0.821 * lobe(wavelength, 568.8, 46.9, 40.5) +
+        0.286 * lobe(wavelength, 530.9, 16.3, 31.1);
+    z = 1.217 * lobe(wavelength, 437.0, 11.8, 36.0) +
+        0.681 * lobe(wavelength, 459.0, 26.0, 13.8);
+}
+
+// sRGB transfer function
+float encodeSrgb(double linear)
+{
+    return static_cast<float>(linear <= 0.0031308 ? 12.92 * linear
+                                                  : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055);
+}
+
+} // namespace
+
+const BlackbodyTable& BlackbodyTable::get()
+{
+    static const BlackbodyTable table;
+    return table;
+}
+
+BlackbodyTable::BlackbodyTable()
+    : rgb(SIZE * 3)
+{
+    int samples = static_cast<int>((LAST_WAVELENGTH - FIRST_WAVELENGTH) / WAVELENGTH_STEP) + 1;
+    std::vector<double> cmfX(samples), cmfY(samples), cmfZ(samples);
+    for (int i = 0; i < samples; ++i)
+        colorMatching(FIRST_WAVELENGTH + i * WAVELENGTH_STEP, cmfX[i], cmfY[i], cmfZ[i]);
+
+    double inverseMin = 1.0 / MIN_TEMPERATURE;
+    double inverseMax = 1.0 / MAX_TEMPERATURE;
+    for (int entry = 0; entry < SIZE; ++entry) {
+        double temperature = 1.0 / (inverseMin + (inverseMax - inverseMin) * entry / (SIZE - 1));
+
+        double X = 0.0, Y = 0.0, Z = 0.0;
+        for (int i = 0; i < samples; ++i) {
+            double radiance = planck(FIRST_WAVELENGTH + i * WAVELENGTH_STEP, temperature);
+            X += radiance * cmfX[i];
+            Y += radiance * cmfY[i];
+            Z += radiance * cmfZ[i];
+        }
+
+        // XYZ to linear sRGB (D65). Cool blackbodies lie outside the
+        // gamut; the negative channel is clipped.
+        double r = std::max(0.0,  3.2404542 * X - 1.5371385 * Y - 0.4985314 * Z);
+        double g = std::max(0.0, -0.9692660 * X + 1.8760108 * Y + 0.0415560 * Z);
+        double b = std::max(0.0,  0.0556434 * X - 0.2040259 * Y + 1.0572252 * Z);
+        double brightest = std::max(r, std::max(g, b));
+
+        rgb[entry * 3 + 0] = encodeSrgb(r / brightest);
+        rgb[entry * 3 + 1] = encodeSrgb(g / brightest);
+        rgb[entry * 3 + 2] = encodeSrgb(b / brightest);
+    }
+}
+
+glm::vec3 BlackbodyTable::lookup(float temperature) const
+{
+    float position = getCoordinate(temperature) * (SIZE - 1);
+    int entry = std::min(static_cast<int>(position), SIZE - 2);
+    float t = position - entry;
+
+    const float* a = &rgb[entry * 3];
+    const float* b = a + 3;
+    return glm::vec3(a[0] + (b[0] - a[0]) * t,
+                     a[1] + (b[1] - a[1]) * t,
+                     a[2] + (b[2] - a[2]) * t);
+}
+
+const float* BlackbodyTable::getData() const
+{
+    return &rgb[0];
+}
+
+double BlackbodyTable::planck(double wavelength, double temperature)
+{
+    double w5 = std::pow(wavelength * 1e-3, 5.0); // Micrometers keep the range sane
+    return 1.0 / (w5 * (std::exp(C2 / (wavelength * temperature)) - 1.0));
+}
+
+float BlackbodyTable::getCoordinate(float temperature)
+{
+    temperature = std::min(std::max(temperature, MIN_TEMPERATURE), MAX_TEMPERATURE);
+    return (1.0f / MIN_TEMPERATURE - 1.0f / temperature) /
+           (1.0f / MIN_TEMPERATURE - 1.0f / MAX_TEMPERATURE);
+}
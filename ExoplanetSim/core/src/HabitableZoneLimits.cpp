@@ -0,0 +1,18 @@
+// HabitableZoneLimits.cpp
+
+#include "HabitableZoneLimits.h"
+#include <cmath>
+
+namespace {
+// Effective stellar flux at the edges, relative to Earth's
+const float INNER_FLUX = 1.1f;
+const float OUTER_FLUX = 0.53f;
+} // namespace
+
+HabitableZoneLimits HabitableZoneLimits::fromLuminosity(float luminosity)
+{
+    if (luminosity <= 0.0f)
+        return HabitableZoneLimits();
+    return HabitableZoneLimits(std::sqrt(luminosity / INNER_FLUX),
+                               std::sqrt(luminosity / OUTER_FLUX));
+}
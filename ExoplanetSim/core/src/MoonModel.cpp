@@ -0,0 +1,45 @@
+// MoonModel.cpp
+
+#include "MoonModel.h"
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+MoonModel::MoonModel(float radius, float distance, float period, float phase, float inclination)
+    : radius(radius),
+      distance(distance),
+      period(period),
+      phase(phase),
+      inclination(inclination),
+      currentTime(0.0f)
+{
+}
+
+void MoonModel::update(float deltaTime)
+{
+    currentTime += deltaTime;
+    if (currentTime > period)
+        currentTime = std::fmod(currentTime, period);
+}
+
+void MoonModel::setScale(float factor)
+{
+    radius *= factor;
+    distance *= factor;
+}
+
+glm::dvec3 MoonModel::getPosition(const glm::dvec3& parentPosition) const
+{
+    double angle = phase + 2.0 * glm::pi<double>() * currentTime / period;
+    double x = distance * std::cos(angle);
+    double z = distance * std::sin(angle);
+    return parentPosition + glm::dvec3(x, z * std::sin(inclination), z * std::cos(inclination));
+}
+
+float MoonModel::getRadius() const { return radius; }
+float MoonModel::getDistance() const { return distance; }
+float MoonModel::getPeriod() const { return period; }
+
+float MoonModel::getOrbitPhase() const
+{
+    return period > 0.0f ? currentTime / period : 0.0f;
+}
@@ -0,0 +1,58 @@
+// Orbit.cpp
+
+#include "Orbit.h"
+#include "ThreadPool.h"
+
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+KeplerOrbit::KeplerOrbit(double distance, double eccentricity, double period)
+    : distance(distance), eccentricity(eccentricity), period(period)
+{
+}
+
+glm::dvec3 KeplerOrbit::getOffset(double time) const
+{
+    double e = eccentricity;
+
+    // Mean Anomaly (M)
+    double meanAnomaly = (2.0 * glm::pi<double>() / period) * time;
+
+    // Solve Kepler's Equation for Eccentric Anomaly (E)
+    double E = meanAnomaly;
+    for (int i = 0; i < 5; ++i) {
+        E = meanAnomaly + e * sin(E);
+    }
+
+    // True Anomaly (v)
+    double sinV = sqrt(1.0 - e * e) * sin(E) / (1.0 - e * cos(E));
+    double cosV = (cos(E) - e) / (1.0 - e * cos(E));
+    double trueAnomaly = atan2(sinV, cosV);
+
+    // Distance from focus to planet
+    double r = distance * (1.0 - e * e) / (1.0 + e * cos(trueAnomaly));
+
+    // Position in orbital plane
+    double x = r * cos(trueAnomaly);
+    double z = r * sin(trueAnomaly);
+    double y = 0.0;
+
+    return glm::dvec3(x, y, z);
+}
+
+void KeplerOrbit::samplePath(int segments, std::vector<glm::vec3>& path, ThreadPool* pool) const
+{
+    path.resize(segments + 1);
+
+    // Each point solves Kepler's equation on its own
+    double step = period / segments;
+    std::function<void(int)> point = [this, step, &path](int i) {
+        path[i] = glm::vec3(getOffset(i * step));
+    };
+    if (pool) {
+        pool->parallelFor(segments + 1, point, 64);
+    } else {
+        for (int i = 0; i <= segments; ++i)
+            point(i);
+    }
+}
@@ -0,0 +1,230 @@
+// Photometry.cpp
+
+#include "Photometry.h"
+#include "BlackbodyTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const float Photometry::SOLAR_TEMPERATURE = 5772.0f;
+
+namespace {
+
+// Integration step over a filter curve, nanometers
+const double WAVELENGTH_STEP = 1.0;
+
+// Same range and spacing as the blackbody colors
+const float INVERSE_MIN = 1.0f / BlackbodyTable::MIN_TEMPERATURE;
+const float INVERSE_MAX = 1.0f / BlackbodyTable::MAX_TEMPERATURE;
+
+// Parsecs (about half a solar radius); keeps a viewer at the star's
+// center from taking log10(0)
+const float MIN_DISTANCE = 1e-8f;
+
+// Blackbody flux through the filter, per unit area and up to a constant
+double bandFlux(const PhotometricFilter& filter, double temperature)
+{
+    double flux = 0.0;
+    size_t segment = 0;
+    double last = filter.wavelength.back();
+    for (double wavelength = filter.wavelength.front(); wavelength <= last;
+         wavelength += WAVELENGTH_STEP) {
+        while (segment + 2 < filter.wavelength.size() && filter.wavelength[segment + 1] < wavelength)
+            ++segment;
+        double w0 = filter.wavelength[segment], w1 = filter.wavelength[segment + 1];
+        double t = std::min(std::max((wavelength - w0) / (w1 - w0), 0.0), 1.0);
+        double response = filter.response[segment] + (filter.response[segment + 1] - filter.response[segment]) * t;
+        flux += response * BlackbodyTable::planck(wavelength, temperature);
+    }
+    return flux * WAVELENGTH_STEP;
+}
+
+} // namespace
+
+bool PhotometricFilter::load(const std::string& path, PhotometricFilter& filter)
+{
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not open filter " << path << std::endl;
+        return false;
+    }
+
+    filter = PhotometricFilter();
+    bool hasZeroPoint = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line.compare(0, 11, "wavelength_") == 0)
+            continue;
+        if (line[0] == '#') {
+            std::stringstream stream(line.substr(1));
+            std::string key;
+            stream >> key;
+            if (key == "name")
+                stream >> filter.name;
+            else if (key == "solar_absolute_magnitude")
+                hasZeroPoint = static_cast<bool>(stream >> filter.solarAbsoluteMagnitude);
+            continue;
+        }
+
+        const char* start = line.c_str();
+        char* end = nullptr;
+        double wavelength = std::strtod(start, &end);
+        bool valid = end != start && *end == ',';
+        double response = valid ? std::strtod(end + 1, &end) : 0.0;
+        if (!valid || (!filter.wavelength.empty() && wavelength <= filter.wavelength.back())) {
+            std::cerr << "Error: Bad filter row at line " << lineNumber << " in " << path << std::endl;
+            return false;
+        }
+        filter.wavelength.push_back(wavelength);
+        filter.response.push_back(std::max(response, 0.0));
+    }
+
+    if (filter.name.empty() || !hasZeroPoint || filter.wavelength.size() < 2) {
+        std::cerr << "Error: Filter " << path
+                  << " needs a name, a solar_absolute_magnitude and two rows" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Photometry::addFilter(const PhotometricFilter& filter)
+{
+    if (filter.wavelength.size() < 2 || filter.wavelength.size() != filter.response.size())
+        return false;
+
+    double solarFlux = bandFlux(filter, SOLAR_TEMPERATURE);
+    if (solarFlux <= 0.0)
+        return false;
+
+    Band band;
+    band.name = filter.name;
+    band.solarAbsoluteMagnitude = filter.solarAbsoluteMagnitude;
+    band.magnitudeOffset.resize(TABLE_SIZE);
+    for (int entry = 0; entry < TABLE_SIZE; ++entry) {
+        double temperature = 1.0 / (INVERSE_MIN + (INVERSE_MAX - INVERSE_MIN) * entry / (TABLE_SIZE - 1));
+        // Floored so a band far in the Wien tail of a cool star stays finite
+        double flux = std::max(bandFlux(filter, temperature) / solarFlux, 1e-30);
+        band.magnitudeOffset[entry] = static_cast<float>(-2.5 * std::log10(flux));
+    }
+
+    bands.push_back(band);
+    return true;
+}
+
+bool Photometry::loadFilter(const std::string& path)
+{
+    PhotometricFilter filter;
+    return PhotometricFilter::load(path, filter) && addFilter(filter);
+}
+
+int Photometry::getFilterCount() const
+{
+    return static_cast<int>(bands.size());
+}
+
+const std::string& Photometry::getFilterName(int filter) const
+{
+    return bands[filter].name;
+}
+
+int Photometry::findFilter(const std::string& name) const
+{
+    for (size_t i = 0; i < bands.size(); ++i) {
+        if (bands[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+float Photometry::offsetAt(const Band& band, float temperature) const
+{
+    float position;
+    float offset;
+    tablePositions(1, &temperature, &position);
+    gatherOffsets(band, 1, &position, &offset);
+    return offset;
+}
+
+float Photometry::absoluteMagnitude(int filter, float temperature, float radius) const
+{
+    const Band& band = bands[filter];
+    return band.solarAbsoluteMagnitude + offsetAt(band, temperature) - 5.0f * std::log10(radius);
+}
+
+float Photometry::apparentMagnitude(int filter, float temperature, float radius, float distance) const
+{
+    distance = std::max(distance, MIN_DISTANCE);
+    return absoluteMagnitude(filter, temperature, radius) + 5.0f * std::log10(distance / 10.0f);
+}
+
+float Photometry::colorIndex(int filter, int reference, float temperature) const
+{
+    return bands[filter].solarAbsoluteMagnitude + offsetAt(bands[filter], temperature) -
+           bands[reference].solarAbsoluteMagnitude - offsetAt(bands[reference], temperature);
+}
+
+void Photometry::tablePositions(int count, const float* temperature, float* positions)
+{
+    const float scale = (TABLE_SIZE - 1) / (INVERSE_MAX - INVERSE_MIN);
+    const float last = TABLE_SIZE - 1.001f; // Keeps index + 1 inside the table
+    for (int i = 0; i < count; ++i) {
+        float position = (1.0f / temperature[i] - INVERSE_MIN) * scale;
+        positions[i] = std::min(std::max(position, 0.0f), last);
+    }
+}
+
+void Photometry::gatherOffsets(const Band& band, int count, const float* positions, float* out)
+{
+    const float* table = &band.magnitudeOffset[0];
+    for (int i = 0; i < count; ++i) {
+        int index = static_cast<int>(positions[i]);
+        float t = positions[i] - static_cast<float>(index);
+        out[i] = table[index] + (table[index + 1] - table[index]) * t;
+    }
+}
+
+void Photometry::evaluate(int count, const float* temperature, const float* radius,
+                          const float* distance, float* magnitudes) const
+{
+    if (count <= 0)
+        return;
+
+    // Distance modulus minus the radius term, shared by every band
+    std::vector<float> positions(count), shift(count);
+    tablePositions(count, temperature, &positions[0]);
+    for (int i = 0; i < count; ++i)
+        shift[i] = 5.0f * std::log10(std::max(distance[i], MIN_DISTANCE) / (10.0f * radius[i]));
+
+    for (size_t f = 0; f < bands.size(); ++f) {
+        float* out = magnitudes + f * count;
+        gatherOffsets(bands[f], count, &positions[0], out);
+        float zeroPoint = bands[f].solarAbsoluteMagnitude;
+        for (int i = 0; i < count; ++i)
+            out[i] += zeroPoint + shift[i];
+    }
+}
+
+void Photometry::evaluateColors(int count, const float* temperature, int reference,
+                                float* colors) const
+{
+    if (count <= 0)
+        return;
+
+    std::vector<float> positions(count), referenceOffset(count);
+    tablePositions(count, temperature, &positions[0]);
+    gatherOffsets(bands[reference], count, &positions[0], &referenceOffset[0]);
+
+    for (size_t f = 0; f < bands.size(); ++f) {
+        float* out = colors + f * count;
+        gatherOffsets(bands[f], count, &positions[0], out);
+        float zeroPoint = bands[f].solarAbsoluteMagnitude - bands[reference].solarAbsoluteMagnitude;
+        for (int i = 0; i < count; ++i)
+            out[i] += zeroPoint - referenceOffset[i];
+    }
+}
@@ -0,0 +1,154 @@
+// PlanetModel.cpp
+
+#include "PlanetModel.h"
+#include "Orbit.h"
+#include "TraceProfiler.h"
+#include <cmath>
+
+// Constructor
+PlanetModel::PlanetModel(
+    float mass,
+    float radius,
+    float temperature,
+    float eccentricity,
+    float orbitalDistance,
+    float orbitalPeriod,
+    float semiMajorAxis,
+    const std::string& planetType,
+    const glm::dvec3& orbitCenter
+) : mass(mass),
+    radius(radius),
+    temperature(temperature),
+    eccentricity(eccentricity),
+    orbitalDistance(orbitalDistance),
+    orbitalPeriod(orbitalPeriod),
+    semiMajorAxis(semiMajorAxis),
+    planetType(planetType),
+    orbitCenter(orbitCenter),
+    currentTime(0.0f),
+    orbitRevision(0),
+    maxOrbitPoints(360),
+    pool(nullptr)
+{
+    // Initialize position
+    position = calculateOrbitalPosition(currentTime);
+
+    // Generate the initial orbit path
+    generateOrbitPath(static_cast<int>(maxOrbitPoints));
+}
+
+// Generate the orbit path (precompute positions)
+void PlanetModel::generateOrbitPath(int segments)
+{
+    TRACE_ZONE("PlanetModel::generateOrbitPath");
+    KeplerOrbit(orbitalDistance, eccentricity, orbitalPeriod)
+        .samplePath(segments, orbitPositions, pool);
+
+    // Recompute the orbit bounds
+    orbitBounds = BoundingBox(orbitPositions[0], orbitPositions[0]);
+    for (size_t i = 1; i < orbitPositions.size(); ++i)
+        orbitBounds.expand(BoundingBox(orbitPositions[i], orbitPositions[i]));
+
+    ++orbitRevision; // The batch re-uploads the path
+}
+
+void PlanetModel::setOrbitSegments(int segments)
+{
+    if (static_cast<size_t>(segments) == maxOrbitPoints)
+        return;
+    maxOrbitPoints = static_cast<size_t>(segments);
+    generateOrbitPath(segments);
+}
+
+void PlanetModel::setThreadPool(ThreadPool* pool)
+{
+    this->pool = pool;
+}
+
+// Update the planet's position
+void PlanetModel::update(float deltaTime)
+{
+    // Update current time
+    currentTime += deltaTime;
+
+    // Keep currentTime within [0, orbitalPeriod]
+    if (currentTime > orbitalPeriod)
+        currentTime = fmod(currentTime, orbitalPeriod);
+
+    // Calculate orbital position
+    position = calculateOrbitalPosition(currentTime);
+}
+
+// Setters and Getters
+void PlanetModel::setMass(float mass) { this->mass = mass; }
+float PlanetModel::getMass() const { return mass; }
+
+void PlanetModel::setRadius(float radius) { this->radius = radius; }
+float PlanetModel::getRadius() const { return radius; }
+
+void PlanetModel::setTemperature(float temperature) { this->temperature = temperature; }
+float PlanetModel::getTemperature() const { return temperature; }
+
+void PlanetModel::setEccentricity(float eccentricity) {
+    this->eccentricity = eccentricity;
+    generateOrbitPath(static_cast<int>(maxOrbitPoints)); // Regenerate orbit path
+}
+float PlanetModel::getEccentricity() const { return eccentricity; }
+
+void PlanetModel::setOrbitalDistance(float distance) {
+    this->orbitalDistance = distance;
+    generateOrbitPath(static_cast<int>(maxOrbitPoints)); // Regenerate orbit path
+}
+float PlanetModel::getOrbitalDistance() const { return orbitalDistance; }
+
+void PlanetModel::setOrbitalPeriod(float period) {
+    this->orbitalPeriod = period;
+    generateOrbitPath(static_cast<int>(maxOrbitPoints)); // Regenerate orbit path
+}
+float PlanetModel::getOrbitalPeriod() const { return orbitalPeriod; }
+
+void PlanetModel::setSemiMajorAxis(float sma) {
+    this->semiMajorAxis = sma;
+}
+float PlanetModel::getSemiMajorAxis() const {
+    return semiMajorAxis;
+}
+void PlanetModel::setPlanetType(const std::string& type) { this->planetType = type; }
+std::string PlanetModel::getPlanetType() const { return planetType; }
+
+// Getter for current position
+glm::dvec3 PlanetModel::getPosition() const {
+    return position;
+}
+
+glm::dvec3 PlanetModel::getOrbitCenter() const {
+    return orbitCenter;
+}
+
+BoundingBox PlanetModel::getOrbitBounds() const {
+    return orbitBounds;
+}
+
+const std::vector<glm::vec3>& PlanetModel::getOrbitPath() const {
+    return orbitPositions;
+}
+
+unsigned int PlanetModel::getOrbitRevision() const {
+    return orbitRevision;
+}
+
+float PlanetModel::getOrbitPhase() const {
+    return orbitalPeriod > 0.0f ? currentTime / orbitalPeriod : 0.0f;
+}
+
+// Utility function to calculate orbital position
+glm::dvec3 PlanetModel::calculateOrbitalPosition(double time) const
+{
+    return orbitCenter + calculateOrbitalOffset(time);
+}
+
+// Position relative to the orbit center, solved in double precision
+glm::dvec3 PlanetModel::calculateOrbitalOffset(double time) const
+{
+    return KeplerOrbit(orbitalDistance, eccentricity, orbitalPeriod).getOffset(time);
+}
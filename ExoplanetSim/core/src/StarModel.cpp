@@ -0,0 +1,118 @@
+// StarModel.cpp
+
+#include "StarModel.h"
+#include "BlackbodyTable.h"
+
+StarModel::StarModel(
+    float mass,
+    float radius,
+    float effectiveTemperature,
+    float luminosity,
+    float surfaceGravity,
+    float metallicity,
+    const glm::dvec3& position,
+    const glm::vec3& velocity,
+    const std::string& chemicalComposition
+)
+    : mass(mass),
+      radius(radius),
+      effectiveTemperature(effectiveTemperature),
+      luminosity(luminosity),
+      surfaceGravity(surfaceGravity),
+      metallicity(metallicity),
+      chemicalComposition(chemicalComposition),
+      position(position),
+      velocity(velocity)
+{
+}
+
+void StarModel::update(float deltaTime) {
+    // Update position based on velocity
+    position += glm::dvec3(velocity) * static_cast<double>(deltaTime);
+}
+
+// Color of a blackbody at the temperature, from the shared table
+glm::vec3 StarModel::temperatureToColor(float temperature) {
+    return BlackbodyTable::get().lookup(temperature);
+}
+
+// Setters and Getters
+void StarModel::setMass(float newMass) {
+    mass = newMass;
+}
+
+float StarModel::getMass() const {
+    return mass;
+}
+
+void StarModel::setRadius(float newRadius) {
+    radius = newRadius;
+}
+
+float StarModel::getRadius() const {
+    return radius;
+}
+
+void StarModel::setEffectiveTemperature(float temperature) {
+    effectiveTemperature = temperature;
+}
+
+float StarModel::getEffectiveTemperature() const {
+    return effectiveTemperature;
+}
+
+void StarModel::setLuminosity(float newLuminosity) {
+    luminosity = newLuminosity;
+}
+
+float StarModel::getLuminosity() const {
+    return luminosity;
+}
+
+void StarModel::setSurfaceGravity(float gravity) {
+    surfaceGravity = gravity;
+}
+
+float StarModel::getSurfaceGravity() const {
+    return surfaceGravity;
+}
+
+void StarModel::setMetallicity(float newMetallicity) {
+    metallicity = newMetallicity;
+}
+
+float StarModel::getMetallicity() const {
+    return metallicity;
+}
+
+void StarModel::setPosition(const glm::dvec3& newPosition) {
+    position = newPosition;
+}
+
+glm::dvec3 StarModel::getPosition() const {
+    return position;
+}
+
+void StarModel::setVelocity(const glm::vec3& newVelocity) {
+    velocity = newVelocity;
+}
+
+glm::vec3 StarModel::getVelocity() const {
+    return velocity;
+}
+
+void StarModel::setChemicalComposition(const std::string& composition) {
+    chemicalComposition = composition;
+}
+
+std::string StarModel::getChemicalComposition() const {
+    return chemicalComposition;
+}
+
+glm::vec3 StarModel::getColor() const {
+    return temperatureToColor(effectiveTemperature);
+}
+
+HabitableZoneLimits StarModel::getHabitableZone() const {
+    return HabitableZoneLimits::fromLuminosity(luminosity);
+}
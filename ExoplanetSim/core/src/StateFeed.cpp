@@ -0,0 +1,216 @@
+// StateFeed.cpp
+
+#include "StateFeed.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The readers depend on these sizes and on plain, lock-free atomics
+static_assert(sizeof(StateFeedBody) == 72, "StateFeedBody layout changed");
+static_assert(sizeof(StateFeedFrame) == 32 + STATE_FEED_MAX_BODIES * 72, "StateFeedFrame layout changed");
+static_assert(sizeof(StateFeedHeader) == 64, "StateFeedHeader layout changed");
+static_assert(offsetof(StateFeedHeader, published) == 32, "StateFeedHeader layout changed");
+static_assert(offsetof(StateFeedSlot, frame) == 8, "StateFeedSlot layout changed");
+static_assert(sizeof(std::atomic<uint64_t>) == 8 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared-memory atomics must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == 4 && ATOMIC_INT_LOCK_FREE == 2,
+              "shared-memory atomics must be lock-free");
+
+namespace {
+const char MAGIC[8] = { 'E', 'X', 'O', 'F', 'E', 'E', 'D', '\0' };
+
+// Attempts before a reader gives up on a slot the writer keeps refilling
+const int READ_ATTEMPTS = 16;
+} // namespace
+
+StateFeed::StateFeed()
+    : writer(false), mapping(nullptr), mappingSize(0), header(nullptr), slots(nullptr)
+{
+}
+
+StateFeed::~StateFeed()
+{
+    close();
+}
+
+bool StateFeed::create(const std::string& feedName, uint32_t slotCount)
+{
+    close();
+    if (slotCount == 0) {
+        std::cerr << "Error: State feed needs at least one slot." << std::endl;
+        return false;
+    }
+
+    // A crashed writer leaves its object behind; start from a fresh one
+    // so readers never see a half-initialized header of another layout
+    shm_unlink(feedName.c_str());
+    int fd = shm_open(feedName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not create state feed " << feedName << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    size_t size = sizeof(StateFeedHeader) + slotCount * sizeof(StateFeedSlot);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0 || !map(fd, size, true)) {
+        std::cerr << "Error: Could not size state feed " << feedName << ": "
+                  << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(feedName.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    // The object is zero-filled, so every slot starts at sequence 0
+    header->version = STATE_FEED_VERSION;
+    header->headerSize = sizeof(StateFeedHeader);
+    header->slotSize = sizeof(StateFeedSlot);
+    header->slotCount = slotCount;
+    header->maxBodies = STATE_FEED_MAX_BODIES;
+    header->writerPid = static_cast<uint32_t>(getpid());
+    header->published.store(0, std::memory_order_relaxed);
+
+    // Readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+
+    name = feedName;
+    writer = true;
+    return true;
+}
+
+bool StateFeed::open(const std::string& feedName)
+{
+    close();
+
+    int fd = shm_open(feedName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open state feed " << feedName << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    bool mapped = fstat(fd, &info) == 0 &&
+                  static_cast<size_t>(info.st_size) >= sizeof(StateFeedHeader) &&
+                  map(fd, static_cast<size_t>(info.st_size), false);
+    ::close(fd);
+    if (!mapped) {
+        std::cerr << "Error: Could not map state feed " << feedName << std::endl;
+        close();
+        return false;
+    }
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header->version != STATE_FEED_VERSION ||
+        header->headerSize != sizeof(StateFeedHeader) ||
+        header->slotSize != sizeof(StateFeedSlot) ||
+        header->maxBodies != STATE_FEED_MAX_BODIES ||
+        header->slotCount == 0 ||
+        mappingSize < sizeof(StateFeedHeader) + header->slotCount * sizeof(StateFeedSlot)) {
+        std::cerr << "Error: " << feedName << " is not a version " << STATE_FEED_VERSION
+                  << " state feed" << std::endl;
+        close();
+        return false;
+    }
+
+    name = feedName;
+    return true;
+}
+
+bool StateFeed::map(int fd, size_t size, bool writable)
+{
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+        return false;
+
+    mapping = address;
+    mappingSize = size;
+    header = static_cast<StateFeedHeader*>(address);
+    slots = reinterpret_cast<StateFeedSlot*>(static_cast<char*>(address) + sizeof(StateFeedHeader));
+    return true;
+}
+
+void StateFeed::close()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+    // Readers keep their mapping; the name goes away with the writer
+    if (writer)
+        shm_unlink(name.c_str());
+
+    name.clear();
+    writer = false;
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    slots = nullptr;
+}
+
+bool StateFeed::isOpen() const
+{
+    return mapping != nullptr;
+}
+
+const std::string& StateFeed::getName() const
+{
+    return name;
+}
+
+void StateFeed::publish(const StateFeedFrame& frame)
+{
+    if (!writer)
+        return;
+
+    uint64_t published = header->published.load(std::memory_order_relaxed);
+    StateFeedSlot& slot = slots[published % header->slotCount];
+
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&slot.frame, &frame, sizeof(StateFeedFrame));
+    slot.frame.frame = published;
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(published + 1, std::memory_order_release);
+}
+
+bool StateFeed::readLatest(StateFeedFrame& frame) const
+{
+    if (!mapping)
+        return false;
+
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        uint64_t published = header->published.load(std::memory_order_acquire);
+        if (published == 0)
+            return false;
+
+        const StateFeedSlot& slot = slots[(published - 1) % header->slotCount];
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1u)
+            continue;
+
+        std::memcpy(&frame, &slot.frame, sizeof(StateFeedFrame));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            if (frame.bodyCount > STATE_FEED_MAX_BODIES)
+                frame.bodyCount = STATE_FEED_MAX_BODIES;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t StateFeed::getPublishedCount() const
+{
+    return header ? header->published.load(std::memory_order_acquire) : 0;
+}
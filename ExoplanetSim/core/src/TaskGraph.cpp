@@ -0,0 +1,112 @@
+// TaskGraph.cpp
+
+#include "TaskGraph.h"
+
+TaskGraph::TaskGraph()
+    : hasCallerTasks(false)
+{
+}
+
+int TaskGraph::add(std::function<void()> task)
+{
+    nodes.push_back(std::unique_ptr<Node>(new Node()));
+    nodes.back()->task = std::move(task);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+int TaskGraph::addOnCaller(std::function<void()> task)
+{
+    int node = add(std::move(task));
+    nodes[node]->onCaller = true;
+    hasCallerTasks = true;
+    return node;
+}
+
+void TaskGraph::precede(int before, int after)
+{
+    nodes[before]->successors.push_back(after);
+    ++nodes[after]->dependencies;
+}
+
+void TaskGraph::run(ThreadPool& pool)
+{
+    if (nodes.empty())
+        return;
+
+    std::shared_ptr<Run> state = std::make_shared<Run>(static_cast<int>(nodes.size()));
+    for (size_t i = 0; i < nodes.size(); ++i)
+        nodes[i]->remaining = nodes[i]->dependencies;
+
+    // Roots first; the rest are released by their last dependency
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i]->dependencies == 0)
+            submit(pool, static_cast<int>(i), state);
+    }
+
+    if (!hasCallerTasks) {
+        pool.wait(state->finished);
+        return;
+    }
+
+    // Run caller tasks as they are released until everything has finished
+    for (;;) {
+        int node;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->wake.wait(lock, [&state] {
+                return !state->callerReady.empty() || state->finished.isDone();
+            });
+            if (state->callerReady.empty())
+                return;
+            node = state->callerReady.front();
+            state->callerReady.pop_front();
+        }
+        execute(pool, node, state);
+    }
+}
+
+void TaskGraph::clear()
+{
+    nodes.clear();
+    hasCallerTasks = false;
+}
+
+size_t TaskGraph::size() const
+{
+    return nodes.size();
+}
+
+void TaskGraph::submit(ThreadPool& pool, int node, const std::shared_ptr<Run>& state)
+{
+    if (nodes[node]->onCaller) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->callerReady.push_back(node);
+        }
+        state->wake.notify_one();
+        return;
+    }
+
+    ThreadPool* workers = &pool;
+    pool.enqueue([this, workers, node, state] { execute(*workers, node, state); });
+}
+
+void TaskGraph::execute(ThreadPool& pool, int node, const std::shared_ptr<Run>& state)
+{
+    Node& current = *nodes[node];
+    current.task();
+    for (size_t i = 0; i < current.successors.size(); ++i) {
+        int successor = current.successors[i];
+        if (--nodes[successor]->remaining == 0)
+            submit(pool, successor, state);
+    }
+
+    // Last: run() may return and the graph go away right after, so only
+    // the shared state is touched from here on
+    bool wakeCaller = hasCallerTasks;
+    state->finished.done();
+    if (wakeCaller) {
+        { std::lock_guard<std::mutex> lock(state->mutex); }
+        state->wake.notify_one();
+    }
+}
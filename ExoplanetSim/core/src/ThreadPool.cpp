@@ -0,0 +1,246 @@
+// ThreadPool.cpp
+
+#include "ThreadPool.h"
+#include "TraceProfiler.h"
+
+#include <algorithm>
+
+namespace {
+// Identifies the worker the current thread belongs to
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+} // namespace
+
+TaskCounter::TaskCounter(int count)
+    : remaining(count)
+{
+}
+
+void TaskCounter::add(int count)
+{
+    remaining += count;
+}
+
+void TaskCounter::done()
+{
+    if (remaining.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        zero.notify_all();
+    }
+}
+
+bool TaskCounter::isDone() const
+{
+    return remaining.load() <= 0;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : pending(0), queued(0), nextQueue(0), steals(0), externalThreadsHelp(true),
+      stopping(false)
+{
+    if (threadCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        threadCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    // All deques exist before any worker can steal from them
+    for (unsigned int i = 0; i < threadCount; ++i)
+        queues.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (unsigned int i = 0; i < threadCount; ++i)
+        threads.push_back(std::thread(&ThreadPool::workerLoop, this, static_cast<int>(i)));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    // Workers push to their own deque; other threads spread tasks out
+    int worker = getWorkerIndex();
+    size_t target = worker >= 0 ? static_cast<size_t>(worker) : nextQueue++ % queues.size();
+
+    // Counted before it becomes visible, so the counts never drop below
+    // the real number of tasks
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+size_t ThreadPool::getPendingCount() const
+{
+    return pending.load();
+}
+
+void ThreadPool::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+}
+
+void ThreadPool::wait(TaskCounter& counter)
+{
+    int worker = getWorkerIndex();
+    if (worker >= 0) {
+        // Keep this worker busy instead of blocking it
+        while (!counter.isDone()) {
+            if (!runOne(worker))
+                std::this_thread::yield();
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(counter.mutex);
+    counter.zero.wait(lock, [&counter] { return counter.isDone(); });
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body, int grainSize)
+{
+    if (count <= 0)
+        return;
+    grainSize = std::max(grainSize, 1);
+
+    // Chunks are claimed from a shared index by the caller and by helper
+    // tasks. The state is shared so a helper that only starts after the
+    // loop has finished finds no chunk left and exits without touching
+    // the caller's body.
+    struct Loop {
+        std::atomic<int> next;
+        TaskCounter finished;
+        const std::function<void(int)>* body;
+        int count, grainSize, chunkCount;
+
+        Loop() : next(0) {}
+
+        void run() {
+            for (;;) {
+                int chunk = next++;
+                if (chunk >= chunkCount)
+                    return;
+                int end = std::min(count, (chunk + 1) * grainSize);
+                for (int i = chunk * grainSize; i < end; ++i)
+                    (*body)(i);
+                finished.done();
+            }
+        }
+    };
+
+    std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+    loop->body = &body;
+    loop->count = count;
+    loop->grainSize = grainSize;
+    loop->chunkCount = (count + grainSize - 1) / grainSize;
+    loop->finished.add(loop->chunkCount);
+
+    bool callerHelps = getWorkerIndex() >= 0 || externalThreadsHelp.load();
+    int helpers = std::min(loop->chunkCount - (callerHelps ? 1 : 0),
+                           static_cast<int>(getThreadCount()));
+    for (int i = 0; i < helpers; ++i)
+        enqueue([loop] { loop->run(); });
+
+    if (callerHelps)
+        loop->run();
+    wait(loop->finished);
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(threads.size());
+}
+
+int ThreadPool::getWorkerIndex() const
+{
+    return currentPool == this ? currentWorker : -1;
+}
+
+size_t ThreadPool::getStealCount() const
+{
+    return steals.load();
+}
+
+void ThreadPool::setExternalThreadsHelp(bool help)
+{
+    externalThreadsHelp = help;
+}
+
+bool ThreadPool::takeTask(int worker, std::function<void()>& task)
+{
+    // Newest first from our own deque
+    {
+        Worker& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+
+    // Oldest first from the others
+    size_t count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *queues[(worker + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            ++steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne(int worker)
+{
+    std::function<void()> task;
+    if (!takeTask(worker, task))
+        return false;
+
+    task();
+    finishTask();
+    return true;
+}
+
+void ThreadPool::finishTask()
+{
+    if (--pending == 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        idle.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    TraceProfiler::setThreadName("Worker " + std::to_string(index));
+
+    for (;;) {
+        if (runOne(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        taskAvailable.wait(lock, [this] { return stopping || queued.load() > 0; });
+        // Drain the deques before exiting
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
@@ -0,0 +1,186 @@
+// TraceProfiler.cpp
+
+#include "TraceProfiler.h"
+
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+// Single writer (the owning thread), any number of readers. The slots are
+// atomics so a reader racing the writer sees torn zones at worst, which
+// the head check below throws away.
+struct Zone {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> end;
+};
+
+struct ThreadRing {
+    std::atomic<uint64_t> head; // Zones written so far
+    Zone zones[TraceProfiler::RING_SIZE];
+    std::string name;           // Guarded by the registry mutex
+    int id;
+
+    ThreadRing() : head(0), id(0) {}
+};
+
+// Rings outlive their threads so a trace still shows finished workers
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadRing> > rings;
+    std::chrono::steady_clock::time_point epoch;
+
+    Registry() : epoch(std::chrono::steady_clock::now()) {}
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+thread_local ThreadRing* currentRing = nullptr;
+
+ThreadRing& getThreadRing()
+{
+    if (currentRing == nullptr) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.rings.push_back(std::unique_ptr<ThreadRing>(new ThreadRing()));
+        currentRing = registry.rings.back().get();
+        currentRing->id = static_cast<int>(registry.rings.size());
+    }
+    return *currentRing;
+}
+
+// Zone names are identifiers and literals; escape anyway
+void writeJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) >= 0x20)
+            out << *c;
+    }
+    out << '"';
+}
+} // namespace
+
+std::atomic<bool> TraceProfiler::enabled(true);
+
+void TraceProfiler::setEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void TraceProfiler::setThreadName(const std::string& name)
+{
+    ThreadRing& ring = getThreadRing();
+    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+    ring.name = name;
+}
+
+uint64_t TraceProfiler::now()
+{
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - getRegistry().epoch;
+    return static_cast<uint64_t>(elapsed.count());
+}
+
+void TraceProfiler::record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadRing& ring = getThreadRing();
+    uint64_t index = ring.head.load(std::memory_order_relaxed);
+    Zone& zone = ring.zones[index % RING_SIZE];
+    // Orders the slot's stores after the head that a reader rechecks
+    std::atomic_thread_fence(std::memory_order_release);
+    zone.name.store(name, std::memory_order_relaxed);
+    zone.start.store(start, std::memory_order_relaxed);
+    zone.end.store(end, std::memory_order_relaxed);
+    ring.head.store(index + 1, std::memory_order_release); // Publishes the slot
+}
+
+bool TraceProfiler::exportChromeTrace(const std::string& path)
+{
+    std::ofstream file(path.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not write trace to " << path << std::endl;
+        return false;
+    }
+
+    struct Copy {
+        const char* name;
+        uint64_t start, end;
+    };
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t written = 0;
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t r = 0; r < registry.rings.size(); ++r) {
+        ThreadRing& ring = *registry.rings[r];
+
+        // Copy the newest zones, then drop any the writer may have
+        // overwritten meanwhile. Slot newHead % RING_SIZE may be half
+        // written, so only indices from newHead + 1 - RING_SIZE are whole.
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t begin = head > RING_SIZE ? head - RING_SIZE : 0;
+        std::vector<Copy> zones;
+        zones.reserve(static_cast<size_t>(head - begin));
+        for (uint64_t i = begin; i < head; ++i) {
+            const Zone& zone = ring.zones[i % RING_SIZE];
+            Copy copy = { zone.name.load(std::memory_order_relaxed),
+                          zone.start.load(std::memory_order_relaxed),
+                          zone.end.load(std::memory_order_relaxed) };
+            zones.push_back(copy);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t newHead = ring.head.load(std::memory_order_relaxed);
+        uint64_t valid = newHead + 1 > RING_SIZE ? newHead + 1 - RING_SIZE : 0;
+        size_t skip = 0;
+        if (valid > begin)
+            skip = static_cast<size_t>(std::min<uint64_t>(valid - begin, zones.size()));
+
+        if (!first)
+            file << ",\n";
+        first = false;
+        file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring.id
+             << ",\"args\":{\"name\":";
+        writeJsonString(file, ring.name.empty() ? "Thread" : ring.name.c_str());
+        file << "}}";
+
+        // Complete events; timestamps in microseconds with ns precision
+        for (size_t i = skip; i < zones.size(); ++i) {
+            const Copy& zone = zones[i];
+            file << ",\n{\"ph\":\"X\",\"name\":";
+            writeJsonString(file, zone.name);
+            file << ",\"pid\":1,\"tid\":" << ring.id
+                 << ",\"ts\":" << zone.start / 1000 << '.' << std::setfill('0') << std::setw(3)
+                 << zone.start % 1000 << ",\"dur\":" << (zone.end - zone.start) / 1000 << '.'
+                 << std::setw(3) << (zone.end - zone.start) % 1000 << std::setfill(' ') << '}';
+            ++written;
+        }
+    }
+    file << "\n]}\n";
+
+    std::cout << "Trace with " << written << " zones written to " << path << std::endl;
+    return true;
+}
+
+uint64_t TraceProfiler::getZoneCount()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint64_t total = 0;
+    for (size_t r = 0; r < registry.rings.size(); ++r)
+        total += registry.rings[r]->head.load(std::memory_order_relaxed);
+    return total;
+}
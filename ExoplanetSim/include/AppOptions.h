@@ -0,0 +1,55 @@
+// AppOptions.h
+
+#ifndef APPOPTIONS_H
+#define APPOPTIONS_H
+
+#include <string>
+
+// Command-line options
+struct AppOptions {
+    bool headless;         // Render offscreen without a window (EGL)
+    int width;             // Window or offscreen framebuffer size
+    int height;
+    int frames;            // Frames to render before exiting, 0 = until closed
+    std::string timingLog; // Pass timings CSV written on exit
+    bool skybox;           // Cubemap background instead of the starfield
+    bool renderOnlyMain;   // Main thread never runs jobs itself
+
+    // Frame pacing
+    double targetFrameTime; // Quality governor target in ms, 0 = full quality
+    double fpsCap;          // 0 = uncapped
+    bool vsync;
+    bool idle;              // Stop rendering while nothing visible changes
+
+    // Image-sequence capture
+    std::string captureDirectory; // Capture from the first frame if set
+    std::string captureFormat;    // "png" or "raw"
+    int captureWidth;             // 0 = framebuffer size
+    int captureHeight;
+    int captureFps;               // Simulation steps per captured second
+
+    // Session recording and replay benchmarks
+    std::string recordPath;  // Write camera input and parameter edits here
+    std::string replayPath;  // Play a recorded session back at a fixed step
+    std::string reportPath;  // Frame times of the replay (default: <replay>.report.csv)
+
+    // CPU trace zones
+    std::string tracePath;   // Chrome trace written on exit
+    bool trace;              // Record zones at all
+
+    // Shared-memory name of the live state feed, empty for none
+    std::string stateFeed;
+
+    AppOptions()
+        : headless(false), width(1280), height(720), frames(0), skybox(false),
+          renderOnlyMain(false), targetFrameTime(0.0), fpsCap(0.0), vsync(true),
+          idle(true), captureFormat("png"), captureWidth(0), captureHeight(0), captureFps(60),
+          trace(true) {}
+
+    // Parses argv; prints usage and returns false on --help or bad input
+    static bool parse(int argc, char** argv, AppOptions& options);
+
+    static void printUsage(const char* program);
+};
+
+#endif // APPOPTIONS_H
@@ -8,24 +8,40 @@
 
 #include "Camera.h"
 #include "Skybox.h"
+#include "Starfield.h"
+#include "BlackbodyTexture.h"
 #include "Star.h"
 #include "Planet.h"
+#include "Moon.h"
+#include "OrbitBatch.h"
 #include "Shader.h"
 #include "HabitableZone.h" // Include HabitableZone
+#include "DepthMode.h"
+#include "FrameProfiler.h"
+#include "QualityGovernor.h"
+#include "AppOptions.h"
+#include "HeadlessContext.h"
+#include "ThreadPool.h"
+#include "FrameCapture.h"
+#include "SessionLog.h"
+#include "StateFeed.h"
+#include "PlanetTextureGenerator.h"
+#include "TextureLoader.h"
 
 // ImGui includes
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 
-// Include stb_image
-#include "stb_image.h"
-
+#include <chrono>
 #include <cstdint> // For uintptr_t
+#include <vector>
+
+class Renderer; // Forward declaration
 
 class Application {
 public:
-    Application();
+    explicit Application(const AppOptions& options = AppOptions());
     ~Application();
 
     bool initialize();
@@ -36,10 +52,6 @@ public:
     Camera camera;
     float deltaTime;
 
-    // Screen settings
-    const unsigned int SCR_WIDTH = 1280;
-    const unsigned int SCR_HEIGHT = 720;
-
     // Input handling variables
     float lastX;
     float lastY;
@@ -49,42 +61,183 @@ public:
     // State variable for the separate window
     bool showSeparateWindow;
 
+    // Debug overlay with renderer statistics (toggled with F3)
+    bool showDebugOverlay;
+
+    // Simulation time stands still (toggled with P); the camera still moves
+    bool paused;
+
+    // Draw the next few frames even if nothing seems to change; input
+    // events call this so ImGui can settle after them
+    void requestRedraw(int frames = REDRAW_FRAMES);
+    static const int REDRAW_FRAMES = 3;
+
+    bool isHeadless() const { return options.headless; }
+    bool isReplaying() const { return session.isReplaying(); }
+
+    // Size of the window framebuffer, or of the offscreen target when headless
+    void getFramebufferSize(int& width, int& height) const;
+
+    const FrameProfiler& getProfiler() const { return profiler; }
+
+    // Seconds from initialize() to the end of the first frame, -1 before
+    double getTimeToFirstFrame() const { return firstFrameTime; }
+
 private:
+    // Every user edit of the simulation, as recorded in session logs.
+    // Values are stored in the log: append new entries only.
+    enum Parameter {
+        PARAM_STAR_MASS = 0,
+        PARAM_STAR_RADIUS,
+        PARAM_STAR_TEMPERATURE,
+        PARAM_STAR_LUMINOSITY,
+        PARAM_PLANET_MASS,
+        PARAM_PLANET_RADIUS,
+        PARAM_ECCENTRICITY,
+        PARAM_ORBITAL_DISTANCE,
+        PARAM_ORBITAL_PERIOD,
+        PARAM_PLANET_TYPE,       // Index into the type list
+        PARAM_PLANET_TEMPERATURE,
+        PARAM_SURFACE_SEED,
+        PARAM_REGENERATE_SURFACE,
+        PARAM_MOON_COUNT,
+        PARAM_STRESS_ORBITS,
+        PARAM_PAUSED,
+        PARAM_SKYBOX,
+        PARAM_STAR_BRIGHTNESS,
+        PARAM_MILKY_WAY,
+        PARAM_CAMERA_VIEW        // 0 planet, 1 star, 2 system
+    };
+
+    AppOptions options;
+
+    // Offscreen EGL context (headless mode only)
+    HeadlessContext headlessContext;
+
     // Timing variables
     float lastFrame;
+    std::chrono::steady_clock::time_point startTime;
+    int frameCount;
+    double firstFrameTime; // Time to first interactive frame
+
+    // Seconds since startup (works with and without GLFW)
+    double getTime() const;
 
     // Objects
-    Skybox* skybox;
+    Skybox* skybox;       // Created the first time the cubemap is chosen
+    Starfield* starfield;
+    BlackbodyTexture* blackbody; // Star colors by temperature
+    Photometry photometry;       // Synthetic magnitudes (filters in data/filters)
+    bool skyboxEnabled;   // Background: cubemap instead of the starfield
     Star* star;
     Planet* planet;
     HabitableZone* habitableZone; // Add HabitableZone
+    std::vector<Moon*> moons;     // Around the planet; they eclipse it and each other
+    static const int MAX_MOONS = 4; // Within the renderer's occluder limit
+
+    // Every orbit line, drawn in one call
+    OrbitBatch* orbits;
+    int planetOrbit;
+    unsigned int planetOrbitRevision; // Path revision last uploaded
+    std::vector<int> stressOrbits;    // Synthetic orbits for load testing
 
     // Shaders
     Shader* starShader;
     Shader* planetShader;
     Shader* skyboxShader;
+    Shader* starfieldShader;
+    Shader* milkyWayShader;
     Shader* orbitShader;
     Shader* habitableZoneShader; // Shader for HabitableZone
 
+    // Depth pipeline (reverse-Z or logarithmic fallback)
+    DepthMode depthMode;
+
+    // CPU/GPU pass timings
+    FrameProfiler profiler;
+
+    // Frame pacing: detail follows the target frame time, rate is capped
+    QualityGovernor governor;
+    FrameLimiter limiter;
+
+    // Idle mode: while paused and untouched the loop blocks on events
+    int redrawFrames;           // Frames still to draw regardless of changes
+    glm::dvec3 drawnCameraPosition; // Camera of the last drawn frame
+    glm::vec3 drawnCameraFront;
+    float drawnCameraZoom;
+    int idleWakeups;            // Event waits that ended without a redraw
+    bool canIdle() const;
+    void waitWhileIdle();
+
+    // Job system: body updates, orbit paths, image decode and encode
+    ThreadPool workers;
+
+    // Image-sequence export of the scene target
+    FrameCapture capture;
+
+    // Session recording, or the session being replayed
+    SessionLog session;
+    struct ReplaySample {
+        float recorded, cpu, gpu; // Milliseconds
+    };
+    std::vector<ReplaySample> replaySamples;
+
+    // Live state for external analysis tools (--state-feed)
+    StateFeed stateFeed;
+    double simulationTime; // Days
+    void publishState();
+
+    // Procedural planet surfaces
+    PlanetTextureGenerator* planetTextures;
+
+    // Background decode and budgeted upload of image files
+    TextureLoader* textures;
+
     // ImGui
     ImGuiIO* io;
 
     // Initialization functions
     bool initWindow();
+    bool initHeadless();
     bool initOpenGL();
-    void initObjects();
+    void initScene();
+    void compileShader(int shader, const ShaderSource& source);
+    void initHabitableZone();
+    void finishStartup();
     bool initImGui();
 
     // Main loop functions
+    void buildUI();
     void update();
+    void buildDebugOverlay(const Renderer& renderer);
+    bool shouldClose() const;
+    void startCapture();
+    void stopCapture();
+    void regeneratePlanetSurface();
+    void setSkyboxEnabled(bool enabled);
+    void setStressOrbitCount(int count);
+    void setMoonCount(int count);
+    void applyQuality();
+    void reportHeadlessRun(double seconds) const;
+
+    // User edits go through these so a recording sees them; while a
+    // session replays, its events are the only input
+    void setParameter(Parameter parameter, float value);
+    void applyParameter(Parameter parameter, float value);
+    void moveCamera(Camera::Camera_Movement direction, float deltaTime);
+    void turnCamera(float xoffset, float yoffset);
+    void zoomCamera(float yoffset);
+    void applySessionEvents(const std::vector<SessionLog::Event>& events);
+    bool writeReplayReport(const std::string& path) const;
 
     // Camera adjustment methods
     void adjustCameraPosition();    // View entire solar system
     void adjustCameraToPlanet();    // Focus on planet
     void adjustCameraToStar();      // Focus on star
 
-    // Function to load a texture from file
+    // Function to load a texture from file (streamed in the background)
     GLuint loadTexture(const char* path);
+    GLuint loadTexture(const char* ktxPath, const char* path); // .ktx if it exists
 
     // Texture IDs for images
     GLuint imageTexture1;
@@ -0,0 +1,25 @@
+// BlackbodyTexture.h
+
+#ifndef BLACKBODYTEXTURE_H
+#define BLACKBODYTEXTURE_H
+
+#include <glad/glad.h>
+
+// BlackbodyTable as a 1D texture with linear filtering. Shaders map a
+// temperature to a coordinate with blackbodyCoordinate(), which must
+// match BlackbodyTable::getCoordinate, and get the color from one fetch.
+class BlackbodyTexture {
+public:
+    BlackbodyTexture();
+    ~BlackbodyTexture();
+
+    GLuint getID() const;
+
+private:
+    GLuint textureID;
+
+    BlackbodyTexture(const BlackbodyTexture&);
+    BlackbodyTexture& operator=(const BlackbodyTexture&);
+};
+
+#endif // BLACKBODYTEXTURE_H
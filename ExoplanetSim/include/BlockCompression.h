@@ -0,0 +1,31 @@
+// BlockCompression.h
+
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <cstddef>
+
+// S3TC block codecs. BC1 stores 4x4 RGB blocks in 8 bytes (0.5 byte per
+// pixel), BC3 adds an interpolated alpha block for 16 bytes. Images are
+// RGBA8; dimensions need not be multiples of four (edge blocks repeat
+// the last row/column). CPU only, no GL dependency.
+namespace BlockCompression {
+
+enum Format {
+    BC1, // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    BC3  // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+};
+
+size_t getBlockSize(Format format);
+size_t getCompressedSize(Format format, int width, int height);
+
+void compress(Format format, const unsigned char* rgba, int width, int height,
+              unsigned char* output);
+
+// Used when the driver lacks S3TC and by the converter's error report
+void decompress(Format format, const unsigned char* blocks, int width, int height,
+                unsigned char* rgba);
+
+}
+
+#endif // BLOCKCOMPRESSION_H
@@ -28,7 +28,7 @@ public:
     };
 
     // Camera Attributes
-    glm::vec3 Position;
+    glm::dvec3 Position; // World position in double precision (floating origin)
     glm::vec3 Front;
     glm::vec3 Up;
     glm::vec3 Right;
@@ -45,15 +45,21 @@ public:
 
     // Constructor with vectors
     Camera(
-        glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f),
+        glm::dvec3 position = glm::dvec3(0.0, 0.0, 0.0),
         glm::vec3 up       = glm::vec3(0.0f, 1.0f, 0.0f),
         float yaw          = YAW,
         float pitch        = PITCH
     );
 
-    // Returns the view matrix calculated using Euler Angles and the LookAt Matrix
+    // Returns the view matrix calculated using Euler Angles and the LookAt Matrix.
+    // The camera sits at the origin: world positions must be rebased with
+    // ToCameraRelative before they are used with this matrix.
     glm::mat4 GetViewMatrix();
 
+    // Converts a double-precision world position to a float position
+    // relative to the camera, precise near the camera at any distance
+    glm::vec3 ToCameraRelative(const glm::dvec3& worldPosition) const;
+
     // Processes input received from any keyboard-like input system
     void ProcessKeyboard(Camera_Movement direction, float deltaTime);
 
@@ -64,7 +70,7 @@ public:
     void ProcessMouseScroll(float yoffset);
 
     // Sets the camera's position and front vector
-    void setPositionAndFront(const glm::vec3& position, const glm::vec3& front);
+    void setPositionAndFront(const glm::dvec3& position, const glm::vec3& front);
 
     // Updates the camera vectors based on the current Front vector
     void updateCameraVectors();
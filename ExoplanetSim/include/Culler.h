@@ -0,0 +1,98 @@
+// Culler.h
+
+#ifndef CULLER_H
+#define CULLER_H
+
+#include "BoundingVolume.h"
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Per-frame culling statistics shown in the debug overlay
+struct CullStats {
+    int systems;          // Systems submitted this frame
+    int systemsCulled;    // Systems rejected as a whole (BVH or linear test)
+    int drawn;            // Items that passed every test
+    int frustumCulled;    // Items outside the view frustum
+    int occluded;         // Bodies hidden behind their star
+    bool usedBVH;         // Whether the system BVH was used this frame
+
+    CullStats()
+        : systems(0), systemsCulled(0), drawn(0), frustumCulled(0),
+          occluded(0), usedBVH(false) {}
+};
+
+// Frame culling stage: bodies are tested as spheres, orbits as boxes and
+// habitable zones as annuli. Items are grouped into systems so that whole
+// systems can be rejected at once (through a BVH when there are many).
+class Culler {
+public:
+    Culler();
+
+    // Start a new frame
+    void beginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPos);
+
+    // Register a system; the occluder (its star) hides bodies fully behind it
+    int addSystem(const BoundingBox& bounds, const BoundingSphere& occluder);
+
+    // Register items belonging to a system; return an item handle
+    int addBody(int system, const BoundingSphere& sphere, bool occludable = true);
+    int addOrbit(int system, const BoundingBox& box);
+    int addZone(int system, const glm::vec3& center, float innerRadius, float outerRadius);
+
+    // Run the tests for every registered item
+    void cull();
+
+    bool isVisible(int item) const;
+    const CullStats& getStats() const;
+
+    // Number of systems above which the BVH is built instead of a linear scan
+    static const int BVH_THRESHOLD = 16;
+
+private:
+    enum ItemKind { ITEM_BODY, ITEM_ORBIT, ITEM_ZONE };
+
+    struct Item {
+        ItemKind kind;
+        int system;
+        BoundingSphere sphere;    // Bodies
+        BoundingBox box;          // Orbits
+        glm::vec3 center;         // Zones
+        float innerRadius;
+        float outerRadius;
+        bool occludable;
+        bool visible;
+    };
+
+    struct System {
+        BoundingBox bounds;
+        BoundingSphere occluder;
+        bool visible;
+    };
+
+    struct BVHNode {
+        BoundingBox bounds;
+        int left, right;          // Child nodes, -1 for leaves
+        int first, count;         // Range into bvhSystems for leaves
+    };
+
+    Frustum frustum;
+    glm::vec3 cameraPos;
+
+    std::vector<System> systems;
+    std::vector<Item> items;
+    std::vector<BVHNode> bvhNodes;
+    std::vector<int> bvhSystems;
+    std::vector<glm::vec3> bvhCenters;
+
+    CullStats stats;
+
+    void cullSystemsLinear();
+    void cullSystemsBVH();
+    int buildBVH(int first, int count);
+    void traverseBVH(int node);
+
+    bool isOccluded(const BoundingSphere& body, const BoundingSphere& occluder) const;
+};
+
+#endif // CULLER_H
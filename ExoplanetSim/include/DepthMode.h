@@ -0,0 +1,60 @@
+// DepthMode.h
+
+#ifndef DEPTHMODE_H
+#define DEPTHMODE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+
+#include "Shader.h"
+
+// Depth pipeline able to cover planet radii up to thousands of AU in a
+// single pass. Uses reverse-Z with an infinite far plane when
+// glClipControl is available (GL 4.5 / ARB_clip_control) and falls back
+// to a logarithmic depth buffer written by the shaders otherwise.
+class DepthMode {
+public:
+    enum Technique {
+        REVERSE_Z,
+        LOGARITHMIC
+    };
+
+    DepthMode();
+
+    // Detect glClipControl support and set the clip-space depth range.
+    // Must be called with a current context.
+    void initialize(GLADloadproc loader);
+
+    Technique getTechnique() const;
+    const char* getName() const;
+
+    // Preprocessor lines injected into every scene shader
+    std::string getShaderDefines() const;
+
+    // Projection with an infinite far plane for the active technique
+    glm::mat4 getProjection(float fovy, float aspect, float nearPlane) const;
+
+    // Conventional infinite projection, used for frustum culling
+    glm::mat4 getCullingProjection(float fovy, float aspect, float nearPlane) const;
+
+    float getClearDepth() const;
+    GLenum getDepthFunc() const;    // Scene geometry
+    GLenum getSkyDepthFunc() const; // Skybox drawn at infinity
+
+    // Upload the technique's uniforms (shader must be in use)
+    void setUniforms(const Shader& shader) const;
+
+    // Farthest distance resolved by the logarithmic fallback
+    static const float LOG_DEPTH_FAR;
+
+private:
+    typedef void (APIENTRYP PFNGLCLIPCONTROLPROC)(GLenum origin, GLenum depth);
+
+    Technique technique;
+    PFNGLCLIPCONTROLPROC clipControl;
+
+    static bool hasExtension(const char* name);
+};
+
+#endif // DEPTHMODE_H
@@ -0,0 +1,96 @@
+// FrameCapture.h
+
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <glad/glad.h>
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Image-sequence export of the scene framebuffer. glReadPixels writes into
+// a ring of pixel-pack buffers and is fenced, so the copy runs on the GPU
+// while later frames render; a slot is mapped only once its fence has
+// signaled. Encoding and file writes run on the thread pool.
+class FrameCapture {
+public:
+    enum Format {
+        FORMAT_PNG,
+        FORMAT_RAW
+    };
+
+    struct Stats {
+        int captured;        // Readbacks issued
+        int written;         // Files finished by the workers
+        int failed;          // Files that could not be written
+        int stalls;          // Frames where the render loop had to wait
+        double seconds;      // Since start
+        double throughput;   // Sustained frames written per second
+    };
+
+    static const int PBO_COUNT = 3;
+    static const int MAX_QUEUED_FRAMES = 8; // Frames waiting for the encoder
+
+    FrameCapture();
+    ~FrameCapture();
+
+    // Begin writing frame_NNNNNN.png/.rgba files to the directory
+    bool start(const std::string& directory, int width, int height,
+               Format format, ThreadPool& pool);
+
+    // Queue the readback of a width x height RGBA8 framebuffer
+    void captureFrame(GLuint framebuffer);
+
+    // Flush the outstanding readbacks and wait for the encoder
+    void stop();
+
+    bool isActive() const;
+    int getWidth() const;
+    int getHeight() const;
+    Stats getStats() const;
+
+    static bool parseFormat(const std::string& name, Format& format);
+
+private:
+    struct Slot {
+        GLuint pbo;
+        GLsync fence;
+        int frame;
+    };
+
+    bool active;
+    std::string directory;
+    int width;
+    int height;
+    Format format;
+    ThreadPool* pool;
+
+    Slot slots[PBO_COUNT];
+    int nextSlot;
+    int captured;
+    int stalls;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point stopTime;
+
+    // Shared with the encoder tasks
+    std::mutex mutex;
+    std::condition_variable frameDone;
+    int queued;
+    std::vector<std::vector<unsigned char>*> freeBuffers;
+    std::atomic<int> written;
+    std::atomic<int> failed;
+
+    // Map a finished slot and hand its pixels to the encoder
+    bool collect(Slot& slot, bool wait);
+    void encode(std::vector<unsigned char>* pixels, int frame);
+    size_t getFrameSize() const;
+    void destroy();
+};
+
+#endif // FRAMECAPTURE_H
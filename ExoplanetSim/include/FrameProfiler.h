@@ -0,0 +1,121 @@
+// FrameProfiler.h
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <glad/glad.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Rolling per-pass timings. GPU passes are measured with GL_TIME_ELAPSED
+// queries read back FRAMES_IN_FLIGHT frames later, so the CPU never waits
+// on the GPU; CPU sections are measured with ScopedCpuTimer.
+class FrameProfiler {
+public:
+    // GPU sections; the first five match RenderPass
+    enum GpuSection {
+        GPU_STAR = 0,
+        GPU_PLANETS,
+        GPU_SKYBOX,
+        GPU_STARFIELD,
+        GPU_ORBITS,
+        GPU_HABITABLE_ZONE,
+        GPU_IMGUI,
+        GPU_SECTION_COUNT
+    };
+
+    enum CpuSection {
+        CPU_FRAME = 0,
+        CPU_UPDATE,
+        CPU_UI,
+        CPU_RENDER,
+        CPU_IMGUI,
+        CPU_SECTION_COUNT
+    };
+
+    // Timing summary over the rolling history, in milliseconds
+    struct Summary {
+        int samples;
+        double average;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    static const int FRAMES_IN_FLIGHT = 4;
+    static const int HISTORY_SIZE = 240;
+
+    FrameProfiler();
+
+    // Create the query objects (needs a current context)
+    void initialize();
+
+    // Delete the query objects while the context is still current; the
+    // CPU history stays, so exportCsv still works afterwards
+    void shutdown();
+
+    // Collect finished queries from earlier frames and start a new frame
+    void beginFrame();
+
+    // GPU sections cannot nest: end one before beginning the next
+    void beginGpu(GpuSection section);
+    void endGpu();
+
+    void addCpuSample(CpuSection section, double milliseconds);
+
+    Summary getGpuSummary(GpuSection section) const;
+    Summary getCpuSummary(CpuSection section) const;
+
+    // Sum of every GPU section of the newest frame with results, in
+    // milliseconds (FRAMES_IN_FLIGHT frames old); 0 before the first one
+    double getLastGpuFrameTime() const;
+
+    static const char* getGpuSectionName(GpuSection section);
+    static const char* getCpuSectionName(CpuSection section);
+
+    // Write the summaries as CSV for regression tracking
+    bool exportCsv(const std::string& path) const;
+
+    // Summary of any list of samples in milliseconds
+    static Summary summarize(std::vector<float> samples);
+
+private:
+    // Fixed-size ring of samples
+    struct History {
+        std::vector<float> samples;
+        int next;
+        int count;
+
+        History() : samples(HISTORY_SIZE, 0.0f), next(0), count(0) {}
+        void add(float value);
+    };
+
+    bool initialized;
+    unsigned int frameIndex;
+    int activeSection;
+    double lastGpuFrameTime;
+
+    GLuint queries[FRAMES_IN_FLIGHT][GPU_SECTION_COUNT];
+    bool pending[FRAMES_IN_FLIGHT][GPU_SECTION_COUNT];
+
+    History gpuHistory[GPU_SECTION_COUNT];
+    History cpuHistory[CPU_SECTION_COUNT];
+
+    static Summary summarize(const History& history);
+};
+
+// Adds the lifetime of the object as a CPU sample
+class ScopedCpuTimer {
+public:
+    ScopedCpuTimer(FrameProfiler& profiler, FrameProfiler::CpuSection section);
+    ~ScopedCpuTimer();
+
+private:
+    FrameProfiler& profiler;
+    FrameProfiler::CpuSection section;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // FRAMEPROFILER_H
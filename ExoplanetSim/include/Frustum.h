@@ -0,0 +1,29 @@
+// Frustum.h
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "BoundingVolume.h"
+#include <glm/glm.hpp>
+
+class Frustum {
+public:
+    Frustum();
+
+    // Extract the clipping planes from a combined projection * view matrix
+    void update(const glm::mat4& viewProjection);
+
+    // Visibility tests; all of them are conservative (may report false positives)
+    bool intersectsSphere(const BoundingSphere& sphere) const;
+    bool intersectsBox(const BoundingBox& box) const;
+
+    // Flat annulus lying in the XZ plane (orbit plane), tested by its outer disc
+    bool intersectsAnnulus(const glm::vec3& center, float innerRadius, float outerRadius) const;
+
+private:
+    // Planes stored as (normal.xyz, distance), normals pointing inwards
+    glm::vec4 planes[6];
+    int planeCount;
+};
+
+#endif // FRUSTUM_H
@@ -0,0 +1,64 @@
+// GLStateCache.h
+
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <glad/glad.h>
+
+// Per-frame counters of state changes, used to compare against the
+// number of calls an uncached renderer would have made
+struct GLCallStats {
+    int requested; // State calls asked for by the renderer
+    int issued;    // State calls that actually reached the driver
+    int drawCalls;
+
+    GLCallStats() : requested(0), issued(0), drawCalls(0) {}
+};
+
+// Shadows the GL state the renderer touches and drops calls that would
+// not change anything. Call invalidate() whenever code outside the cache
+// (ImGui, mesh construction, ...) may have modified the state.
+class GLStateCache {
+public:
+    GLStateCache();
+
+    // Forget the shadowed state so the next call of each kind is issued
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindTexture(GLuint unit, GLenum target, GLuint texture);
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum source, GLenum destination);
+    void setDepthFunc(GLenum func);
+    void setDepthMask(bool enabled);
+    void setPointSize(float size);
+    void setLineWidth(float width);
+
+    // Count a draw call issued by the caller
+    void countDraw();
+
+    const GLCallStats& getStats() const;
+    void resetStats();
+
+    static const int MAX_TEXTURE_UNITS = 8;
+
+private:
+    GLuint program;
+    GLuint vertexArray;
+    GLuint activeUnit;
+    GLenum textureTargets[MAX_TEXTURE_UNITS];
+    GLuint textures[MAX_TEXTURE_UNITS];
+    int blend;                // Tri-state: -1 unknown, 0 off, 1 on
+    GLenum blendSource, blendDestination; // ~0u unknown
+    GLenum depthFunc;
+    int depthMask;            // Tri-state like blend
+    float pointSize;
+    float lineWidth;
+    bool programValid, vertexArrayValid, activeUnitValid;
+    bool texturesValid[MAX_TEXTURE_UNITS];
+
+    GLCallStats stats;
+};
+
+#endif // GLSTATECACHE_H
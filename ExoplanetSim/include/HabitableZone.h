@@ -5,21 +5,33 @@
 
 #include "RingMesh.h"
 #include "Shader.h"
+#include "RenderQueue.h"
 
 class HabitableZone {
 public:
   HabitableZone(float innerRadius, float outerRadius, Shader *shader);
   ~HabitableZone();
 
-  void Draw(const glm::mat4 &view, const glm::mat4 &projection);
+  // Record the zone draw; the shader's view/projection are set by the Renderer
+  void Record(RenderQueue &queue, float depth) const;
+
+  Shader *GetShader() const;
 
   // Method to update radii
   void UpdateRadii(float innerRadius, float outerRadius);
 
+  // Center of the zone (camera-relative), applied through the model matrix
+  void SetCenter(const glm::vec3 &center);
+
+  float GetInnerRadius() const;
+  float GetOuterRadius() const;
+
 private:
   RingMesh *ringMesh;
   Shader *shader;
   glm::mat4 modelMatrix;
+  float innerRadius;
+  float outerRadius;
 };
 
 #endif // HABITABLEZONE_H
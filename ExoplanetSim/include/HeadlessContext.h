@@ -0,0 +1,28 @@
+// HeadlessContext.h
+
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+// OpenGL 3.3 core context without a window or display server, created
+// through EGL on the surfaceless platform (works on Mesa llvmpipe). The
+// renderer draws into its own framebuffer objects, so no surface is
+// needed. Only available when built with EGL (EXOSIM_HAS_EGL).
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Create the context and make it current
+    bool initialize();
+
+    // Function loader for glad
+    static void* getProcAddress(const char* name);
+
+    static bool isAvailable();
+
+private:
+    void* display; // EGLDisplay
+    void* context; // EGLContext
+};
+
+#endif // HEADLESSCONTEXT_H
@@ -0,0 +1,26 @@
+// ImageWriter.h
+
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <string>
+
+// Minimal image file writers with no external dependencies. Safe to call
+// from worker threads.
+namespace ImageWriter {
+
+// 8-bit PNG (1 to 4 channels). Each row gets the PNG filter with the
+// smallest residuals, then the image is deflated (LZ77 and dynamic
+// Huffman codes). Tens of milliseconds per 1080p frame, so call it from
+// worker threads. Rows are stored top-down; flipVertically accepts
+// glReadPixels order.
+bool writePng(const std::string& path, int width, int height, int channels,
+              const unsigned char* pixels, bool flipVertically);
+
+// Headerless pixel dump, rows top-down (e.g. for ffmpeg -f rawvideo)
+bool writeRaw(const std::string& path, int width, int height, int channels,
+              const unsigned char* pixels, bool flipVertically);
+
+}
+
+#endif // IMAGEWRITER_H
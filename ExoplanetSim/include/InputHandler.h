@@ -22,6 +22,7 @@ public:
     static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void char_callback(GLFWwindow* window, unsigned int c);
     static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+    static void refresh_callback(GLFWwindow* window);
 
 private:
     Application* app;
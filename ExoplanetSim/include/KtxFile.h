@@ -0,0 +1,42 @@
+// KtxFile.h
+
+#ifndef KTXFILE_H
+#define KTXFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// KTX 1.1 container (Khronos texture file) holding a complete mip chain,
+// 2D or cubemap. Only compressed formats are written; the header's GL
+// enums are plain numbers so the converter needs no GL headers.
+struct KtxFile {
+    static const uint32_t COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;  // BC1
+    static const uint32_t COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3; // BC3
+    static const uint32_t BASE_RGB = 0x1907;
+    static const uint32_t BASE_RGBA = 0x1908;
+
+    uint32_t internalFormat;
+    uint32_t baseInternalFormat;
+    int width;
+    int height;
+    int faces;  // 1 or 6 (+X, -X, +Y, -Y, +Z, -Z)
+
+    // levels[level][face]: compressed blocks, level 0 is full size
+    std::vector<std::vector<std::vector<unsigned char> > > levels;
+
+    KtxFile()
+        : internalFormat(0), baseInternalFormat(0), width(0), height(0), faces(1) {}
+
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    int getLevelWidth(int level) const;
+    int getLevelHeight(int level) const;
+    size_t getTotalSize() const;
+
+    bool read(const std::string& path, std::string& error);
+    bool write(const std::string& path) const;
+
+    static bool isKtxPath(const std::string& path);
+};
+
+#endif // KTXFILE_H
@@ -0,0 +1,33 @@
+// Moon.h
+
+#ifndef MOON_H
+#define MOON_H
+
+#include "MoonModel.h"
+#include "Shader.h"
+#include "SphereMesh.h"
+#include "RenderQueue.h"
+#include <glm/glm.hpp>
+
+// Render layer of a moon. Moons are drawn with the planet shader, so they
+// shade (and are shadowed) like planets; they carry a flat color instead
+// of a surface texture.
+class Moon : public MoonModel {
+public:
+    Moon(float radius, float distance, float period, float phase,
+         float inclination, const glm::vec3& color);
+    ~Moon();
+
+    // Record the draw; occluderIndex is this moon's entry in the frame's
+    // occluder list, so it does not shadow itself
+    void record(RenderQueue& queue, const Shader& shader, const glm::mat4& model,
+                float depth, int occluderIndex) const;
+
+    void setMeshResolution(unsigned int sectors, unsigned int stacks);
+
+private:
+    SphereMesh sphereMesh;
+    unsigned int textureID; // 1x1 texture of the moon color
+};
+
+#endif // MOON_H
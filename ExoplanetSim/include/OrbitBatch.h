@@ -0,0 +1,101 @@
+// OrbitBatch.h
+
+#ifndef ORBITBATCH_H
+#define ORBITBATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "Shader.h"
+
+// Every orbit polyline in one vertex buffer, drawn with a single
+// glMultiDrawArrays. Orbits get a sub-range of the shared buffer from a
+// first-fit allocator; each point stores its position relative to the
+// orbit center, its phase along the orbit (0..1) and the orbit index.
+// Per-orbit state (camera-relative center, current phase, colors, line
+// style) lives in a texture buffer, so the traveled part is colored by
+// comparing the phase with the orbit phase instead of a second draw.
+//
+// Lines are not rasterized as GL lines: wide lines are unsupported in
+// core profiles on most drivers. The draw has no vertex attributes;
+// each segment is six vertices whose shader reads its end points (and
+// their neighbours, for miter joins) from the buffers as texture
+// buffers and expands them to a quad of constant pixel width with an
+// analytically anti-aliased edge and optional dashes.
+class OrbitBatch {
+public:
+    OrbitBatch();
+    ~OrbitBatch();
+
+    // Reserve an orbit; returns its handle
+    int add(const std::vector<glm::vec3>& path);
+    void remove(int orbit);
+
+    // Replace the path (a different length reallocates the range)
+    void setPath(int orbit, const std::vector<glm::vec3>& path);
+
+    // Per-frame state
+    void setOrigin(int orbit, const glm::vec3& cameraRelativeCenter);
+    void setPhase(int orbit, float phase);
+    void setVisible(int orbit, bool visible);
+    void setColors(int orbit, const glm::vec3& completed, const glm::vec3& upcoming);
+
+    // Width in pixels at 1080 lines; dashCount dashes per period on the
+    // upcoming part (0 for a solid line)
+    void setStyle(int orbit, float width, int dashCount);
+
+    // Upload changed per-orbit state, then record one draw for the
+    // visible orbits; the shader's view/projection are set by the Renderer
+    void record(RenderQueue& queue, const Shader& shader);
+
+    int getOrbitCount() const;
+    int getVisibleCount() const;
+    size_t getVertexCapacity() const;
+
+private:
+    struct Orbit {
+        GLint first;
+        GLsizei count;
+        GLsizei capacity;
+        bool visible;
+        bool used;
+    };
+
+    struct Block {
+        GLint first;
+        GLsizei capacity;
+    };
+
+    // Texels per orbit in the state buffer: origin + phase, completed
+    // color + width, upcoming color + dash count, first + count + closed
+    static const int TEXELS_PER_ORBIT = 4;
+    static const int VERTICES_PER_SEGMENT = 6;
+
+    GLuint VAO;            // Empty; the shader fetches everything
+    GLuint vertexBuffer;   // vec4: position relative to the center, phase
+    GLuint orbitIdBuffer;  // int: orbit index of each point
+    GLuint vertexTexture, orbitIdTexture; // Texture buffer views of the above
+    GLsizei vertexCapacity;
+    GLsizei vertexEnd;     // High-water mark of the allocated ranges
+
+    GLuint stateBuffer, stateTexture;
+    std::vector<float> state;
+    bool stateDirty;
+
+    std::vector<Orbit> orbits;
+    std::vector<Block> freeBlocks;
+
+    // Draw ranges of the last record(); must outlive the queue's execute()
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+
+    GLint allocate(GLsizei count, GLsizei& capacity);
+    void release(GLint first, GLsizei capacity);
+    void grow(GLsizei minimumCapacity);
+    void writeVertices(int orbit, const std::vector<glm::vec3>& path);
+    float* getState(int orbit);
+};
+
+#endif // ORBITBATCH_H
@@ -3,13 +3,16 @@
 #ifndef PLANET_H
 #define PLANET_H
 
+#include "PlanetModel.h"
 #include "Shader.h"
 #include "SphereMesh.h"
+#include "RenderQueue.h"
 #include <glm/glm.hpp>
 #include <string>
-#include <vector>
 
-class Planet {
+// Render layer of a planet: the mesh and surface texture drawn for a
+// PlanetModel
+class Planet : public PlanetModel {
 public:
     // Constructor and Destructor
     Planet(
@@ -21,87 +24,38 @@ public:
         float orbitalPeriod,
         float semiMajorAxis,
         const std::string& planetType,
-        const glm::vec3& orbitCenter,
+        const glm::dvec3& orbitCenter,
         const glm::vec3& planetColor,
-        const char* texturePath
+        unsigned int surfaceSeed = 0 // Surface texture is set with setTexture
     );
     ~Planet();
 
-    // Update the planet's position
-    void update(float deltaTime);
-
-    // Render functions
-    void render(const Shader& shader);
-    void renderOrbit(const Shader& shader, const glm::mat4& view, const glm::mat4& projection);
-
-    // Setters and Getters
-    void setMass(float mass);
-    float getMass() const;
-
-    void setRadius(float radius);
-    float getRadius() const;
-
-    void setTemperature(float temperature);
-    float getTemperature() const;
-
-    void setEccentricity(float eccentricity);
-    float getEccentricity() const;
-
-    void setOrbitalDistance(float distance);
-    float getOrbitalDistance() const;
-
-    void setOrbitalPeriod(float period);
-    float getOrbitalPeriod() const;
-
-    void setSemiMajorAxis(float sma);
-    float getSemiMajorAxis() const;
-
-    void setPlanetType(const std::string& type);
-    std::string getPlanetType() const;
+    // Record draw commands; view and projection are set per frame by the Renderer.
+    // occluderIndex is the planet's entry in the frame's occluder list.
+    void record(RenderQueue& queue, const Shader& shader, const glm::mat4& model, float depth,
+                int occluderIndex = -1) const;
 
     void setPlanetColor(const glm::vec3& color);
     glm::vec3 getPlanetColor() const;
 
-    // Generate the orbit path
-    void generateOrbitPath(int segments);
-
-    // Getter for current position
-    glm::vec3 getPosition() const;
+    // Seed of the procedural surface
+    void setSurfaceSeed(unsigned int seed);
+    unsigned int getSurfaceSeed() const;
 
-private:
-    // Fundamental parameters
-    float mass;
-    float radius;
-    float temperature;
-    float eccentricity;
-    float orbitalDistance;
-    float orbitalPeriod;
-    float semiMajorAxis;
-    std::string planetType;
+    // Replace the surface texture; the planet takes ownership
+    void setTexture(unsigned int texture);
 
-    glm::vec3 orbitCenter;
-    glm::vec3 position;
-    float currentTime;
+    // Detail used by the quality governor
+    void setMeshResolution(unsigned int sectors, unsigned int stacks);
 
+private:
     glm::vec3 planetColor;  // Planet color
+    unsigned int surfaceSeed;
 
     SphereMesh sphereMesh; // Sphere mesh for rendering
 
     // Texture
     unsigned int textureID; // Texture ID
-
-    // Orbit path data
-    std::vector<glm::vec3> orbitPositions;
-    unsigned int orbitVAO, orbitVBO;
-    size_t maxOrbitPoints; // Maximum number of points to store
-
-    // Current index in the orbit path
-    size_t currentOrbitIndex;
-
-    // Utility functions
-    glm::vec3 calculateOrbitalPosition(float time);
-    unsigned int loadTexture(const char* path);
-    void initOrbitBuffers();
 };
 
 #endif // PLANET_H
@@ -0,0 +1,72 @@
+// PlanetTextureGenerator.h
+
+#ifndef PLANETTEXTUREGENERATOR_H
+#define PLANETTEXTUREGENERATOR_H
+
+#include <glad/glad.h>
+
+#include "ThreadPool.h"
+
+#include <string>
+#include <vector>
+
+// Inputs that fully determine a generated surface
+struct PlanetSurfaceParams {
+    std::string planetType;
+    float temperature; // Kelvin
+    unsigned int seed;
+    int width;         // Equirectangular map, width = 2 * height
+    int height;
+
+    PlanetSurfaceParams(const std::string& planetType, float temperature,
+                        unsigned int seed, int height = 512)
+        : planetType(planetType), temperature(temperature), seed(seed),
+          width(height * 2), height(height) {}
+
+    // File name identifying the parameters (and generator version)
+    std::string getCacheKey() const;
+};
+
+// Procedural equirectangular planet maps: fractal-noise continents for
+// terrestrial planets, turbulent latitude bands for gas giants and ridged
+// ice for frozen worlds. Noise is sampled on the unit sphere, so maps are
+// seamless at the date line and undistorted at the poles. Rows are split
+// across the thread pool; results are cached on disk as PNG files.
+class PlanetTextureGenerator {
+public:
+    enum SurfaceStyle {
+        SURFACE_TERRESTRIAL,
+        SURFACE_GAS_GIANT,
+        SURFACE_ICY
+    };
+
+    // Bump when the output of a given set of parameters changes
+    static const int GENERATOR_VERSION = 1;
+
+    explicit PlanetTextureGenerator(ThreadPool& pool,
+                                    const std::string& cacheDirectory = "cache/planets");
+
+    // RGB8 pixels, first row at texture coordinate t = 0. Returns true if
+    // the map came from the cache.
+    bool generatePixels(const PlanetSurfaceParams& params, std::vector<unsigned char>& pixels);
+
+    // Generate (or load) and upload a mipmapped texture; main thread only
+    GLuint createTexture(const PlanetSurfaceParams& params);
+
+    // Upload pixels from generatePixels; main thread only
+    static GLuint uploadTexture(const PlanetSurfaceParams& params,
+                                const std::vector<unsigned char>& pixels);
+
+    static SurfaceStyle chooseStyle(const std::string& planetType, float temperature);
+
+private:
+    ThreadPool& pool;
+    std::string cacheDirectory;
+
+    bool loadCached(const std::string& path, const PlanetSurfaceParams& params,
+                    std::vector<unsigned char>& pixels) const;
+    void storeCached(const std::string& path, const PlanetSurfaceParams& params,
+                     const std::vector<unsigned char>& pixels);
+};
+
+#endif // PLANETTEXTUREGENERATOR_H
@@ -0,0 +1,74 @@
+// QualityGovernor.h
+
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <chrono>
+
+// Scene detail for one quality level
+struct QualitySettings {
+    float renderScale;          // Fraction of the framebuffer resolution
+    unsigned int sphereSectors; // Planet tessellation; moons use half
+    unsigned int sphereStacks;
+    int orbitSegments;          // Points per planet orbit
+    float starFraction;         // Share of the catalog drawn, brightest first
+};
+
+// Holds a target frame time by stepping through quality levels. The cost
+// of a frame is the larger of its CPU and GPU times, smoothed; the level
+// drops after the cost stays above the target for a few frames and rises
+// only after a long stretch well below it, so it does not oscillate.
+class QualityGovernor {
+public:
+    static const int LEVEL_COUNT = 5;
+
+    QualityGovernor();
+
+    // Disabled governors stay at the highest level
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    void setTargetFrameTime(double milliseconds);
+    double getTargetFrameTime() const;
+
+    // Feed the costs of one frame; returns true when the level changed
+    bool update(double cpuMilliseconds, double gpuMilliseconds);
+
+    int getLevel() const;
+    const QualitySettings& getSettings() const;
+    double getSmoothedFrameTime() const;
+
+private:
+    bool enabled;
+    double target;
+    int level;
+    double smoothed;  // Exponential moving average of the frame cost
+    int framesOver;   // Consecutive frames above the target
+    int framesUnder;  // Consecutive frames with headroom
+    int cooldown;     // Frames before the next change is allowed
+
+    void setLevel(int newLevel, int cooldownFrames);
+};
+
+// Caps the frame rate. Sleeping alone overshoots by up to a scheduler
+// tick, so the limiter sleeps until shortly before the deadline and spins
+// for the rest.
+class FrameLimiter {
+public:
+    FrameLimiter();
+
+    // 0 disables the cap
+    void setMaxFps(double fps);
+    double getMaxFps() const;
+
+    // Return when the next frame is due
+    void wait();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double maxFps;
+    Clock::time_point nextFrame;
+};
+
+#endif // QUALITYGOVERNOR_H
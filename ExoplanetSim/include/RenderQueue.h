@@ -0,0 +1,113 @@
+// RenderQueue.h
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "GLStateCache.h"
+#include "Shader.h"
+
+class DepthMode;
+class FrameProfiler;
+
+// Passes in submission order; the pass is the most significant part of
+// the sort key. Opaque geometry first, the sky behind it (cubemap or
+// additive starfield), then blended geometry on top: anti-aliased orbit
+// lines and the habitable zone.
+enum RenderPass {
+    PASS_STAR = 0,
+    PASS_PLANETS,
+    PASS_SKYBOX,
+    PASS_STARFIELD,
+    PASS_ORBITS,
+    PASS_HABITABLE_ZONE,
+    PASS_COUNT
+};
+
+// One recorded draw. Everything needed to issue it is stored up front so
+// commands can be sorted before any GL call is made.
+struct DrawCommand {
+    uint64_t key;
+
+    const Shader* shader;
+    GLenum textureTarget;   // GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP, 0 for none
+    GLuint texture;
+
+    // Further textures on units 1.. (texture buffers, lookup tables)
+    static const int MAX_EXTRA_TEXTURES = 2;
+    GLenum extraTextureTargets[MAX_EXTRA_TEXTURES];
+    GLuint extraTextures[MAX_EXTRA_TEXTURES];
+    GLuint vertexArray;
+
+    GLenum primitive;
+    GLint first;
+    GLsizei count;
+    bool indexed;           // glDrawElements with GL_UNSIGNED_INT indices
+    GLsizei instanceCount;  // Instanced draw when > 0
+
+    // glMultiDrawArrays over drawCount ranges when set; the arrays are
+    // owned by the recorder and must stay valid until execute()
+    const GLint* firsts;
+    const GLsizei* counts;
+    GLsizei drawCount;
+
+    float pointSize;        // Only applied when drawing GL_POINTS
+    float lineWidth;        // Only applied when drawing lines
+
+    // Per-draw uniforms (model matrix, colors, ...)
+    std::function<void(const Shader&)> setUniforms;
+
+    DrawCommand()
+        : key(0), shader(nullptr), textureTarget(0), texture(0), vertexArray(0),
+          primitive(GL_TRIANGLES), first(0), count(0), indexed(false),
+          instanceCount(0), firsts(nullptr), counts(nullptr), drawCount(0),
+          pointSize(1.0f), lineWidth(1.0f)
+    {
+        for (int i = 0; i < MAX_EXTRA_TEXTURES; ++i) {
+            extraTextureTargets[i] = 0;
+            extraTextures[i] = 0;
+        }
+    }
+};
+
+// Collects draw commands for a frame, sorts them by
+// pass > program > texture > depth and submits them through a GL state
+// cache so that redundant binds and toggles are skipped.
+class RenderQueue {
+public:
+    RenderQueue();
+
+    void clear();
+
+    // Record a draw; depth is the distance to the camera
+    void push(RenderPass pass, float depth, const DrawCommand& command);
+
+    // Sort and issue every recorded command; each pass is wrapped in a
+    // GPU timer query when a profiler is given
+    void execute(GLStateCache& state, const DepthMode& depthMode,
+                 FrameProfiler* profiler = nullptr);
+
+    size_t size() const;
+
+    // Builds a 64-bit sort key: 4 bits pass, 12 bits program,
+    // 16 bits texture and 32 bits depth
+    static uint64_t makeKey(RenderPass pass, GLuint program, GLuint texture, float depth);
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+        bool operator<(const SortEntry& other) const { return key < other.key; }
+    };
+
+    std::vector<DrawCommand> commands;
+    std::vector<SortEntry> order;
+
+    static void applyPassState(RenderPass pass, GLStateCache& state, const DepthMode& depthMode);
+};
+
+#endif // RENDERQUEUE_H
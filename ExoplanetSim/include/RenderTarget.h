@@ -0,0 +1,41 @@
+// RenderTarget.h
+
+#ifndef RENDERTARGET_H
+#define RENDERTARGET_H
+
+#include <glad/glad.h>
+
+// Offscreen framebuffer with an RGBA8 color texture and a 32-bit float
+// depth attachment. The default framebuffer cannot have a float depth
+// buffer, so the scene is rendered here and then blitted to the window.
+class RenderTarget {
+public:
+    RenderTarget();
+    ~RenderTarget();
+
+    // (Re)creates the attachments if the size changed
+    void resize(int width, int height);
+
+    // Bind as the draw framebuffer and set the viewport to cover it
+    void bind() const;
+
+    // Copy the color attachment into the default framebuffer, scaled to
+    // fit and centered
+    void blitToScreen(int screenWidth, int screenHeight) const;
+
+    GLuint getFramebuffer() const;
+    GLuint getColorTexture() const;
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    GLuint fbo;
+    GLuint colorTexture;
+    GLuint depthRenderbuffer;
+    int width;
+    int height;
+
+    void destroy();
+};
+
+#endif // RENDERTARGET_H
@@ -9,9 +9,14 @@
 #include "Camera.h"
 #include "Star.h"
 #include "Planet.h"
+#include "Moon.h"
 #include "Skybox.h"
 #include "Shader.h"
 #include "HabitableZone.h" // Include HabitableZone
+#include "Culler.h"
+#include "RenderTarget.h"
+#include "RenderQueue.h"
+#include "GLStateCache.h"
 
 class Application; // Forward declaration
 
@@ -20,9 +25,22 @@ public:
     Renderer(Application* app);
     void renderScene(float deltaTime);
 
+    // Culling results of the last rendered frame
+    const CullStats& getCullStats() const;
+
+    // State-change and draw counts of the last rendered frame
+    const GLCallStats& getCallStats() const;
+
+    // Size of the occluder array in planet_fragment.glsl
+    static const int MAX_OCCLUDERS = 8;
+
 private:
     Application* app;
     HabitableZone* habitableZone; // Add HabitableZone pointer
+    Culler culler;
+    RenderTarget sceneTarget; // Float depth target the scene is drawn into
+    RenderQueue queue;
+    GLStateCache state;
 };
 
 #endif // RENDERER_H
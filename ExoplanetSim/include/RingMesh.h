@@ -14,6 +14,15 @@ public:
 
   void Draw();
 
+  // Accessors used to record draw commands
+  unsigned int GetVAO() const;
+  int GetIndexCount() const;
+
+  // Vertex and index data without any GL
+  static void GenerateRing(float innerRadius, float outerRadius, int segments,
+                           std::vector<glm::vec3> &vertices,
+                           std::vector<unsigned int> &indices);
+
 private:
   unsigned int VAO, VBO, EBO;
   int indexCount;
@@ -0,0 +1,87 @@
+// SessionLog.h
+
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compact binary log of a session: for every frame, its duration and the
+// camera input and parameter changes made during it. A recording replays
+// the same camera path and the same edits at the same frames, which makes
+// a session a repeatable benchmark scenario.
+//
+// File layout (little-endian): "EXOSLOG1", u32 version, u32 width,
+// u32 height, then per frame f32 deltaTime, u16 event count and 10 bytes
+// per event (u8 type, u8 code, f32 x, f32 y).
+class SessionLog {
+public:
+    enum EventType {
+        EVENT_MOVE = 0, // code: Camera_Movement, x: delta time
+        EVENT_TURN,     // x, y: mouse offsets
+        EVENT_ZOOM,     // y: scroll offset
+        EVENT_PARAMETER // code: application parameter, x: value
+    };
+
+    struct Event {
+        uint8_t type;
+        uint8_t code;
+        float x;
+        float y;
+
+        Event() : type(0), code(0), x(0.0f), y(0.0f) {}
+        Event(EventType type, int code, float x, float y = 0.0f)
+            : type(static_cast<uint8_t>(type)), code(static_cast<uint8_t>(code)), x(x), y(y) {}
+    };
+
+    static const uint32_t VERSION = 1;
+
+    SessionLog();
+    ~SessionLog();
+
+    // Recording: frames are appended to the file as they end. Events added
+    // after endFrame (window callbacks while polling) go to the next frame.
+    bool startRecording(const std::string& path, int width, int height);
+    void beginFrame(float deltaTime);
+    void endFrame();
+    void add(const Event& event);
+
+    // Replay: the whole log is read up front
+    bool load(const std::string& path);
+    bool nextFrame(); // False after the last frame
+    float getFrameTime() const;
+    const std::vector<Event>& getEvents() const;
+    int getFrameIndex() const;
+    int getFrameCount() const;
+
+    // Finish the file (recording) or drop the log (replay)
+    void stop();
+
+    bool isRecording() const;
+    bool isReplaying() const;
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    struct Frame {
+        float deltaTime;
+        std::vector<Event> events;
+    };
+
+    std::ofstream output;
+    bool recording;
+    bool frameOpen;
+    Frame current;        // Frame being recorded
+    std::vector<Event> pending; // Added between frames, for the next one
+
+    std::vector<Frame> frames; // Loaded for replay
+    int frameIndex;
+
+    int width, height;
+
+    void writeFrame();
+};
+
+#endif // SESSIONLOG_H
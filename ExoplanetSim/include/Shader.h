@@ -12,14 +12,33 @@
 #include <sstream>
 #include <iostream>
 
+// Source text of both stages. Reading needs no context, so it can run on
+// a worker while the context is still being created.
+struct ShaderSource
+{
+    std::string vertex;
+    std::string fragment;
+    bool valid;
+
+    ShaderSource() : valid(false) {}
+
+    // Prints the error and returns false if a file cannot be read
+    bool read(const char* vertexPath, const char* fragmentPath);
+};
+
 class Shader
 {
 public:
     // Program ID
     unsigned int ID;
 
-    // Constructor reads and builds the shader
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // Constructor reads and builds the shader; optional preprocessor
+    // defines are inserted right after the #version line of both stages
+    Shader(const char* vertexPath, const char* fragmentPath,
+           const std::string& defines = std::string());
+
+    // Builds from sources read beforehand
+    explicit Shader(const ShaderSource& source, const std::string& defines = std::string());
 
     // Use/activate the shader program
     void use() const;
@@ -33,10 +52,18 @@ public:
 
     // Overloaded functions for setting uniforms with glm types
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    void setVec2(const std::string &name, const glm::vec2 &value) const;
     void setVec3(const std::string &name, const glm::vec3 &value) const;
 
     // Add the setVec4 method
     void setVec4(const std::string &name, const glm::vec4 &value) const;
+
+    // Upload count elements of a vec4 array uniform
+    void setVec4Array(const std::string &name, const glm::vec4* values, int count) const;
+
+private:
+    // Insert defines after the #version directive of a shader source
+    static std::string injectDefines(const std::string& source, const std::string& defines);
 };
 
 #endif // SHADER_H
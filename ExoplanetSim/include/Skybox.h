@@ -6,16 +6,19 @@
 #include <string>
 #include <glm/glm.hpp>
 
+#include "RenderQueue.h"
+#include "TextureLoader.h"
+
 class Skybox {
 public:
-    Skybox(const std::vector<std::string>& faces);
+    Skybox(const std::vector<std::string>& faces, TextureLoader& textures);
     ~Skybox();
-    void render();
+    // Record the skybox draw; the shader's view/projection are set by the Renderer
+    void record(RenderQueue& queue, const Shader& shader) const;
 
 private:
     GLuint cubemapTexture;
     GLuint VAO, VBO;
-    void loadCubemap(const std::vector<std::string>& faces);
     void setupMesh();
 };
 
@@ -18,6 +18,17 @@ public:
     // Draws the sphere mesh
     void Draw() const;
 
+    // Accessors used to record draw commands
+    unsigned int getVAO() const;
+    unsigned int getIndexCount() const;
+
+    // Rebuild the buffers with a different tessellation (no-op if unchanged)
+    void setResolution(unsigned int sectorCount, unsigned int stackCount);
+
+    // Vertex (position, normal, texCoords) and index data without any GL
+    static void generateSphere(float radius, unsigned int sectorCount, unsigned int stackCount,
+                               std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
 private:
     // OpenGL Object IDs
     unsigned int VAO, VBO, EBO;
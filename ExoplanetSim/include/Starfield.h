@@ -0,0 +1,87 @@
+// Starfield.h
+
+#ifndef STARFIELD_H
+#define STARFIELD_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "Photometry.h"
+
+// Night sky drawn from a star catalog instead of a cubemap. Every star is
+// one instance of a screen-aligned quad, sized and dimmed by its visual
+// magnitude, so the sky stays sharp at any resolution and costs a few
+// bytes per star. A coarse Milky Way band is drawn under the stars as a
+// separate additive mesh. Both sit at infinity: only the camera rotation
+// matters, which is correct from anywhere inside the system.
+class Starfield {
+public:
+    // Per-instance data, tightly packed
+    struct StarInstance {
+        float direction[3]; // Unit vector in world space
+        float temperature;  // Kelvin; the shader looks the color up
+        float intensity;    // Relative flux, 1 for a magnitude 1 star
+        float size;         // Quad half-size in pixels at 1080 lines
+    };
+
+    Starfield();
+    ~Starfield();
+
+    // CSV with name,ra_deg,dec_deg,vmag,b_v columns (J2000 equatorial);
+    // lines starting with '#' and the header row are skipped
+    bool loadCatalog(const std::string& path);
+
+    // The two halves of loadCatalog: parsing needs no context and may run
+    // on any thread; the stars come back brightest first. With
+    // photometry their brightness follows synthetic B, V and R magnitudes.
+    static bool parseCatalog(const std::string& path, std::vector<StarInstance>& stars,
+                             const Photometry* photometry = nullptr);
+    void setStars(const std::vector<StarInstance>& stars);
+
+    // Record the band and the stars; the shaders' view/projection and
+    // viewport are set by the Renderer
+    void record(RenderQueue& queue, const Shader& starShader, const Shader& bandShader) const;
+
+    int getStarCount() const;
+
+    // Draw only the brightest stars (the catalog is sorted on load);
+    // negative draws all
+    void setStarLimit(int limit);
+    int getDrawnStarCount() const;
+
+    // 1D BlackbodyTexture the star colors come from (not owned)
+    void setColorTable(GLuint texture);
+
+    // Scales every star's intensity
+    void setBrightness(float brightness);
+    float getBrightness() const;
+
+    void setMilkyWayVisible(bool visible);
+    bool isMilkyWayVisible() const;
+
+private:
+    GLuint starVAO, quadVBO, instanceVBO;
+    GLuint colorTable;
+    GLuint bandVAO, bandVBO, bandEBO;
+    int starCount;
+    int starLimit;
+    int bandIndexCount;
+    float brightness;
+    bool milkyWayVisible;
+
+    void setupMilkyWay();
+
+    // Flux of each star relative to REFERENCE_MAGNITUDE, averaged over
+    // the B, V and R bands when the photometry has them
+    static void displayFlux(const std::vector<StarInstance>& stars,
+                            const std::vector<float>& magnitudes,
+                            const Photometry* photometry, std::vector<float>& flux);
+
+    // Catalog coordinates to the simulation frame, whose xz plane is the ecliptic
+    static void equatorialToWorld(double raDegrees, double decDegrees, float out[3]);
+};
+
+#endif // STARFIELD_H
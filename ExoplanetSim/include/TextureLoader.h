@@ -0,0 +1,120 @@
+// TextureLoader.h
+
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+#include <glad/glad.h>
+
+#include "ThreadPool.h"
+#include "KtxFile.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Streams image files into textures without blocking the render loop.
+// load2D/loadCubemap return a texture immediately, holding a 1x1
+// placeholder color. Files are decoded on the thread pool. update() then
+// uploads the pixels through a pixel-unpack buffer into a staging
+// texture, uploadBudget bytes per frame. When an image is complete it is
+// copied into the returned texture in one step, so the texture name
+// never changes and callers keep it as before.
+//
+// .ktx files (see tools/texconv) carry BC1/BC3 data with a full mip chain.
+// They are uploaded with glCompressedTexImage2D straight into the
+// returned texture, coarsest level first. GL_TEXTURE_BASE_LEVEL tracks
+// the finest level resident, so the texture sharpens progressively and
+// is always complete. Without S3TC support the blocks are decoded on a
+// worker instead.
+class TextureLoader {
+public:
+    static const size_t DEFAULT_UPLOAD_BUDGET = 8 * 1024 * 1024; // Bytes per frame
+
+    TextureLoader(ThreadPool& pool, size_t uploadBudget = DEFAULT_UPLOAD_BUDGET);
+    ~TextureLoader();
+
+    // Mipmapped 2D texture; the caller owns the returned name. KTX files
+    // are stored already flipped, so flipVertically applies to images only.
+    GLuint load2D(const std::string& path, GLint wrap = GL_REPEAT, bool flipVertically = true);
+
+    // Six faces in GL_TEXTURE_CUBE_MAP_POSITIVE_X order, or one .ktx cubemap
+    GLuint loadCubemap(const std::vector<std::string>& faces);
+
+    // Main thread, once per frame: upload within the byte budget
+    void update();
+
+    // Block until every queued texture is resident
+    void finishAll();
+
+    // Images not yet uploaded completely
+    int getPendingCount() const;
+    size_t getBytesUploadedLastFrame() const;
+    size_t getResidentBytes() const; // Video memory of the loaded textures
+    bool isCompressionSupported() const;
+    size_t getUploadBudget() const;
+    void setUploadBudget(size_t bytes);
+
+private:
+    // One decoded image (a cubemap face or a 2D texture)
+    struct Image {
+        std::vector<unsigned char> pixels;
+        int width;
+        int height;
+        int channels;
+        bool failed;
+        std::string error;
+    };
+
+    struct Request {
+        GLuint texture;    // Name handed to the caller
+        GLenum target;     // GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+        std::vector<std::string> paths;
+        std::vector<Image> images;
+        KtxFile* ktx;      // Compressed source instead of images
+        bool ktxDecoded;   // Blocks expanded to RGBA8 (no S3TC)
+        std::string ktxError;
+        int taskCount;     // Decode tasks queued for the request
+        int decodedCount;  // Written by workers under the mutex
+
+        // Upload progress (main thread only)
+        GLuint staging;
+        int face;
+        int row;
+        int level;         // Next KTX level, coarsest first
+    };
+
+    ThreadPool& pool;
+    size_t uploadBudget;
+    size_t uploadedLastFrame;
+    size_t residentBytes;
+    bool s3tcSupported;
+
+    GLuint uploadBuffer;
+    size_t uploadBufferSize;
+    GLuint readFramebuffer;
+    GLuint drawFramebuffer;
+
+    mutable std::mutex mutex;
+    std::condition_variable decodedSignal;
+    std::deque<Request*> requests; // In submission order
+    std::chrono::steady_clock::time_point firstRequestTime;
+
+    GLuint createPlaceholder(GLenum target, const unsigned char color[4]) const;
+    Request* addRequest(GLuint texture, GLenum target, const std::vector<std::string>& paths);
+    void decode(Request* request, int index, bool flipVertically);
+    void decodeKtx(Request* request);
+    bool isDecoded(const Request* request) const;
+
+    // Upload rows (images) or levels (KTX) of the request; returns bytes used
+    size_t uploadRows(Request& request, size_t budget);
+    size_t uploadLevels(Request& request, size_t budget);
+    bool isComplete(const Request& request) const;
+    void finish(Request& request);
+
+    static GLenum getFormat(int channels);
+};
+
+#endif // TEXTURELOADER_H
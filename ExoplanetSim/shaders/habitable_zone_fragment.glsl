@@ -3,7 +3,16 @@ out vec4 FragColor;
 
 uniform vec4 color;
 
+#ifdef LOG_DEPTH
+uniform float logDepthCoef;
+in float logDepthW;
+#endif
+
 void main()
 {
     FragColor = color;
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = log2(logDepthW) * logDepthCoef * 0.5;
+#endif
 }
@@ -5,7 +5,17 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+#ifdef LOG_DEPTH
+uniform float logDepthCoef; // 2 / log2(far + 1)
+out float logDepthW;        // 1 + clip-space w, used for the per-fragment depth
+#endif
+
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
+
+#ifdef LOG_DEPTH
+    logDepthW = 1.0 + gl_Position.w;
+    gl_Position.z = (log2(max(1e-6, logDepthW)) * logDepthCoef - 1.0) * gl_Position.w;
+#endif
 }
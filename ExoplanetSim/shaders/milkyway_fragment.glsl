@@ -0,0 +1,15 @@
+// shaders/milkyway_fragment.glsl
+
+#version 330 core
+
+out vec4 FragColor;
+
+in float Intensity;
+
+// Faint, slightly warm glow added over the background
+const vec3 bandColor = vec3(0.10, 0.095, 0.085);
+
+void main()
+{
+    FragColor = vec4(bandColor * Intensity, 1.0);
+}
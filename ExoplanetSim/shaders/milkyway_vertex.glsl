@@ -0,0 +1,22 @@
+// shaders/milkyway_vertex.glsl
+
+#version 330 core
+
+layout(location = 0) in vec3 aDirection;
+layout(location = 1) in float aIntensity;
+
+out float Intensity;
+
+uniform mat4 view;        // Rotation only
+uniform mat4 projection;
+
+void main()
+{
+    Intensity = aIntensity;
+    vec4 pos = projection * view * vec4(aDirection, 1.0);
+#ifdef REVERSE_Z
+    gl_Position = vec4(pos.xy, 0.0, pos.w); // Depth 0 is infinitely far with reverse-Z
+#else
+    gl_Position = pos.xyww;
+#endif
+}
@@ -12,6 +12,11 @@ uniform mat4 model;       // Model matrix
 uniform mat4 view;        // View matrix
 uniform mat4 projection;  // Projection matrix
 
+#ifdef LOG_DEPTH
+uniform float logDepthCoef; // 2 / log2(far + 1)
+out float logDepthW;        // 1 + clip-space w, used for the per-fragment depth
+#endif
+
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
@@ -19,4 +24,9 @@ void main()
     TexCoords = aTexCoords;
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
+
+#ifdef LOG_DEPTH
+    logDepthW = 1.0 + gl_Position.w;
+    gl_Position.z = (log2(max(1e-6, logDepthW)) * logDepthCoef - 1.0) * gl_Position.w;
+#endif
 }
@@ -2,9 +2,40 @@
 
 out vec4 FragColor;
 
-uniform vec3 orbitColor;
+in float Phase;
+in float EdgeDistance;
+flat in float HalfWidth;
+flat in float OrbitPhase;
+flat in float DashCount;
+flat in vec3 CompletedColor;
+flat in vec3 UpcomingColor;
+
+#ifdef LOG_DEPTH
+uniform float logDepthCoef;
+in float logDepthW;
+#endif
 
 void main()
 {
-    FragColor = vec4(orbitColor, 1.0);
+    // Analytic coverage of the one-pixel band at the line edge
+    float coverage = clamp(HalfWidth + 0.5 - abs(EdgeDistance), 0.0, 1.0);
+
+    // Traveled part solid; the rest dashed in equal time steps, so the
+    // dashes bunch up where the planet moves slowly
+    bool traveled = Phase <= OrbitPhase;
+    float dash = 1.0;
+    if (!traveled && DashCount > 0.0) {
+        float t = Phase * DashCount;
+        float feather = max(fwidth(t), 1e-4);
+        float d = abs(fract(t) - 0.5); // 0 in the middle of a dash, 0.5 in a gap
+        dash = clamp((0.25 - d) / feather + 0.5, 0.0, 1.0);
+    }
+
+    FragColor = vec4(traveled ? CompletedColor : UpcomingColor, coverage * dash);
+    if (FragColor.a <= 0.0)
+        discard;
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = log2(logDepthW) * logDepthCoef * 0.5;
+#endif
 }
@@ -1,11 +1,136 @@
 #version 330 core
 
-layout(location = 0) in vec3 aPos;
+// No vertex attributes: every segment of every orbit is six vertices
+// (two triangles), and gl_VertexID / 6 is the index of the segment's
+// first point in the shared orbit buffer.
 
+// Per orbit, 4 texels: camera-relative center + current phase,
+// traveled color + width, upcoming color + dash count,
+// first point + point count + closed flag
+uniform samplerBuffer orbitState;
+uniform samplerBuffer orbitPoints;  // Position relative to the center, phase
+uniform isamplerBuffer orbitIds;    // Orbit of each point
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec2 viewportSize;
+
+out float Phase;
+out float EdgeDistance;             // Pixels from the center line
+flat out float HalfWidth;
+flat out float OrbitPhase;
+flat out float DashCount;
+flat out vec3 CompletedColor;
+flat out vec3 UpcomingColor;
+
+#ifdef LOG_DEPTH
+uniform float logDepthCoef; // 2 / log2(far + 1)
+out float logDepthW;        // 1 + clip-space w, used for the per-fragment depth
+#endif
+
+// Keeps points just in front of the eye so segments crossing behind
+// the camera are clipped instead of flipped
+const float MIN_W = 1e-4;
+
+vec4 toClip(int point, vec3 origin)
+{
+    return projection * view * vec4(texelFetch(orbitPoints, point).xyz + origin, 1.0);
+}
+
+vec2 toScreen(vec4 clip)
+{
+    return clip.xy / clip.w * 0.5 * viewportSize;
+}
+
+// Unit normal of the screen-space direction from a to b
+vec2 screenNormal(vec2 a, vec2 b, vec2 fallback)
+{
+    vec2 d = b - a;
+    float len = length(d);
+    return len > 1e-6 ? vec2(-d.y, d.x) / len : fallback;
+}
 
 void main()
 {
-    gl_Position = projection * view * vec4(aPos, 1.0);
+    int segment = gl_VertexID / 6;
+    int corner = gl_VertexID - segment * 6;
+
+    int orbit = texelFetch(orbitIds, segment).r;
+    vec4 origin = texelFetch(orbitState, orbit * 4);
+    vec4 completed = texelFetch(orbitState, orbit * 4 + 1);
+    vec4 upcoming = texelFetch(orbitState, orbit * 4 + 2);
+    vec4 range = texelFetch(orbitState, orbit * 4 + 3);
+    int first = int(range.x);
+    int last = first + int(range.y) - 1;
+    bool closed = range.z > 0.5;
+
+    // Two triangles: (a-, b-, a+) and (a+, b-, b+)
+    bool atEnd = corner == 1 || corner == 4 || corner == 5;
+    float side = (corner == 2 || corner == 3 || corner == 5) ? 1.0 : -1.0;
+
+    int a = segment;
+    int b = segment + 1;
+    int previous = a > first ? a - 1 : (closed ? last - 1 : a);
+    int next = b < last ? b + 1 : (closed ? first + 1 : b);
+
+    vec4 clipA = toClip(a, origin.xyz);
+    vec4 clipB = toClip(b, origin.xyz);
+    float phaseA = texelFetch(orbitPoints, a).w;
+    float phaseB = texelFetch(orbitPoints, b).w;
+
+    // Near clipping in clip space, where interpolation is linear
+    if (clipA.w < MIN_W && clipB.w < MIN_W) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0); // Entirely behind: outside the frustum
+        return;
+    }
+    if (clipA.w < MIN_W) {
+        float t = (MIN_W - clipA.w) / (clipB.w - clipA.w);
+        clipA = mix(clipA, clipB, t);
+        phaseA = mix(phaseA, phaseB, t);
+    } else if (clipB.w < MIN_W) {
+        float t = (MIN_W - clipB.w) / (clipA.w - clipB.w);
+        clipB = mix(clipB, clipA, t);
+        phaseB = mix(phaseB, phaseA, t);
+    }
+
+    vec2 screenA = toScreen(clipA);
+    vec2 screenB = toScreen(clipB);
+    vec2 normal = screenNormal(screenA, screenB, vec2(0.0, 1.0));
+
+    // Miter with the neighbouring segment at this end; both segments
+    // compute the same offset there, so the outline has no gaps. The
+    // neighbour is ignored when it is behind the camera.
+    vec2 joinNormal = normal;
+    if (atEnd && next != b) {
+        vec4 clipNext = toClip(next, origin.xyz);
+        if (clipNext.w >= MIN_W)
+            joinNormal = screenNormal(screenB, toScreen(clipNext), normal);
+    } else if (!atEnd && previous != a) {
+        vec4 clipPrevious = toClip(previous, origin.xyz);
+        if (clipPrevious.w >= MIN_W)
+            joinNormal = screenNormal(toScreen(clipPrevious), screenA, normal);
+    }
+    vec2 miter = normal + joinNormal;
+    miter = dot(miter, miter) > 1e-6 ? normalize(miter) : normal;
+    float miterScale = 1.0 / max(dot(miter, normal), 0.5); // Miter limit 2
+
+    // Line width follows the vertical resolution, plus one pixel of
+    // feather for the coverage ramp
+    HalfWidth = 0.5 * completed.w * viewportSize.y / 1080.0;
+    float extent = HalfWidth + 1.0;
+
+    vec4 clip = atEnd ? clipB : clipA;
+    vec2 offset = miter * miterScale * extent * side;
+    gl_Position = vec4(clip.xy + offset * 2.0 / viewportSize * clip.w, clip.zw);
+
+    Phase = atEnd ? phaseB : phaseA;
+    EdgeDistance = extent * side;
+    OrbitPhase = origin.w;
+    DashCount = upcoming.w;
+    CompletedColor = completed.rgb;
+    UpcomingColor = upcoming.rgb;
+
+#ifdef LOG_DEPTH
+    logDepthW = 1.0 + gl_Position.w;
+    gl_Position.z = (log2(max(1e-6, logDepthW)) * logDepthCoef - 1.0) * gl_Position.w;
+#endif
 }
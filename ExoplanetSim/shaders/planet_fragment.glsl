@@ -11,6 +11,69 @@ uniform vec3 lightColor;         // Color of the light emitted by the star
 uniform vec3 viewPos;            // Camera position
 uniform sampler2D planetTexture; // Texture sampler
 
+// Bodies that can pass between this fragment and the star: camera-relative
+// center and radius. selfOccluder is the entry of the body being drawn.
+#define MAX_OCCLUDERS 8
+uniform vec4 occluders[MAX_OCCLUDERS];
+uniform int occluderCount;
+uniform int selfOccluder;
+uniform float lightRadius;       // Radius of the star, for the penumbra
+
+#ifdef LOG_DEPTH
+uniform float logDepthCoef;
+in float logDepthW;
+#endif
+
+const float PI = 3.14159265359;
+
+// Angle between two unit vectors, precise for small angles
+float angleBetween(vec3 a, vec3 b)
+{
+    return atan(length(cross(a, b)), dot(a, b));
+}
+
+// Fraction of a disc of angular radius r1 hidden by a disc of angular
+// radius r2 whose center is d away (circle-circle intersection area)
+float discCoverage(float r1, float r2, float d)
+{
+    if (d >= r1 + r2)
+        return 0.0;
+    if (d <= abs(r1 - r2))
+        return min(r2 * r2 / (r1 * r1), 1.0); // Annular or total
+    float a1 = acos(clamp((d * d + r1 * r1 - r2 * r2) / (2.0 * d * r1), -1.0, 1.0));
+    float a2 = acos(clamp((d * d + r2 * r2 - r1 * r1) / (2.0 * d * r2), -1.0, 1.0));
+    float k = (-d + r1 + r2) * (d + r1 - r2) * (d - r1 + r2) * (d + r1 + r2);
+    float lens = r1 * r1 * a1 + r2 * r2 * a2 - 0.5 * sqrt(max(k, 0.0));
+    return clamp(lens / (PI * r1 * r1), 0.0, 1.0);
+}
+
+// Fraction of the star's disc seen from a point: 0 in the umbra, 1 in
+// full light. Occluders are combined as independent, which is exact
+// unless two of them overlap on the star at the same time.
+float starVisibility(vec3 position)
+{
+    vec3 toLight = lightPos - position;
+    float lightDistance = length(toLight);
+    vec3 lightDir = toLight / lightDistance;
+    float lightAngle = asin(min(lightRadius / lightDistance, 1.0));
+
+    float visible = 1.0;
+    for (int i = 0; i < occluderCount; ++i) {
+        if (i == selfOccluder)
+            continue;
+        vec3 toOccluder = occluders[i].xyz - position;
+        float occluderDistance = length(toOccluder);
+        // Only bodies between the point and the star cast a shadow here
+        if (occluderDistance <= occluders[i].w || occluderDistance >= lightDistance ||
+            dot(toOccluder, lightDir) <= 0.0)
+            continue;
+        float occluderAngle = asin(occluders[i].w / occluderDistance);
+        float separation = angleBetween(toOccluder / occluderDistance, lightDir);
+        visible *= 1.0 - discCoverage(lightAngle, occluderAngle, separation);
+    }
+    return visible;
+}
+
 void main()
 {
     // Texture Sampling
@@ -21,8 +84,11 @@ void main()
     vec3 lightDir = normalize(lightPos - FragPos);
     vec3 viewDir = normalize(viewPos - FragPos);
 
+    // Eclipses by other bodies dim the direct light
+    float shadow = starVisibility(FragPos);
+
     // Calculate diffuse component
-    float diff = max(dot(norm, lightDir), 0.0);
+    float diff = max(dot(norm, lightDir), 0.0) * shadow;
     vec3 diffuse = diff * lightColor * texColor;
 
     // Calculate ambient component scaled by diffuse
@@ -34,7 +100,7 @@ void main()
     float specularStrength = 0.5;
     vec3 reflectDir = reflect(-lightDir, norm);
     float shininess = 32.0;
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess) * shadow;
     vec3 specular = specularStrength * spec * lightColor;
 
     // Combine lighting components
@@ -48,4 +114,8 @@ void main()
     result = clamp(result, 0.0, 1.0);
 
     FragColor = vec4(result, 1.0);
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = log2(logDepthW) * logDepthCoef * 0.5;
+#endif
 }
@@ -13,5 +13,9 @@ void main()
 {
     TexCoords = aPos;
     vec4 pos = projection * view * vec4(aPos, 1.0);
+#ifdef REVERSE_Z
+    gl_Position = vec4(pos.xy, 0.0, pos.w); // Depth 0 is infinitely far with reverse-Z
+#else
     gl_Position = pos.xyww; // Set w component to w (for perspective division)
+#endif
 }
@@ -9,6 +9,11 @@ in vec2 TexCoords; // Received from vertex shader
 // Texture sampler
 uniform sampler2D starTexture;
 
+#ifdef LOG_DEPTH
+uniform float logDepthCoef;
+in float logDepthW;
+#endif
+
 void main()
 {
     // Sample the texture color
@@ -16,4 +21,8 @@ void main()
     
     // Output the texture color directly
     FragColor = vec4(texColor, 1.0);
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = log2(logDepthW) * logDepthCoef * 0.5;
+#endif
 }
@@ -0,0 +1,17 @@
+// shaders/starfield_fragment.glsl
+
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 Corner;
+in vec3 Color;
+
+void main()
+{
+    // Gaussian point spread function, about 3 sigma at the quad edge
+    float r2 = dot(Corner, Corner);
+    if (r2 > 1.0)
+        discard;
+    FragColor = vec4(Color * exp(-4.5 * r2), 1.0);
+}
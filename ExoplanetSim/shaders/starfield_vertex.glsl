@@ -0,0 +1,46 @@
+// shaders/starfield_vertex.glsl
+
+#version 330 core
+
+layout(location = 0) in vec2 aCorner;    // Quad corner in [-1, 1]
+layout(location = 1) in vec3 aDirection; // Per star: unit vector to the star
+layout(location = 2) in vec2 aColor;     // Per star: temperature (K) and relative intensity
+layout(location = 3) in float aSize;     // Per star: half-size in pixels at 1080 lines
+
+out vec2 Corner;
+out vec3 Color;
+
+uniform mat4 view;        // Rotation only
+uniform mat4 projection;
+uniform vec2 viewportSize;
+uniform float brightness;
+uniform sampler1D blackbody; // BlackbodyTable, evenly spaced in 1 / T
+
+// Same mapping as BlackbodyTable::getCoordinate, then onto texel centers
+float blackbodyCoordinate(float temperature)
+{
+    const float MIN_TEMPERATURE = 1000.0;
+    const float MAX_TEMPERATURE = 40000.0;
+    float t = clamp(temperature, MIN_TEMPERATURE, MAX_TEMPERATURE);
+    float u = (1.0 / MIN_TEMPERATURE - 1.0 / t) / (1.0 / MIN_TEMPERATURE - 1.0 / MAX_TEMPERATURE);
+    float size = float(textureSize(blackbody, 0));
+    return (u * (size - 1.0) + 0.5) / size;
+}
+
+void main()
+{
+    vec4 center = projection * view * vec4(aDirection, 1.0);
+
+    // Constant footprint in pixels, scaled with the vertical resolution so
+    // captures at other sizes look the same
+    vec2 pixels = aCorner * aSize * (viewportSize.y / 1080.0);
+    vec2 offset = pixels * 2.0 / viewportSize * center.w;
+
+    Corner = aCorner;
+    Color = texture(blackbody, blackbodyCoordinate(aColor.x)).rgb * aColor.y * brightness;
+#ifdef REVERSE_Z
+    gl_Position = vec4(center.xy + offset, 0.0, center.w); // Depth 0 is infinitely far with reverse-Z
+#else
+    gl_Position = vec4(center.xy + offset, center.w, center.w);
+#endif
+}
@@ -0,0 +1,185 @@
+// AppOptions.cpp
+
+#include "AppOptions.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Reads the integer argument following argv[i]
+static bool readInt(int argc, char** argv, int& i, int& value)
+{
+    if (i + 1 >= argc) {
+        std::cerr << "Error: " << argv[i] << " expects a value." << std::endl;
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = std::strtol(argv[++i], &end, 10);
+    if (end == argv[i] || *end != '\0' || parsed < 0) {
+        std::cerr << "Error: Invalid value for " << argv[i - 1] << ": " << argv[i] << std::endl;
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Reads the non-negative number following argv[i]
+static bool readDouble(int argc, char** argv, int& i, double& value)
+{
+    if (i + 1 >= argc) {
+        std::cerr << "Error: " << argv[i] << " expects a value." << std::endl;
+        return false;
+    }
+    char* end = nullptr;
+    double parsed = std::strtod(argv[++i], &end);
+    if (end == argv[i] || *end != '\0' || parsed < 0.0) {
+        std::cerr << "Error: Invalid value for " << argv[i - 1] << ": " << argv[i] << std::endl;
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Reads the string argument following argv[i]
+static bool readString(int argc, char** argv, int& i, std::string& value)
+{
+    if (i + 1 >= argc) {
+        std::cerr << "Error: " << argv[i] << " expects a value." << std::endl;
+        return false;
+    }
+    value = argv[++i];
+    return true;
+}
+
+bool AppOptions::parse(int argc, char** argv, AppOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--width") == 0) {
+            if (!readInt(argc, argv, i, options.width))
+                return false;
+        } else if (std::strcmp(arg, "--height") == 0) {
+            if (!readInt(argc, argv, i, options.height))
+                return false;
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            if (!readInt(argc, argv, i, options.frames))
+                return false;
+        } else if (std::strcmp(arg, "--timing-log") == 0) {
+            if (!readString(argc, argv, i, options.timingLog))
+                return false;
+        } else if (std::strcmp(arg, "--skybox") == 0) {
+            options.skybox = true;
+        } else if (std::strcmp(arg, "--render-only-main") == 0) {
+            options.renderOnlyMain = true;
+        } else if (std::strcmp(arg, "--target-ms") == 0) {
+            if (!readDouble(argc, argv, i, options.targetFrameTime))
+                return false;
+        } else if (std::strcmp(arg, "--fps-cap") == 0) {
+            if (!readDouble(argc, argv, i, options.fpsCap))
+                return false;
+        } else if (std::strcmp(arg, "--no-vsync") == 0) {
+            options.vsync = false;
+        } else if (std::strcmp(arg, "--no-idle") == 0) {
+            options.idle = false;
+        } else if (std::strcmp(arg, "--capture") == 0) {
+            if (!readString(argc, argv, i, options.captureDirectory))
+                return false;
+        } else if (std::strcmp(arg, "--capture-format") == 0) {
+            if (!readString(argc, argv, i, options.captureFormat))
+                return false;
+        } else if (std::strcmp(arg, "--capture-width") == 0) {
+            if (!readInt(argc, argv, i, options.captureWidth))
+                return false;
+        } else if (std::strcmp(arg, "--capture-height") == 0) {
+            if (!readInt(argc, argv, i, options.captureHeight))
+                return false;
+        } else if (std::strcmp(arg, "--capture-fps") == 0) {
+            if (!readInt(argc, argv, i, options.captureFps))
+                return false;
+        } else if (std::strcmp(arg, "--record") == 0) {
+            if (!readString(argc, argv, i, options.recordPath))
+                return false;
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            if (!readString(argc, argv, i, options.replayPath))
+                return false;
+        } else if (std::strcmp(arg, "--report") == 0) {
+            if (!readString(argc, argv, i, options.reportPath))
+                return false;
+        } else if (std::strcmp(arg, "--trace") == 0) {
+            if (!readString(argc, argv, i, options.tracePath))
+                return false;
+        } else if (std::strcmp(arg, "--no-trace") == 0) {
+            options.trace = false;
+        } else if (std::strcmp(arg, "--state-feed") == 0) {
+            if (!readString(argc, argv, i, options.stateFeed))
+                return false;
+        } else {
+            if (std::strcmp(arg, "--help") != 0 && std::strcmp(arg, "-h") != 0)
+                std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (options.width <= 0 || options.height <= 0) {
+        std::cerr << "Error: Width and height must be positive." << std::endl;
+        return false;
+    }
+
+    if (options.captureFormat != "png" && options.captureFormat != "raw") {
+        std::cerr << "Error: Capture format must be png or raw." << std::endl;
+        return false;
+    }
+    if (options.captureFps <= 0) {
+        std::cerr << "Error: Capture fps must be positive." << std::endl;
+        return false;
+    }
+
+    if (!options.recordPath.empty() && !options.replayPath.empty()) {
+        std::cerr << "Error: --record and --replay cannot be combined." << std::endl;
+        return false;
+    }
+    if (!options.replayPath.empty() && options.reportPath.empty())
+        options.reportPath = options.replayPath + ".report.csv";
+
+    // Shared-memory names are rooted
+    if (!options.stateFeed.empty() && options.stateFeed[0] != '/')
+        options.stateFeed = "/" + options.stateFeed;
+
+    // A headless run needs an end; a replay ends with its log
+    if (options.headless && options.frames == 0 && options.replayPath.empty())
+        options.frames = 600;
+
+    return true;
+}
+
+void AppOptions::printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --headless          Render offscreen (EGL surfaceless, e.g. Mesa llvmpipe)\n"
+              << "  --width N           Framebuffer width (default 1280)\n"
+              << "  --height N          Framebuffer height (default 720)\n"
+              << "  --frames N          Exit after N frames (headless default 600)\n"
+              << "  --timing-log PATH   Write pass timings as CSV on exit\n"
+              << "  --skybox            Cubemap background instead of the star catalog\n"
+              << "  --render-only-main  Leave all simulation jobs to the worker threads\n"
+              << "  --target-ms T       Adapt quality to hold T ms per frame (e.g. 16.6)\n"
+              << "  --fps-cap N         Limit the frame rate to N\n"
+              << "  --no-vsync          Do not wait for the display refresh\n"
+              << "  --no-idle           Keep rendering while paused and untouched\n"
+              << "  --capture DIR       Write every frame to DIR as an image sequence\n"
+              << "  --capture-format F  png (default) or raw RGBA\n"
+              << "  --capture-width N   Capture resolution (default: framebuffer size)\n"
+              << "  --capture-height N\n"
+              << "  --capture-fps N     Simulated frames per second of video (default 60)\n"
+              << "  --record PATH       Record camera input and parameter edits to PATH\n"
+              << "  --replay PATH       Replay a recorded session at a fixed 60 Hz step\n"
+              << "  --report PATH       Frame times of the replay (default: <replay>.report.csv)\n"
+              << "  --trace PATH        Write a Chrome trace of the CPU zones on exit\n"
+              << "  --no-trace          Do not record trace zones\n"
+              << "  --state-feed NAME   Publish the live state to shared memory NAME (e.g. /exosim)\n"
+              << "  --help              Show this message" << std::endl;
+}
@@ -3,18 +3,82 @@
 #include "Application.h"
 #include "InputHandler.h"
 #include "Renderer.h"
+#include "TaskGraph.h"
+#include "BlackbodyTable.h"
+#include "TraceProfiler.h"
 
-#include <cmath> // For sqrt
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <sstream>
+
+// Block-compressed copy made by the compress_textures target, if present
+static std::string preferCompressed(const std::string& ktxPath, const std::string& fallback)
+{
+    std::ifstream file(ktxPath.c_str(), std::ios::binary);
+    return file.good() ? ktxPath : fallback;
+}
 
-Application::Application()
-    : window(nullptr), camera(glm::vec3(0.0f, 5.0f, 15.0f)), deltaTime(0.0f),
-      lastFrame(0.0f), lastX(SCR_WIDTH / 2.0f), lastY(SCR_HEIGHT / 2.0f),
-      firstMouse(true), cursorEnabled(false), skybox(nullptr), star(nullptr),
+// "<label> 12.3 ms" without changing std::cout's number format
+static void printMilliseconds(const char* label, double seconds)
+{
+    std::ostringstream line;
+    line << label << ' ' << std::fixed << std::setprecision(1) << seconds * 1000.0 << " ms";
+    std::cout << line.str() << std::endl;
+}
+
+// Programs compiled at startup (the skybox's compiles on first use)
+enum StartupShader {
+    SHADER_STAR = 0,
+    SHADER_PLANET,
+    SHADER_STARFIELD,
+    SHADER_MILKY_WAY,
+    SHADER_ORBIT,
+    SHADER_HABITABLE_ZONE,
+    STARTUP_SHADER_COUNT
+};
+
+static const char* STARTUP_SHADER_PATHS[STARTUP_SHADER_COUNT][2] = {
+    { "../shaders/star_vertex.glsl", "../shaders/star_fragment.glsl" },
+    { "../shaders/object_vertex.glsl", "../shaders/planet_fragment.glsl" },
+    { "../shaders/starfield_vertex.glsl", "../shaders/starfield_fragment.glsl" },
+    { "../shaders/milkyway_vertex.glsl", "../shaders/milkyway_fragment.glsl" },
+    { "../shaders/orbit_vertex.glsl", "../shaders/orbit_fragment.glsl" },
+    { "../shaders/habitable_zone_vertex.glsl", "../shaders/habitable_zone_fragment.glsl" }
+};
+
+// Passbands of the synthetic photometry; a missing file only drops its band
+static const char* PHOTOMETRY_FILTERS[] = {
+    "../data/filters/B.csv", "../data/filters/V.csv",
+    "../data/filters/R.csv", "../data/filters/I.csv"
+};
+static const int PHOTOMETRY_FILTER_COUNT = 4;
+
+// Planet types offered in the UI; session logs store the index
+static const char* PLANET_TYPES[] = { "Terrestrial", "Gas Giant", "Icy" };
+static const int PLANET_TYPE_COUNT = 3;
+
+Application::Application(const AppOptions& appOptions)
+    : window(nullptr), camera(glm::dvec3(0.0, 5.0, 15.0)), deltaTime(0.0f),
+      options(appOptions), lastFrame(0.0f), frameCount(0),
+      lastX(appOptions.width / 2.0f), lastY(appOptions.height / 2.0f),
+      firstMouse(true), cursorEnabled(false), firstFrameTime(-1.0),
+      skybox(nullptr), starfield(nullptr), blackbody(nullptr),
+      skyboxEnabled(false), star(nullptr),
       planet(nullptr), habitableZone(nullptr), // Initialize to nullptr
+      orbits(nullptr), planetOrbit(-1), planetOrbitRevision(0),
       starShader(nullptr), planetShader(nullptr), skyboxShader(nullptr),
+      starfieldShader(nullptr), milkyWayShader(nullptr),
       orbitShader(nullptr), habitableZoneShader(nullptr), io(nullptr),
       showSeparateWindow(false), // Initialize the state variable
+      showDebugOverlay(false), paused(false), redrawFrames(REDRAW_FRAMES),
+      drawnCameraPosition(0.0), drawnCameraFront(0.0f), drawnCameraZoom(0.0f), idleWakeups(0),
+      simulationTime(0.0), planetTextures(nullptr), textures(nullptr),
       imageTexture1(0), imageTexture2(0), imageTexture3(0),
       showImage1(false), showImage2(false), showImage3(false)
 {}
@@ -22,13 +86,20 @@ Application::Application()
 Application::~Application() {
     // Cleanup
     delete skybox;
+    delete starfield;
+    delete blackbody;
     delete star;
+    setMoonCount(0);
     delete planet;
     delete habitableZone; // Delete HabitableZone
+    delete orbits;
+    delete planetTextures;
 
     delete starShader;
     delete planetShader;
     delete skyboxShader;
+    delete starfieldShader;
+    delete milkyWayShader;
     delete orbitShader;
     delete habitableZoneShader; // Delete HabitableZone shader
 
@@ -36,24 +107,142 @@ Application::~Application() {
     glDeleteTextures(1, &imageTexture1);
     glDeleteTextures(1, &imageTexture2);
     glDeleteTextures(1, &imageTexture3);
+    delete textures;
 
-    // Shutdown ImGui
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+    // GPU timer queries
+    profiler.shutdown();
+
+    // Shutdown ImGui (headless runs never create it)
+    if (io != nullptr) {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+    }
 
     // Terminate GLFW
-    glfwTerminate();
+    if (!options.headless)
+        glfwTerminate();
 }
 
 bool Application::initialize() {
-    if (!initWindow())
-        return false;
-    if (!initOpenGL())
-        return false;
-    initObjects();
-    if (!initImGui())
+    startTime = std::chrono::steady_clock::now();
+    TraceProfiler::setThreadName("Main");
+    TraceProfiler::setEnabled(options.trace);
+
+    if (!options.replayPath.empty()) {
+        if (!session.load(options.replayPath))
+            return false;
+        std::cout << "Replaying " << session.getFrameCount() << " frames from "
+                  << options.replayPath << std::endl;
+        if (session.getWidth() != options.width || session.getHeight() != options.height)
+            std::cout << "Note: Recorded at " << session.getWidth() << "x" << session.getHeight()
+                      << "; pass --width and --height to compare like for like" << std::endl;
+    }
+
+    // Simulation jobs can be kept off the main thread entirely
+    workers.setExternalThreadsHelp(!options.renderOnlyMain);
+
+    // Startup is a dependency graph. File reads, catalog parsing and
+    // surface generation run on the workers while this thread creates the
+    // context; each piece of GL work runs here as soon as its inputs are
+    // ready, with texture uploads between the shader compiles.
+    ShaderSource shaderSources[STARTUP_SHADER_COUNT];
+    std::vector<Starfield::StarInstance> catalogStars;
+    bool catalogLoaded = false;
+    PlanetSurfaceParams surfaceParams("Terrestrial", 288.0f, 1u);
+    std::vector<unsigned char> surfacePixels;
+    bool contextReady = false;
+    bool imguiReady = options.headless;
+
+    // Nothing after the context runs if it could not be created
+    std::function<std::function<void()>(std::function<void()>)> needsContext =
+        [&contextReady](std::function<void()> task) {
+            return [&contextReady, task] {
+                if (contextReady)
+                    task();
+            };
+        };
+
+    TaskGraph startup;
+    int context = startup.addOnCaller([&] {
+        TRACE_ZONE("Context");
+        contextReady = (options.headless ? initHeadless() : initWindow()) && initOpenGL();
+    });
+    int scene = startup.addOnCaller(needsContext([&] { initScene(); }));
+    startup.precede(context, scene);
+
+    for (int i = 0; i < STARTUP_SHADER_COUNT; ++i) {
+        int read = startup.add([&shaderSources, i] {
+            TRACE_ZONE("Shader read");
+            shaderSources[i].read(STARTUP_SHADER_PATHS[i][0], STARTUP_SHADER_PATHS[i][1]);
+        });
+        int compile = startup.addOnCaller(needsContext([this, &shaderSources, i] {
+            compileShader(i, shaderSources[i]);
+            textures->update(); // Decoded images upload between compiles
+        }));
+        startup.precede(read, compile);
+        startup.precede(scene, compile);
+        if (i == SHADER_HABITABLE_ZONE) {
+            int zone = startup.addOnCaller(needsContext([this] { initHabitableZone(); }));
+            startup.precede(compile, zone);
+        }
+    }
+
+    int catalog = startup.add([&] {
+        TRACE_ZONE("Catalog parse");
+        for (int i = 0; i < PHOTOMETRY_FILTER_COUNT; ++i)
+            photometry.loadFilter(PHOTOMETRY_FILTERS[i]);
+        catalogLoaded = Starfield::parseCatalog("../data/bright_stars.csv", catalogStars, &photometry);
+        BlackbodyTable::get(); // Integrate the spectra here rather than on the main thread
+    });
+    int background = startup.addOnCaller(needsContext([&] {
+        blackbody = new BlackbodyTexture();
+        starfield = new Starfield();
+        starfield->setColorTable(blackbody->getID());
+        if (catalogLoaded)
+            starfield->setStars(catalogStars);
+        setSkyboxEnabled(options.skybox || !catalogLoaded);
+    }));
+    startup.precede(catalog, background);
+    startup.precede(scene, background);
+
+    // Surface parameters come from the planet, so this waits for the scene
+    int surface = startup.add(needsContext([&] {
+        TRACE_ZONE("Surface generate");
+        surfaceParams = PlanetSurfaceParams(planet->getPlanetType(), planet->getTemperature(),
+                                            planet->getSurfaceSeed());
+        planetTextures->generatePixels(surfaceParams, surfacePixels);
+    }));
+    int surfaceUpload = startup.addOnCaller(needsContext([&] {
+        planet->setTexture(PlanetTextureGenerator::uploadTexture(surfaceParams, surfacePixels));
+    }));
+    startup.precede(scene, surface);
+    startup.precede(surface, surfaceUpload);
+
+    if (!options.headless) {
+        int imgui = startup.addOnCaller(needsContext([&] { imguiReady = initImGui(); }));
+        startup.precede(context, imgui);
+    }
+
+    {
+        TRACE_ZONE("Startup");
+        startup.run(workers);
+    }
+    if (!contextReady || !imguiReady)
         return false;
+
+    finishStartup();
+
+    // Offline renders must not record placeholder frames
+    if (options.headless || !options.captureDirectory.empty())
+        textures->finishAll();
+
+    if (!options.recordPath.empty()) {
+        int width, height;
+        getFramebufferSize(width, height);
+        if (!session.startRecording(options.recordPath, width, height))
+            return false;
+    }
     return true;
 }
 
@@ -70,7 +259,7 @@ bool Application::initWindow() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
     // Create window
-    window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Exoplanet Simulation",
+    window = glfwCreateWindow(options.width, options.height, "Exoplanet Simulation",
                               nullptr, nullptr);
     if (window == nullptr) {
         std::cerr << "Error: Failed to create GLFW window." << std::endl;
@@ -78,6 +267,7 @@ bool Application::initWindow() {
         return false;
     }
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(options.vsync ? 1 : 0);
 
     // Set input callbacks
     glfwSetFramebufferSizeCallback(window,
@@ -87,6 +277,7 @@ bool Application::initWindow() {
     glfwSetKeyCallback(window, InputHandler::key_callback);
     glfwSetCharCallback(window, InputHandler::char_callback);
     glfwSetMouseButtonCallback(window, InputHandler::mouse_button_callback);
+    glfwSetWindowRefreshCallback(window, InputHandler::refresh_callback);
 
     // Capture mouse cursor (hidden by default)
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -94,9 +285,22 @@ bool Application::initWindow() {
     return true;
 }
 
+bool Application::initHeadless() {
+    // Surfaceless EGL context; the renderer draws into its own framebuffer
+    if (!headlessContext.initialize())
+        return false;
+
+    std::cout << "Headless: rendering " << options.frames << " frames at "
+              << options.width << "x" << options.height << std::endl;
+    return true;
+}
+
 bool Application::initOpenGL() {
-    // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    // Initialize GLAD from whichever API created the context
+    GLADloadproc loader = options.headless
+        ? (GLADloadproc)HeadlessContext::getProcAddress
+        : (GLADloadproc)glfwGetProcAddress;
+    if (!gladLoadGLLoader(loader)) {
         std::cerr << "Error: Failed to initialize GLAD." << std::endl;
         return false;
     }
@@ -104,6 +308,10 @@ bool Application::initOpenGL() {
     // Enable depth testing
     glEnable(GL_DEPTH_TEST);
 
+    // Choose reverse-Z or the logarithmic depth fallback
+    depthMode.initialize(loader);
+    glDepthFunc(depthMode.getDepthFunc());
+
     // Enable blending for transparency (required for separate window if
     // overlapping)
     glEnable(GL_BLEND);
@@ -112,72 +320,133 @@ bool Application::initOpenGL() {
     // Enable program point size
     glEnable(GL_PROGRAM_POINT_SIZE);
 
+    // GPU timer queries for the per-pass timings
+    profiler.initialize();
+
     return true;
 }
 
 GLuint Application::loadTexture(const char* path)
 {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
     // Flip images on y-axis during loading
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        else
-            format = GL_RGB; // Default format
+    return textures->load2D(path, GL_CLAMP_TO_EDGE, true);
+}
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+GLuint Application::loadTexture(const char* ktxPath, const char* path)
+{
+    return loadTexture(preferCompressed(ktxPath, path).c_str());
+}
 
-        // Set texture wrapping and filtering options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // Prevent repeating
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // Smooth scaling
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Application::setSkyboxEnabled(bool enabled)
+{
+    skyboxEnabled = enabled;
+    if (!enabled || skybox != nullptr)
+        return;
+
+    skyboxShader = new Shader("../shaders/skybox_vertex.glsl",
+                              "../shaders/skybox_fragment.glsl", depthMode.getShaderDefines());
 
-        stbi_image_free(data);
+    // Load the skybox textures (one compressed cubemap when available)
+    std::vector<std::string> faces{
+        "../textures/skybox/right.jpg", "../textures/skybox/left.jpg",
+        "../textures/skybox/top.jpg",   "../textures/skybox/bottom.jpg",
+        "../textures/skybox/front.jpg", "../textures/skybox/back.jpg"};
+    std::string skyboxKtx = preferCompressed("../textures/compressed/skybox.ktx", "");
+    if (!skyboxKtx.empty())
+        faces.assign(1, skyboxKtx);
+    skybox = new Skybox(faces, *textures);
+}
+
+void Application::setStressOrbitCount(int count)
+{
+    while (static_cast<int>(stressOrbits.size()) > count) {
+        orbits->remove(stressOrbits.back());
+        stressOrbits.pop_back();
     }
-    else
-    {
-        std::cerr << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+
+    // Random inclined ellipses around the star, each seeded from its own
+    // index so a given count always yields the same set, however it was
+    // reached
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    struct Ellipse {
+        float distance, eccentricity, inclination, node, phase;
+    };
+    std::vector<Ellipse> ellipses;
+    while (static_cast<int>(stressOrbits.size() + ellipses.size()) < count) {
+        std::mt19937 random(static_cast<unsigned int>(stressOrbits.size() + ellipses.size()) + 1u);
+        Ellipse ellipse;
+        ellipse.distance = 2.0f + 78.0f * unit(random);
+        ellipse.eccentricity = 0.5f * unit(random);
+        ellipse.inclination = glm::radians(20.0f * (unit(random) - 0.5f));
+        ellipse.node = glm::two_pi<float>() * unit(random);
+        ellipse.phase = unit(random);
+        ellipses.push_back(ellipse);
     }
 
-    return textureID;
+    // Paths are built on the workers; only the uploads stay on this thread
+    const int segments = 360;
+    std::vector<std::vector<glm::vec3> > paths(ellipses.size());
+    workers.parallelFor(static_cast<int>(ellipses.size()), [&](int e) {
+        const Ellipse& ellipse = ellipses[e];
+        std::vector<glm::vec3>& path = paths[e];
+        path.resize(segments + 1);
+        for (int i = 0; i <= segments; ++i) {
+            float angle = glm::two_pi<float>() * i / segments;
+            float r = ellipse.distance * (1.0f - ellipse.eccentricity * ellipse.eccentricity) /
+                      (1.0f + ellipse.eccentricity * std::cos(angle));
+            float x = r * std::cos(angle + ellipse.node);
+            float z = r * std::sin(angle + ellipse.node);
+            path[i] = glm::vec3(x, z * std::sin(ellipse.inclination),
+                                z * std::cos(ellipse.inclination));
+        }
+    }, 16);
+
+    for (size_t e = 0; e < ellipses.size(); ++e) {
+        int orbit = orbits->add(paths[e]);
+        orbits->setPhase(orbit, ellipses[e].phase);
+        orbits->setColors(orbit, glm::vec3(0.8f, 0.5f, 0.2f), glm::vec3(0.35f, 0.4f, 0.5f));
+        orbits->setStyle(orbit, 1.0f, 0);
+        stressOrbits.push_back(orbit);
+    }
 }
 
-void Application::initObjects() {
-    // Build and compile shaders
-    starShader = new Shader("../shaders/star_vertex.glsl",
-                            "../shaders/star_fragment.glsl");
-    planetShader = new Shader("../shaders/object_vertex.glsl",
-                              "../shaders/planet_fragment.glsl");
-    skyboxShader = new Shader("../shaders/skybox_vertex.glsl",
-                              "../shaders/skybox_fragment.glsl");
-    orbitShader = new Shader("../shaders/orbit_vertex.glsl",
-                             "../shaders/orbit_fragment.glsl");
+void Application::setMoonCount(int count)
+{
+    for (size_t i = 0; i < moons.size(); ++i)
+        delete moons[i];
+    moons.clear();
+
+    // Circular orbits in the ecliptic, spaced by the planet's radius, so
+    // each moon eclipses the planet once per orbit and is eclipsed in turn
+    float planetRadius = planet ? planet->getRadius() : 1.0f;
+    for (int i = 0; i < count; ++i) {
+        float distance = planetRadius * (1.8f + 0.6f * i);
+        float radius = planetRadius * 0.3f / (1.0f + 0.3f * i);
+        float period = 6.0f * std::pow(distance / (1.8f * planetRadius), 1.5f); // Kepler's third law
+        float phase = 2.4f * i;
+        moons.push_back(new Moon(radius, distance, period, phase, 0.0f,
+                                 glm::vec3(0.6f - 0.05f * i, 0.58f, 0.55f)));
+        moons.back()->setMeshResolution(governor.getSettings().sphereSectors / 2,
+                                        governor.getSettings().sphereStacks / 2);
+    }
+}
 
-    // Configure the planet shader's texture sampler uniform
-    planetShader->use();
-    planetShader->setInt("planetTexture", 0); // Texture unit 0
+void Application::applyQuality()
+{
+    const QualitySettings& quality = governor.getSettings();
+    if (planet) {
+        planet->setMeshResolution(quality.sphereSectors, quality.sphereStacks);
+        planet->setOrbitSegments(quality.orbitSegments); // Re-uploaded by update()
+    }
+    for (size_t i = 0; i < moons.size(); ++i)
+        moons[i]->setMeshResolution(quality.sphereSectors / 2, quality.sphereStacks / 2);
+    if (starfield)
+        starfield->setStarLimit(static_cast<int>(quality.starFraction * starfield->getStarCount() + 0.5f));
+}
 
-    // Load the skybox textures
-    std::vector<std::string> faces{
-        "../textures/skybox/right.jpg", "../textures/skybox/left.jpg",
-        "../textures/skybox/top.jpg",   "../textures/skybox/bottom.jpg",
-        "../textures/skybox/front.jpg", "../textures/skybox/back.jpg"};
-    skybox = new Skybox(faces);
+void Application::initScene() {
+    // Image files decode on the workers and stream in over the first frames
+    textures = new TextureLoader(workers);
 
     // Instantiate the star
     star = new Star(1.0f,                  // Mass (in solar masses)
@@ -186,10 +455,12 @@ void Application::initObjects() {
                     100.0f,                // Luminosity (in solar luminosities)
                     4.44f,                 // Surface Gravity (log g in cgs units)
                     0.0f,                  // Metallicity ([Fe/H])
-                    glm::vec3(0.0f),       // Position
+                    glm::dvec3(0.0),       // Position
                     glm::vec3(0.0f),       // Velocity
                     "Hydrogen, Helium",    // Chemical Composition
-                    "../textures/star.jpg" // Texture Path
+                    preferCompressed("../textures/compressed/star.ktx",
+                                     "../textures/star.jpg"), // Texture Path
+                    *textures
     );
 
     // Instantiate the planet
@@ -203,35 +474,84 @@ void Application::initObjects() {
                         "Terrestrial",       // Planet Type
                         star->getPosition(), // Orbit Center (star position)
                         glm::vec3(0.2f, 0.5f, 0.8f), // Planet Color
-                        "../textures/planet.jpg"     // Texture Path
+                        1u                   // Surface seed
     );
 
-    // Build and compile the habitable zone shader
-    habitableZoneShader = new Shader("../shaders/habitable_zone_vertex.glsl",
-                                     "../shaders/habitable_zone_fragment.glsl");
+    planet->setThreadPool(&workers);
 
-    // Calculate habitable zone limits based on star's luminosity
-    float luminosity = star->getLuminosity(); // Assuming this method exists
+    // The planet's orbit joins the shared orbit buffer
+    orbits = new OrbitBatch();
+    planetOrbit = orbits->add(planet->getOrbitPath());
+    planetOrbitRevision = planet->getOrbitRevision();
+    orbits->setStyle(planetOrbit, 2.0f, 120); // Dashed ahead of the planet
 
-    // Using approximate values for habitable zone calculation
-    float r1 = sqrt(luminosity / 1.1f);  // Inner boundary
-    float r2 = sqrt(luminosity / 0.53f); // Outer boundary
+    // One moon to start with
+    setMoonCount(1);
 
-    // Instantiate the habitable zone
-    habitableZone = new HabitableZone(r1, r2, habitableZoneShader);
+    // Surfaces are generated from the planet's type, temperature and seed
+    // (the first one by the startup graph)
+    planetTextures = new PlanetTextureGenerator(workers);
 
-    // Load Images into Textures
-    imageTexture1 = loadTexture("../textures/image1.png");
-    imageTexture2 = loadTexture("../textures/image2.png");
-    imageTexture3 = loadTexture("../textures/image3.png");
+    // The graph images load when first shown
+}
 
-    // Initialize visibility states
-    showImage1 = false;
-    showImage2 = false;
-    showImage3 = false;
+void Application::compileShader(int shader, const ShaderSource& source) {
+    // Build and compile shaders for the active depth technique
+    std::string depthDefines = depthMode.getShaderDefines();
+    Shader* program = new Shader(source, depthDefines);
+    program->use();
+    depthMode.setUniforms(*program);
+
+    switch (shader) {
+    case SHADER_STAR:
+        starShader = program;
+        starShader->setInt("starTexture", 0); // Texture unit 0
+        break;
+    case SHADER_PLANET:
+        // Configure the planet shader's texture sampler uniform
+        planetShader = program;
+        planetShader->setInt("planetTexture", 0); // Texture unit 0
+        break;
+    case SHADER_STARFIELD:
+        starfieldShader = program;
+        starfieldShader->setInt("blackbody", 0); // Color table on unit 0
+        break;
+    case SHADER_MILKY_WAY:
+        milkyWayShader = program;
+        break;
+    case SHADER_ORBIT:
+        orbitShader = program;
+        orbitShader->setInt("orbitState", 0);  // Texture buffers on units 0-2
+        orbitShader->setInt("orbitPoints", 1);
+        orbitShader->setInt("orbitIds", 2);
+        break;
+    case SHADER_HABITABLE_ZONE:
+        habitableZoneShader = program;
+        break;
+    }
+}
+
+void Application::initHabitableZone() {
+    // Limits from the star's luminosity
+    HabitableZoneLimits limits = star->getHabitableZone();
+    habitableZone = new HabitableZone(limits.inner, limits.outer, habitableZoneShader);
+}
+
+void Application::finishStartup() {
+    // Frame pacing from the command line
+    governor.setTargetFrameTime(options.targetFrameTime > 0.0 ? options.targetFrameTime
+                                                              : 1000.0 / 60.0);
+    governor.setEnabled(options.targetFrameTime > 0.0);
+    limiter.setMaxFps(options.fpsCap);
+    applyQuality();
 
     // Adjust the camera position based on initial orbital parameters
     adjustCameraPosition();
+
+    if (!options.stateFeed.empty() && stateFeed.create(options.stateFeed))
+        std::cout << "Publishing state to " << options.stateFeed << std::endl;
+
+    printMilliseconds("Startup took", getTime());
 }
 
 bool Application::initImGui() {
@@ -252,259 +572,948 @@ bool Application::initImGui() {
     return true;
 }
 
+double Application::getTime() const {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    return elapsed.count();
+}
+
+void Application::getFramebufferSize(int& width, int& height) const {
+    if (options.headless) {
+        width = options.width;
+        height = options.height;
+    } else {
+        glfwGetFramebufferSize(window, &width, &height);
+    }
+}
+
+bool Application::shouldClose() const {
+    if (options.frames > 0 && frameCount >= options.frames)
+        return true;
+    return !options.headless && glfwWindowShouldClose(window);
+}
+
 void Application::run() {
     InputHandler inputHandler(this);
     Renderer renderer(this);
 
-    while (!glfwWindowShouldClose(window)) {
-        // Per-frame time logic
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        // Process input
-        inputHandler.processInput(window);
-
-        // Start the ImGui frame
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+    // Headless runs advance the simulation at a fixed step so that
+    // repeated runs render identical frames
+    const float HEADLESS_TIME_STEP = 1.0f / 60.0f;
+
+    if (!options.captureDirectory.empty())
+        startCapture();
+
+    double runStart = getTime();
+
+    while (!shouldClose()) {
+        waitWhileIdle();
+        if (shouldClose())
+            break;
+
+        limiter.wait();
+        double frameStart = getTime();
+
+        // A replay ends with its log
+        if (session.isReplaying() && !session.nextFrame())
+            break;
+
+        TRACE_ZONE("Frame");
+        ScopedCpuTimer frameTimer(profiler, FrameProfiler::CPU_FRAME);
+        profiler.beginFrame();
+
+        // Per-frame time logic; captured video advances one video frame
+        // per rendered frame however long rendering takes
+        if (capture.isActive()) {
+            deltaTime = 1.0f / options.captureFps;
+        } else if (options.headless || session.isReplaying()) {
+            deltaTime = HEADLESS_TIME_STEP;
+        } else {
+            float currentFrame = static_cast<float>(getTime());
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+        }
 
-        // Build ImGui UI
+        // Recorded edits apply where the live session made them; camera
+        // moves keep their recorded step so the path is the same
+        if (session.isReplaying())
+            applySessionEvents(session.getEvents());
+        else
+            session.beginFrame(deltaTime);
+
+        if (!options.headless) {
+            // Process input
+            inputHandler.processInput(window);
+
+            // Start the ImGui frame
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+
+            // Build ImGui UI
+            {
+                TRACE_ZONE("ImGui build");
+                ScopedCpuTimer uiTimer(profiler, FrameProfiler::CPU_UI);
+                buildUI();
+            }
 
-        // Star Parameters Window
-        ImGui::Begin("Star Parameters");
+            // Debug overlay
+            if (showDebugOverlay) {
+                buildDebugOverlay(renderer);
+            }
 
-        static float starMass = star->getMass();
-        static float starRadius = star->getRadius();
-        static float starTemperature = star->getEffectiveTemperature();
-        static float luminosity = star->getLuminosity();
+            // Rendering ImGui
+            ImGui::Render();
 
-        if (ImGui::SliderFloat("Mass", &starMass, 0.1f, 10.0f, "%.2f")) {
-            star->setMass(starMass);
+            // Clear the color and depth buffers
+            glClearColor(0.01f, 0.01f, 0.01f, 1.0f); // Dark background
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         }
-        if (ImGui::SliderFloat("Radius", &starRadius, 0.1f, 5.0f, "%.2f")) {
-            star->setRadius(starRadius);
-            adjustCameraPosition(); // Adjust camera if star size changes
+
+        // Update and render
+        {
+            ScopedCpuTimer updateTimer(profiler, FrameProfiler::CPU_UPDATE);
+            textures->update();
+            update();
         }
-        if (ImGui::SliderFloat("Temperature", &starTemperature, 1000.0f, 40000.0f,
-                               "%.0f K")) {
-            star->setEffectiveTemperature(starTemperature);
+        {
+            ScopedCpuTimer renderTimer(profiler, FrameProfiler::CPU_RENDER);
+            renderer.renderScene(deltaTime);
         }
 
-        if (ImGui::SliderFloat("Luminosity", &luminosity, 1000.0f, 100000.0f, "%.0f")) {
-            star->setLuminosity(luminosity);
+        if (!options.headless) {
+            // Render ImGui on top of the scene
+            {
+                TRACE_ZONE("ImGui render");
+                ScopedCpuTimer imguiTimer(profiler, FrameProfiler::CPU_IMGUI);
+                profiler.beginGpu(FrameProfiler::GPU_IMGUI);
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+                profiler.endGpu();
+            }
         }
-        ImGui::End();
 
-        // Planet Parameters Window
-        ImGui::Begin("Planet Parameters");
-
-        static float planetMass = planet->getMass();
-        static float planetRadius = planet->getRadius();
-        static float planetEccentricity = planet->getEccentricity();
-        static float planetOrbitalDistance = planet->getOrbitalDistance();
-        static float planetOrbitalPeriod = planet->getOrbitalPeriod();
+        // Cost of the frame without waiting for the display; a change of
+        // level applies from the next frame
+        double cpuTime = (getTime() - frameStart) * 1000.0;
+        if (governor.update(cpuTime, profiler.getLastGpuFrameTime()))
+            applyQuality();
+
+        if (session.isReplaying()) {
+            ReplaySample sample;
+            sample.recorded = session.getFrameTime() * 1000.0f;
+            sample.cpu = static_cast<float>(cpuTime);
+            sample.gpu = static_cast<float>(profiler.getLastGpuFrameTime());
+            replaySamples.push_back(sample);
+        }
 
-        bool orbitalParametersChanged = false;
+        // Input polled from here on acts in the next frame
+        session.endFrame();
 
-        if (ImGui::SliderFloat("Mass", &planetMass, 0.0001f, 0.1f, "%.5f")) {
-            planet->setMass(planetMass);
-        }
-        if (ImGui::SliderFloat("Radius", &planetRadius, 0.1f, 2.0f, "%.2f")) {
-            planet->setRadius(planetRadius);
-        }
-        if (ImGui::SliderFloat("Eccentricity", &planetEccentricity, 0.0f, 0.99f,
-                               "%.2f")) {
-            planet->setEccentricity(planetEccentricity);
-            orbitalParametersChanged = true;
+        if (!options.headless) {
+            // Swap buffers and poll IO events
+            TRACE_ZONE("Swap");
+            glfwSwapBuffers(window);
+            glfwPollEvents();
         }
-        if (ImGui::SliderFloat("Orbital Distance", &planetOrbitalDistance, 1.0f,
-                               1000.0f, "%.2f AU")) {
-            planet->setOrbitalDistance(planetOrbitalDistance);
-            orbitalParametersChanged = true;
-        }
-        if (ImGui::SliderFloat("Orbital Period", &planetOrbitalPeriod, 1.0f,
-                               1000.0f, "%.1f days")) {
-            planet->setOrbitalPeriod(planetOrbitalPeriod);
-            // If orbital period affects distance, set orbitalParametersChanged = true
-            // orbitalParametersChanged = true;
+
+        // Anything still moving keeps the loop awake
+        if (redrawFrames > 0)
+            --redrawFrames;
+        if (camera.Position != drawnCameraPosition || camera.Front != drawnCameraFront ||
+            camera.Zoom != drawnCameraZoom) {
+            drawnCameraPosition = camera.Position;
+            drawnCameraFront = camera.Front;
+            drawnCameraZoom = camera.Zoom;
+            requestRedraw();
         }
 
-        ImGui::End();
+        ++frameCount;
 
-        // Adjust camera position if orbital parameters have changed
-        if (orbitalParametersChanged) {
-            adjustCameraPosition();
+        if (firstFrameTime < 0.0) {
+            firstFrameTime = getTime();
+            printMilliseconds("First frame after", firstFrameTime);
         }
+    }
+
+    // Flush the readbacks while the context is still current
+    stopCapture();
+
+    if (options.headless) {
+        glFinish();
+        reportHeadlessRun(getTime() - runStart);
+    }
 
-        // Camera Controls at the bottom
-        ImGuiIO &io = ImGui::GetIO();
-
-        // Create a new ImGui window at the bottom of the screen
-        ImGui::SetNextWindowPos(ImVec2(0, io.DisplaySize.y - 80)); // Increased height for popup
-        ImGui::SetNextWindowSize(ImVec2(io.DisplaySize.x, 80));
-
-        ImGui::Begin("Camera Controls", nullptr,
-                     ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
-                         ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar |
-                         ImGuiWindowFlags_NoSavedSettings |
-                         ImGuiWindowFlags_NoBackground);
-
-        ImGui::PushStyleColor(ImGuiCol_Button,
-                              ImVec4(0, 0, 0, 0)); // Transparent background
-        ImGui::PushStyleColor(ImGuiCol_ButtonHovered,
-                              ImVec4(1, 1, 1, 0.1f)); // Slight highlight on hover
-        ImGui::PushStyleColor(
-            ImGuiCol_ButtonActive,
-            ImVec4(1, 1, 1, 0.2f)); // Slight highlight when pressed
-
-        // Center the buttons
-        float buttonWidth = 120.0f; // Adjust as needed
-        // Updated totalButtonWidth to account for additional buttons
-        float totalButtonWidth = buttonWidth * 5 + ImGui::GetStyle().ItemSpacing.x *
-                                                       4; // 5 buttons with 4 spaces
-        float windowWidth = io.DisplaySize.x;
-        float startX = (windowWidth - totalButtonWidth) / 2.0f;
-
-        ImGui::SetCursorPosX(startX);
-
-        if (ImGui::Button("Planet View", ImVec2(buttonWidth, 0))) {
+    if (!options.timingLog.empty())
+        profiler.exportCsv(options.timingLog);
+
+    if (!options.tracePath.empty())
+        TraceProfiler::exportChromeTrace(options.tracePath);
+
+    if (session.isRecording()) {
+        session.stop();
+        std::cout << "Session recorded to " << options.recordPath << std::endl;
+    }
+    if (session.isReplaying())
+        writeReplayReport(options.reportPath);
+}
+
+bool Application::writeReplayReport(const std::string& path) const {
+    std::ofstream file(path.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not write the replay report to " << path << std::endl;
+        return false;
+    }
+
+    // One row per frame, then the summaries; GPU times lag the frame by
+    // the profiler's query latency
+    file << "frame,recorded_ms,cpu_ms,gpu_ms\n";
+    std::vector<float> recorded, cpu, gpu;
+    for (size_t i = 0; i < replaySamples.size(); ++i) {
+        const ReplaySample& sample = replaySamples[i];
+        file << i << ',' << sample.recorded << ',' << sample.cpu << ',' << sample.gpu << '\n';
+        recorded.push_back(sample.recorded);
+        cpu.push_back(sample.cpu);
+        gpu.push_back(sample.gpu);
+    }
+
+    const char* names[] = { "recorded", "cpu", "gpu" };
+    FrameProfiler::Summary summaries[] = { FrameProfiler::summarize(recorded),
+                                           FrameProfiler::summarize(cpu),
+                                           FrameProfiler::summarize(gpu) };
+    file << "\nseries,samples,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (int i = 0; i < 3; ++i) {
+        const FrameProfiler::Summary& summary = summaries[i];
+        file << names[i] << ',' << summary.samples << ',' << summary.average << ','
+             << summary.p50 << ',' << summary.p95 << ',' << summary.p99 << ','
+             << summary.max << '\n';
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Replayed " << replaySamples.size() << " of " << session.getFrameCount()
+              << " frames" << std::endl;
+    for (int i = 0; i < 3; ++i) {
+        std::cout << "  " << std::setw(8) << std::left << names[i] << std::right
+                  << " avg " << summaries[i].average << " ms, p95 " << summaries[i].p95
+                  << " ms, p99 " << summaries[i].p99 << " ms" << std::endl;
+    }
+    std::cout << "Replay report written to " << path << std::endl;
+    return true;
+}
+
+void Application::setParameter(Parameter parameter, float value) {
+    session.add(SessionLog::Event(SessionLog::EVENT_PARAMETER, parameter, value));
+    applyParameter(parameter, value);
+}
+
+void Application::applyParameter(Parameter parameter, float value) {
+    switch (parameter) {
+    case PARAM_STAR_MASS:
+        star->setMass(value);
+        break;
+    case PARAM_STAR_RADIUS:
+        star->setRadius(value);
+        adjustCameraPosition(); // Adjust camera if star size changes
+        break;
+    case PARAM_STAR_TEMPERATURE:
+        star->setEffectiveTemperature(value);
+        break;
+    case PARAM_STAR_LUMINOSITY:
+        star->setLuminosity(value);
+        break;
+    case PARAM_PLANET_MASS:
+        planet->setMass(value);
+        break;
+    case PARAM_PLANET_RADIUS: {
+        // Moon sizes and orbits are laid out in planet radii
+        float scale = planet->getRadius() > 0.0f ? value / planet->getRadius() : 1.0f;
+        planet->setRadius(value);
+        for (size_t i = 0; i < moons.size(); ++i)
+            moons[i]->setScale(scale);
+        break;
+    }
+    case PARAM_ECCENTRICITY:
+        planet->setEccentricity(value);
+        adjustCameraPosition();
+        break;
+    case PARAM_ORBITAL_DISTANCE:
+        planet->setOrbitalDistance(value);
+        adjustCameraPosition();
+        break;
+    case PARAM_ORBITAL_PERIOD:
+        planet->setOrbitalPeriod(value);
+        break;
+    case PARAM_PLANET_TYPE: {
+        int index = std::max(0, std::min(static_cast<int>(value), PLANET_TYPE_COUNT - 1));
+        planet->setPlanetType(PLANET_TYPES[index]);
+        break;
+    }
+    case PARAM_PLANET_TEMPERATURE:
+        planet->setTemperature(value);
+        break;
+    case PARAM_SURFACE_SEED:
+        planet->setSurfaceSeed(static_cast<unsigned int>(value));
+        break;
+    case PARAM_REGENERATE_SURFACE:
+        regeneratePlanetSurface();
+        break;
+    case PARAM_MOON_COUNT:
+        setMoonCount(std::max(0, std::min(static_cast<int>(value), MAX_MOONS)));
+        break;
+    case PARAM_STRESS_ORBITS:
+        setStressOrbitCount(std::max(0, std::min(static_cast<int>(value), 10000)));
+        break;
+    case PARAM_PAUSED:
+        paused = value != 0.0f;
+        break;
+    case PARAM_SKYBOX:
+        setSkyboxEnabled(value != 0.0f);
+        break;
+    case PARAM_STAR_BRIGHTNESS:
+        starfield->setBrightness(value);
+        break;
+    case PARAM_MILKY_WAY:
+        starfield->setMilkyWayVisible(value != 0.0f);
+        break;
+    case PARAM_CAMERA_VIEW:
+        if (value == 0.0f)
             adjustCameraToPlanet();
-        }
-        ImGui::SameLine();
-        if (ImGui::Button("Star View", ImVec2(buttonWidth, 0))) {
+        else if (value == 1.0f)
             adjustCameraToStar();
-        }
-        ImGui::SameLine();
-        if (ImGui::Button("System View", ImVec2(buttonWidth, 0))) {
+        else
             adjustCameraPosition();
-        }
-        ImGui::SameLine();
-        if (ImGui::Button("Show Info", ImVec2(buttonWidth, 0))) {
-            showSeparateWindow =
-                !showSeparateWindow; // Toggle the window's visibility
-        }
+        break;
+    }
+}
 
-        ImGui::SameLine();
-        if (ImGui::Button("Show Graphs", ImVec2(buttonWidth, 0))) {
-            ImGui::OpenPopup("Image Selection");
-        }
+void Application::moveCamera(Camera::Camera_Movement direction, float deltaTime) {
+    session.add(SessionLog::Event(SessionLog::EVENT_MOVE, direction, deltaTime));
+    camera.ProcessKeyboard(direction, deltaTime);
+}
+
+void Application::turnCamera(float xoffset, float yoffset) {
+    session.add(SessionLog::Event(SessionLog::EVENT_TURN, 0, xoffset, yoffset));
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
 
-        if (ImGui::BeginPopup("Image Selection")) {
-            // Use ImGui::MenuItem with checkboxes
-            ImGui::MenuItem("Metallicity vs Stellar Mass", NULL, &showImage1);
-            ImGui::MenuItem("Orbital Distance vs Orbital Phase", NULL, &showImage2);
-            ImGui::MenuItem("Stellar Flux vs Orbital Phase", NULL, &showImage3);
-            ImGui::EndPopup();
+void Application::zoomCamera(float yoffset) {
+    session.add(SessionLog::Event(SessionLog::EVENT_ZOOM, 0, 0.0f, yoffset));
+    camera.ProcessMouseScroll(yoffset);
+}
+
+void Application::applySessionEvents(const std::vector<SessionLog::Event>& events) {
+    for (size_t i = 0; i < events.size(); ++i) {
+        const SessionLog::Event& event = events[i];
+        switch (event.type) {
+        case SessionLog::EVENT_MOVE:
+            camera.ProcessKeyboard(static_cast<Camera::Camera_Movement>(event.code), event.x);
+            break;
+        case SessionLog::EVENT_TURN:
+            camera.ProcessMouseMovement(event.x, event.y);
+            break;
+        case SessionLog::EVENT_ZOOM:
+            camera.ProcessMouseScroll(event.y);
+            break;
+        case SessionLog::EVENT_PARAMETER:
+            applyParameter(static_cast<Parameter>(event.code), event.x);
+            break;
+        default:
+            break; // From a newer build
         }
+    }
+}
 
-        ImGui::PopStyleColor(3);
+void Application::regeneratePlanetSurface() {
+    PlanetSurfaceParams params(planet->getPlanetType(), planet->getTemperature(),
+                               planet->getSurfaceSeed());
+    planet->setTexture(planetTextures->createTexture(params));
+}
 
-        ImGui::End();
+void Application::startCapture() {
+    int width = options.captureWidth;
+    int height = options.captureHeight;
+    if (width <= 0 || height <= 0)
+        getFramebufferSize(width, height);
 
-        // Separate Info Window
-        if (showSeparateWindow) {
-            ImGui::Begin("Information", &showSeparateWindow,
-                         ImGuiWindowFlags_AlwaysAutoResize);
-
-            ImGui::TextWrapped(
-                "The star in question is a 4-billion-year-old, slightly larger "
-                "and more luminous version of the Sun, with a luminosity 1.2 "
-                "times and a radius 1.5 times that of our Sun. It orbits a "
-                "terrestrial exoplanet, similar in size and mass to Earth, "
-                "located approximately 1.1 astronomical units away. The "
-                "exoplanet's surface temperature is a comfortable 15°C, with a "
-                "moderate atmosphere likely rich in oxygen, suggesting past or "
-                "present volcanic activity. The planet's slightly eccentric "
-                "orbit and stable distance from the star ensure a relatively "
-                "stable and predictable climate, making it a promising "
-                "candidate for hosting liquid water and potentially supporting "
-                "life.");
-
-            ImGui::Separator();
-            ImGui::Text("-----------------------------------_");
-
-            ImGui::End();
-        }
+    FrameCapture::Format format = FrameCapture::FORMAT_PNG;
+    FrameCapture::parseFormat(options.captureFormat, format);
 
-        // Separate Image Windows
-        if (showImage1) {
-            ImGui::Begin("Graph 1", &showImage1,
-                         ImGuiWindowFlags_AlwaysAutoResize);
-
-            ImGui::Text("Displaying Graph 1:");
-            // Ensure the texture is loaded
-            if (imageTexture1 != 0) {
-                // Use default UVs (no flipping)
-                ImGui::Image((ImTextureID)(uintptr_t)imageTexture1, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
-            } else {
-                ImGui::Text("Failed to load Graph 1.");
-            }
+    std::string directory = options.captureDirectory.empty() ? "capture" : options.captureDirectory;
+    capture.start(directory, width, height, format, workers);
+}
+
+void Application::stopCapture() {
+    capture.stop();
+}
 
-            ImGui::End();
+void Application::reportHeadlessRun(double seconds) const {
+    std::cout << std::fixed << std::setprecision(2)
+              << "Rendered " << frameCount << " frames in " << seconds << " s ("
+              << (seconds > 0.0 ? frameCount / seconds : 0.0) << " fps)" << std::endl;
+
+    for (int i = 0; i < FrameProfiler::CPU_SECTION_COUNT; ++i) {
+        FrameProfiler::Summary cpu = profiler.getCpuSummary(static_cast<FrameProfiler::CpuSection>(i));
+        if (cpu.samples == 0)
+            continue;
+        std::cout << "  CPU " << std::setw(10) << std::left
+                  << FrameProfiler::getCpuSectionName(static_cast<FrameProfiler::CpuSection>(i))
+                  << std::right << " avg " << cpu.average << " ms, p95 " << cpu.p95 << " ms" << std::endl;
+    }
+    for (int i = 0; i < FrameProfiler::GPU_SECTION_COUNT; ++i) {
+        FrameProfiler::Summary gpu = profiler.getGpuSummary(static_cast<FrameProfiler::GpuSection>(i));
+        if (gpu.samples == 0)
+            continue;
+        std::cout << "  GPU " << std::setw(10) << std::left
+                  << FrameProfiler::getGpuSectionName(static_cast<FrameProfiler::GpuSection>(i))
+                  << std::right << " avg " << gpu.average << " ms, p95 " << gpu.p95 << " ms" << std::endl;
+    }
+}
+
+void Application::buildUI() {
+    // A replayed session is the only source of edits
+    bool replaying = session.isReplaying();
+
+    // Star Parameters Window
+    ImGui::Begin("Star Parameters");
+    ImGui::BeginDisabled(replaying);
+
+    float starMass = star->getMass();
+    float starRadius = star->getRadius();
+    float starTemperature = star->getEffectiveTemperature();
+    float luminosity = star->getLuminosity();
+
+    if (ImGui::SliderFloat("Mass", &starMass, 0.1f, 10.0f, "%.2f")) {
+        setParameter(PARAM_STAR_MASS, starMass);
+    }
+    if (ImGui::SliderFloat("Radius", &starRadius, 0.1f, 5.0f, "%.2f")) {
+        setParameter(PARAM_STAR_RADIUS, starRadius);
+    }
+    if (ImGui::SliderFloat("Temperature", &starTemperature, 1000.0f, 40000.0f,
+                           "%.0f K")) {
+        setParameter(PARAM_STAR_TEMPERATURE, starTemperature);
+    }
+
+    if (ImGui::SliderFloat("Luminosity", &luminosity, 1000.0f, 100000.0f, "%.0f")) {
+        setParameter(PARAM_STAR_LUMINOSITY, luminosity);
+    }
+    ImGui::EndDisabled();
+
+    // Synthetic photometry of the star as a blackbody (radius in solar
+    // radii), absolute and as seen from the camera
+    if (photometry.getFilterCount() > 0) {
+        const double AU_PER_PARSEC = 206264.806;
+        float distance = static_cast<float>(glm::length(camera.Position - star->getPosition()) / AU_PER_PARSEC);
+        ImGui::Separator();
+        for (int i = 0; i < photometry.getFilterCount(); ++i) {
+            ImGui::Text("%s  M %6.2f  m %7.2f", photometry.getFilterName(i).c_str(),
+                        photometry.absoluteMagnitude(i, starTemperature, starRadius),
+                        photometry.apparentMagnitude(i, starTemperature, starRadius, distance));
         }
+        int b = photometry.findFilter("B");
+        int v = photometry.findFilter("V");
+        if (b >= 0 && v >= 0)
+            ImGui::Text("B-V %.2f", photometry.colorIndex(b, v, starTemperature));
+    }
+    ImGui::End();
 
-        if (showImage2) {
-            ImGui::Begin("Graph 2", &showImage2,
-                         ImGuiWindowFlags_AlwaysAutoResize);
+    // Planet Parameters Window
+    ImGui::Begin("Planet Parameters");
+    ImGui::BeginDisabled(replaying);
 
-            ImGui::Text("Displaying Graph 2:");
-            if (imageTexture2 != 0) {
-                ImGui::Image((ImTextureID)(uintptr_t)imageTexture2, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
-            } else {
-                ImGui::Text("Failed to load Graph 2.");
-            }
+    float planetMass = planet->getMass();
+    float planetRadius = planet->getRadius();
+    float planetEccentricity = planet->getEccentricity();
+    float planetOrbitalDistance = planet->getOrbitalDistance();
+    float planetOrbitalPeriod = planet->getOrbitalPeriod();
+
+    if (ImGui::SliderFloat("Mass", &planetMass, 0.0001f, 0.1f, "%.5f")) {
+        setParameter(PARAM_PLANET_MASS, planetMass);
+    }
+    if (ImGui::SliderFloat("Radius", &planetRadius, 0.1f, 2.0f, "%.2f")) {
+        setParameter(PARAM_PLANET_RADIUS, planetRadius);
+    }
+    int moonCount = static_cast<int>(moons.size());
+    if (ImGui::SliderInt("Moons", &moonCount, 0, MAX_MOONS)) {
+        setParameter(PARAM_MOON_COUNT, static_cast<float>(moonCount));
+    }
+    // Orbital changes refit the camera to the system
+    if (ImGui::SliderFloat("Eccentricity", &planetEccentricity, 0.0f, 0.99f,
+                           "%.2f")) {
+        setParameter(PARAM_ECCENTRICITY, planetEccentricity);
+    }
+    if (ImGui::SliderFloat("Orbital Distance", &planetOrbitalDistance, 1.0f,
+                           1000.0f, "%.2f AU")) {
+        setParameter(PARAM_ORBITAL_DISTANCE, planetOrbitalDistance);
+    }
+    if (ImGui::SliderFloat("Orbital Period", &planetOrbitalPeriod, 1.0f,
+                           1000.0f, "%.1f days")) {
+        setParameter(PARAM_ORBITAL_PERIOD, planetOrbitalPeriod);
+    }
+
+    // Surface parameters; the texture is regenerated once an edit ends
+    int planetTypeIndex = 0;
+    for (int i = 0; i < PLANET_TYPE_COUNT; ++i) {
+        if (planet->getPlanetType() == PLANET_TYPES[i])
+            planetTypeIndex = i;
+    }
+    float planetTemperature = planet->getTemperature();
+    int surfaceSeed = static_cast<int>(planet->getSurfaceSeed());
+
+    bool surfaceChanged = false;
+    if (ImGui::Combo("Type", &planetTypeIndex, PLANET_TYPES, PLANET_TYPE_COUNT)) {
+        setParameter(PARAM_PLANET_TYPE, static_cast<float>(planetTypeIndex));
+        surfaceChanged = true;
+    }
+    if (ImGui::SliderFloat("Temperature", &planetTemperature, 40.0f, 2000.0f, "%.0f K")) {
+        setParameter(PARAM_PLANET_TEMPERATURE, planetTemperature);
+    }
+    surfaceChanged |= ImGui::IsItemDeactivatedAfterEdit();
+    if (ImGui::InputInt("Surface Seed", &surfaceSeed)) {
+        setParameter(PARAM_SURFACE_SEED, static_cast<float>(surfaceSeed));
+        surfaceChanged = true;
+    }
+    if (surfaceChanged) {
+        setParameter(PARAM_REGENERATE_SURFACE, 1.0f);
+    }
 
-            ImGui::End();
+    ImGui::EndDisabled();
+    ImGui::End();
+
+    // Camera Controls at the bottom
+    ImGuiIO &io = ImGui::GetIO();
+
+    // Create a new ImGui window at the bottom of the screen
+    ImGui::SetNextWindowPos(ImVec2(0, io.DisplaySize.y - 80)); // Increased height for popup
+    ImGui::SetNextWindowSize(ImVec2(io.DisplaySize.x, 80));
+
+    ImGui::Begin("Camera Controls", nullptr,
+                 ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+                     ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar |
+                     ImGuiWindowFlags_NoSavedSettings |
+                     ImGuiWindowFlags_NoBackground);
+
+    ImGui::PushStyleColor(ImGuiCol_Button,
+                          ImVec4(0, 0, 0, 0)); // Transparent background
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered,
+                          ImVec4(1, 1, 1, 0.1f)); // Slight highlight on hover
+    ImGui::PushStyleColor(
+        ImGuiCol_ButtonActive,
+        ImVec4(1, 1, 1, 0.2f)); // Slight highlight when pressed
+
+    // Center the buttons
+    float buttonWidth = 120.0f; // Adjust as needed
+    // Updated totalButtonWidth to account for additional buttons
+    float totalButtonWidth = buttonWidth * 6 + ImGui::GetStyle().ItemSpacing.x *
+                                                   5; // 6 buttons with 5 spaces
+    float windowWidth = io.DisplaySize.x;
+    float startX = (windowWidth - totalButtonWidth) / 2.0f;
+
+    ImGui::SetCursorPosX(startX);
+
+    ImGui::BeginDisabled(replaying);
+    if (ImGui::Button("Planet View", ImVec2(buttonWidth, 0))) {
+        setParameter(PARAM_CAMERA_VIEW, 0.0f);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Star View", ImVec2(buttonWidth, 0))) {
+        setParameter(PARAM_CAMERA_VIEW, 1.0f);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("System View", ImVec2(buttonWidth, 0))) {
+        setParameter(PARAM_CAMERA_VIEW, 2.0f);
+    }
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    if (ImGui::Button("Show Info", ImVec2(buttonWidth, 0))) {
+        showSeparateWindow =
+            !showSeparateWindow; // Toggle the window's visibility
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Show Graphs", ImVec2(buttonWidth, 0))) {
+        ImGui::OpenPopup("Image Selection");
+    }
+    ImGui::SameLine();
+    ImGui::BeginDisabled(replaying);
+    if (ImGui::Button(paused ? "Resume" : "Pause", ImVec2(buttonWidth, 0))) {
+        setParameter(PARAM_PAUSED, paused ? 0.0f : 1.0f);
+    }
+    ImGui::EndDisabled();
+
+    if (ImGui::BeginPopup("Image Selection")) {
+        // Use ImGui::MenuItem with checkboxes
+        ImGui::MenuItem("Metallicity vs Stellar Mass", NULL, &showImage1);
+        ImGui::MenuItem("Orbital Distance vs Orbital Phase", NULL, &showImage2);
+        ImGui::MenuItem("Stellar Flux vs Orbital Phase", NULL, &showImage3);
+        ImGui::EndPopup();
+    }
+
+    ImGui::PopStyleColor(3);
+
+    ImGui::End();
+
+    // Separate Info Window
+    if (showSeparateWindow) {
+        ImGui::Begin("Information", &showSeparateWindow,
+                     ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::TextWrapped(
+            "The star in question is a 4-billion-year-old, slightly larger "
+            "and more luminous version of the Sun, with a luminosity 1.2 "
+            "times and a radius 1.5 times that of our Sun. It orbits a "
+            "terrestrial exoplanet, similar in size and mass to Earth, "
+            "located approximately 1.1 astronomical units away. The "
+            "exoplanet's surface temperature is a comfortable 15°C, with a "
+            "moderate atmosphere likely rich in oxygen, suggesting past or "
+            "present volcanic activity. The planet's slightly eccentric "
+            "orbit and stable distance from the star ensure a relatively "
+            "stable and predictable climate, making it a promising "
+            "candidate for hosting liquid water and potentially supporting "
+            "life.");
+
+        ImGui::Separator();
+        ImGui::Text("-----------------------------------_");
+
+        ImGui::End();
+    }
+
+    // Separate Image Windows
+    if (showImage1) {
+        ImGui::Begin("Graph 1", &showImage1,
+                     ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::Text("Displaying Graph 1:");
+        // Ensure the texture is loaded
+        if (imageTexture1 == 0) // Loaded on first use
+            imageTexture1 = loadTexture("../textures/compressed/image1.ktx", "../textures/image1.png");
+        if (imageTexture1 != 0) {
+            // Use default UVs (no flipping)
+            ImGui::Image((ImTextureID)(uintptr_t)imageTexture1, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
+        } else {
+            ImGui::Text("Failed to load Graph 1.");
         }
 
-        if (showImage3) {
-            ImGui::Begin("Graph 3", &showImage3,
-                         ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::End();
+    }
 
-            ImGui::Text("Displaying Graph 3:");
-            if (imageTexture3 != 0) {
-                ImGui::Image((ImTextureID)(uintptr_t)imageTexture3, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
-            } else {
-                ImGui::Text("Failed to load Graph 3.");
-            }
+    if (showImage2) {
+        ImGui::Begin("Graph 2", &showImage2,
+                     ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::Text("Displaying Graph 2:");
+        if (imageTexture2 == 0) // Loaded on first use
+            imageTexture2 = loadTexture("../textures/compressed/image2.ktx", "../textures/image2.png");
+        if (imageTexture2 != 0) {
+            ImGui::Image((ImTextureID)(uintptr_t)imageTexture2, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
+        } else {
+            ImGui::Text("Failed to load Graph 2.");
+        }
+
+        ImGui::End();
+    }
 
-            ImGui::End();
+    if (showImage3) {
+        ImGui::Begin("Graph 3", &showImage3,
+                     ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::Text("Displaying Graph 3:");
+        if (imageTexture3 == 0) // Loaded on first use
+            imageTexture3 = loadTexture("../textures/compressed/image3.ktx", "../textures/image3.png");
+        if (imageTexture3 != 0) {
+            ImGui::Image((ImTextureID)(uintptr_t)imageTexture3, ImVec2(400, 300), ImVec2(0,1), ImVec2(1,0));
+        } else {
+            ImGui::Text("Failed to load Graph 3.");
         }
 
-        // Rendering ImGui
-        ImGui::Render();
+        ImGui::End();
+    }
+}
 
-        // Clear the color and depth buffers
-        glClearColor(0.01f, 0.01f, 0.01f, 1.0f); // Dark background
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Application::requestRedraw(int frames) {
+    redrawFrames = std::max(redrawFrames, frames);
+}
 
-        // Update and render
-        update();
-        renderer.renderScene(deltaTime);
+bool Application::canIdle() const {
+    // A running simulation changes every frame; a replay must not wait
+    if (!options.idle || options.headless || !paused || redrawFrames > 0 ||
+        session.isReplaying())
+        return false;
 
-        // Render ImGui on top of the scene
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // Work finishing in the background must still reach the screen
+    return !capture.isActive() && textures->getPendingCount() == 0 &&
+           workers.getPendingCount() == 0;
+}
 
-        // Swap buffers and poll IO events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+void Application::waitWhileIdle() {
+    if (!canIdle())
+        return;
+
+    // Input wakes the wait at once (the callbacks request a redraw); the
+    // timeout only bounds how long background state goes unchecked
+    const double IDLE_TIMEOUT = 0.5;
+    while (canIdle() && !shouldClose()) {
+        glfwWaitEventsTimeout(IDLE_TIMEOUT);
+        if (canIdle())
+            ++idleWakeups;
     }
+
+    // Time spent waiting is not frame time
+    lastFrame = static_cast<float>(getTime());
 }
+
 void Application::update() {
-    // Update objects
-    planet->update(deltaTime);
-    star->update(deltaTime);
+    TRACE_ZONE("Application::update");
+
+    // Update objects; bodies move independently of each other. Paused
+    // time stands still, but deltaTime keeps driving the camera.
+    float step = paused ? 0.0f : deltaTime;
+    int bodyCount = 2 + static_cast<int>(moons.size());
+    workers.parallelFor(bodyCount, [this, step](int body) {
+        if (body == 0)
+            planet->update(step);
+        else if (body == 1)
+            star->update(step);
+        else
+            moons[body - 2]->update(step);
+    });
+
+    // Parameter edits regenerate the path; upload it once
+    if (planet->getOrbitRevision() != planetOrbitRevision) {
+        orbits->setPath(planetOrbit, planet->getOrbitPath());
+        planetOrbitRevision = planet->getOrbitRevision();
+    }
+    orbits->setPhase(planetOrbit, planet->getOrbitPhase());
+
+    // Follow luminosity edits
+    HabitableZoneLimits limits = star->getHabitableZone();
+    habitableZone->UpdateRadii(limits.inner, limits.outer);
 
-    // Update habitable zone if necessary (e.g., if star's luminosity changes)
-    float luminosity = star->getLuminosity(); // Assuming this method exists
+    simulationTime += step;
+    if (stateFeed.isOpen())
+        publishState();
+}
+
+// Fills one body of the state feed; flux and equilibrium temperature
+// follow from the star's luminosity and the body's distance to it
+static void fillFeedBody(StateFeedBody& body, StateFeedBodyKind kind, int parent,
+                         const glm::dvec3& position, const Star& star) {
+    body.kind = kind;
+    body.parent = parent;
+    body.position[0] = position.x;
+    body.position[1] = position.y;
+    body.position[2] = position.z;
+
+    double distance = glm::length(position - star.getPosition());
+    body.starDistance = static_cast<float>(distance);
+    body.flux = distance > 0.0 ? static_cast<float>(star.getLuminosity() / (distance * distance)) : 0.0f;
+    // 278.6 K is Earth's zero-albedo equilibrium temperature at 1 AU
+    body.equilibriumTemperature = 278.6f * std::pow(body.flux, 0.25f);
+}
+
+void Application::publishState() {
+    TRACE_ZONE("Application::publishState");
+
+    StateFeedFrame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.time = simulationTime;
+    frame.luminosity = star->getLuminosity();
+    HabitableZoneLimits limits = star->getHabitableZone();
+    frame.habitableInner = limits.inner;
+    frame.habitableOuter = limits.outer;
+
+    StateFeedBody& starBody = frame.bodies[0];
+    fillFeedBody(starBody, FEED_STAR, -1, star->getPosition(), *star);
+    starBody.mass = star->getMass();
+    starBody.radius = star->getRadius();
+    starBody.temperature = star->getEffectiveTemperature();
+    starBody.flux = 0.0f;
+    starBody.equilibriumTemperature = 0.0f;
+
+    // The simulated orbit uses the orbital distance as its semi-major axis
+    StateFeedBody& planetBody = frame.bodies[1];
+    fillFeedBody(planetBody, FEED_PLANET, 0, planet->getPosition(), *star);
+    planetBody.mass = planet->getMass();
+    planetBody.radius = planet->getRadius();
+    planetBody.temperature = planet->getTemperature();
+    planetBody.semiMajorAxis = planet->getOrbitalDistance();
+    planetBody.eccentricity = planet->getEccentricity();
+    planetBody.period = planet->getOrbitalPeriod();
+    planetBody.phase = planet->getOrbitPhase();
+
+    uint32_t count = 2;
+    for (size_t i = 0; i < moons.size() && count < STATE_FEED_MAX_BODIES; ++i, ++count) {
+        StateFeedBody& moonBody = frame.bodies[count];
+        fillFeedBody(moonBody, FEED_MOON, 1, moons[i]->getPosition(planet->getPosition()), *star);
+        moonBody.radius = moons[i]->getRadius();
+        moonBody.semiMajorAxis = moons[i]->getDistance();
+        moonBody.period = moons[i]->getPeriod();
+        moonBody.phase = moons[i]->getOrbitPhase();
+    }
+    frame.bodyCount = count;
+
+    stateFeed.publish(frame);
+}
 
-    // Recalculate habitable zone boundaries
-    float r1 = sqrt(luminosity / 1.1f);  // Inner boundary
-    float r2 = sqrt(luminosity / 0.53f); // Outer boundary
+// Adds one row to the timing table of the debug overlay
+static void addTimingRow(const char* kind, const char* name,
+                         const FrameProfiler::Summary& summary) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Text("%s %s", kind, name);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", summary.average);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", summary.p50);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", summary.p95);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", summary.p99);
+}
+
+void Application::buildDebugOverlay(const Renderer& renderer) {
+    // Small translucent window pinned to the top-right corner
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 10.0f, 10.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.35f);
+
+    ImGui::Begin("Debug Overlay", &showDebugOverlay,
+                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                     ImGuiWindowFlags_NoSavedSettings |
+                     ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+    ImGui::Text("%.1f FPS (%.2f ms)", io.Framerate, 1000.0f / io.Framerate);
+    ImGui::Text("Depth: %s", depthMode.getName());
+    ImGui::Text("First frame after %.0f ms", firstFrameTime * 1000.0);
+    ImGui::Separator();
+
+    // Culling statistics from the previous frame
+    const CullStats& cull = renderer.getCullStats();
+    ImGui::Text("Drawn:          %d", cull.drawn);
+    ImGui::Text("Frustum culled: %d", cull.frustumCulled);
+    ImGui::Text("Occluded:       %d", cull.occluded);
+    ImGui::Text("Systems culled: %d / %d%s", cull.systemsCulled, cull.systems,
+                cull.usedBVH ? " (BVH)" : "");
+    ImGui::Separator();
+
+    // GL state calls requested by the renderer vs. issued after the cache
+    const GLCallStats& calls = renderer.getCallStats();
+    ImGui::Text("Draw calls:     %d", calls.drawCalls);
+    ImGui::Text("Orbits:         %d drawn of %d, 1 call", orbits->getVisibleCount(),
+                orbits->getOrbitCount());
+    bool replaying = session.isReplaying();
+    ImGui::BeginDisabled(replaying);
+    int stressCount = static_cast<int>(stressOrbits.size());
+    if (ImGui::InputInt("Stress orbits", &stressCount, 100, 1000))
+        setParameter(PARAM_STRESS_ORBITS, static_cast<float>(stressCount));
+    ImGui::EndDisabled();
+    ImGui::Text("State calls:    %d issued / %d requested", calls.issued, calls.requested);
+    ImGui::Text("Jobs:           %u workers, %zu pending, %zu stolen", workers.getThreadCount(),
+                workers.getPendingCount(), workers.getStealCount());
+    ImGui::Text("Streaming:      %d textures, %.1f KB/frame", textures->getPendingCount(),
+                textures->getBytesUploadedLastFrame() / 1024.0);
+    ImGui::Text("Texture memory: %.1f MB%s", textures->getResidentBytes() / (1024.0 * 1024.0),
+                textures->isCompressionSupported() ? "" : " (no S3TC)");
+    ImGui::Separator();
+
+    // Background
+    ImGui::BeginDisabled(replaying);
+    int background = skyboxEnabled ? 1 : 0;
+    ImGui::Text("Background (B):");
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Starfield", &background, 0))
+        setParameter(PARAM_SKYBOX, 0.0f);
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Skybox", &background, 1))
+        setParameter(PARAM_SKYBOX, 1.0f);
+    if (!skyboxEnabled) {
+        float starBrightness = starfield->getBrightness();
+        if (ImGui::SliderFloat("Star brightness", &starBrightness, 0.1f, 4.0f))
+            setParameter(PARAM_STAR_BRIGHTNESS, starBrightness);
+        bool milkyWay = starfield->isMilkyWayVisible();
+        if (ImGui::Checkbox("Milky Way", &milkyWay))
+            setParameter(PARAM_MILKY_WAY, milkyWay ? 1.0f : 0.0f);
+        ImGui::SameLine();
+        ImGui::Text("%d catalog stars", starfield->getStarCount());
+    }
+    ImGui::EndDisabled();
+    ImGui::Separator();
+
+    // Rolling pass timings
+    if (ImGui::BeginTable("Timings", 5, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Pass (ms)");
+        ImGui::TableSetupColumn("avg");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+
+        for (int i = 0; i < FrameProfiler::CPU_SECTION_COUNT; ++i) {
+            FrameProfiler::CpuSection section = static_cast<FrameProfiler::CpuSection>(i);
+            addTimingRow("CPU", FrameProfiler::getCpuSectionName(section),
+                         profiler.getCpuSummary(section));
+        }
+        for (int i = 0; i < FrameProfiler::GPU_SECTION_COUNT; ++i) {
+            FrameProfiler::GpuSection section = static_cast<FrameProfiler::GpuSection>(i);
+            addTimingRow("GPU", FrameProfiler::getGpuSectionName(section),
+                         profiler.getGpuSummary(section));
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export timings")) {
+        profiler.exportCsv("frame_timings.csv");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) {
+        TraceProfiler::exportChromeTrace("trace.json");
+    }
+    bool tracing = TraceProfiler::isEnabled();
+    if (ImGui::Checkbox("Trace zones", &tracing))
+        TraceProfiler::setEnabled(tracing);
+    ImGui::SameLine();
+    ImGui::Text("%llu recorded", static_cast<unsigned long long>(TraceProfiler::getZoneCount()));
+    if (stateFeed.isOpen()) {
+        ImGui::Text("State feed %s: %llu frames", stateFeed.getName().c_str(),
+                    static_cast<unsigned long long>(stateFeed.getPublishedCount()));
+    }
+    ImGui::Separator();
+
+    // Frame pacing
+    bool adaptive = governor.isEnabled();
+    if (ImGui::Checkbox("Adaptive quality", &adaptive)) {
+        governor.setEnabled(adaptive);
+        applyQuality();
+    }
+    float targetTime = static_cast<float>(governor.getTargetFrameTime());
+    if (ImGui::SliderFloat("Target ms", &targetTime, 4.0f, 50.0f, "%.1f"))
+        governor.setTargetFrameTime(targetTime);
+    const QualitySettings& quality = governor.getSettings();
+    ImGui::Text("Quality:        level %d/%d, %.0f%% resolution", governor.getLevel() + 1,
+                QualityGovernor::LEVEL_COUNT, quality.renderScale * 100.0f);
+    ImGui::Text("Frame cost:     %.2f ms (max of CPU, GPU)", governor.getSmoothedFrameTime());
+    int fpsCap = static_cast<int>(limiter.getMaxFps() + 0.5);
+    if (ImGui::InputInt("FPS cap", &fpsCap, 10, 30))
+        limiter.setMaxFps(std::max(fpsCap, 0));
+    if (!isHeadless() && ImGui::Checkbox("VSync", &options.vsync))
+        glfwSwapInterval(options.vsync ? 1 : 0);
+    ImGui::Checkbox("Idle when paused", &options.idle);
+    ImGui::SameLine();
+    ImGui::Text("%d idle wakeups", idleWakeups);
+    ImGui::Separator();
+
+    // Image-sequence capture
+    if (capture.isActive()) {
+        FrameCapture::Stats stats = capture.getStats();
+        ImGui::Text("Capturing %dx%d", capture.getWidth(), capture.getHeight());
+        ImGui::Text("Written:        %d / %d (%.1f fps)", stats.written, stats.captured,
+                    stats.throughput);
+        ImGui::Text("Stalls:         %d", stats.stalls);
+        if (ImGui::Button("Stop capture"))
+            stopCapture();
+    } else if (ImGui::Button("Start capture")) {
+        startCapture();
+    }
 
-    habitableZone->UpdateRadii(r1, r2);
+    ImGui::End();
 }
 
 void Application::adjustCameraPosition() {
@@ -520,10 +1529,10 @@ void Application::adjustCameraPosition() {
     float cameraDistance = (maxDistance + starRadius) * distanceFactor;
 
     // Position the camera along a suitable vector
-    glm::vec3 newPosition = glm::vec3(0.0f, cameraDistance, cameraDistance);
+    glm::dvec3 newPosition = star->getPosition() + glm::dvec3(0.0, cameraDistance, cameraDistance);
 
     // Calculate the new front vector
-    glm::vec3 newFront = star->getPosition() - newPosition;
+    glm::vec3 newFront = glm::vec3(star->getPosition() - newPosition);
 
     // Set the camera's position and front vectors using the Camera method
     camera.setPositionAndFront(newPosition, newFront);
@@ -535,14 +1544,14 @@ void Application::adjustCameraToPlanet() {
         planet->getRadius() * 3.0f; // Adjust multiplier as needed
 
     // Calculate direction from the planet to the star (or any other point)
-    glm::vec3 direction =
+    glm::dvec3 direction =
         glm::normalize(planet->getPosition() - star->getPosition());
 
     // Calculate new camera position behind the planet
-    glm::vec3 newPosition = planet->getPosition() + direction * offsetDistance;
+    glm::dvec3 newPosition = planet->getPosition() + direction * static_cast<double>(offsetDistance);
 
     // Calculate new front vector
-    glm::vec3 newFront = planet->getPosition() - newPosition;
+    glm::vec3 newFront = glm::vec3(planet->getPosition() - newPosition);
 
     // Set the camera's position and front vectors using the Camera method
     camera.setPositionAndFront(newPosition, newFront);
@@ -554,13 +1563,13 @@ void Application::adjustCameraToStar() {
         star->getRadius() * 3.0f; // Adjust multiplier as needed
 
     // Calculate direction to position the camera
-    glm::vec3 direction = glm::vec3(0.0f, 0.0f, 1.0f); // Adjust if needed
+    glm::dvec3 direction = glm::dvec3(0.0, 0.0, 1.0); // Adjust if needed
 
     // Calculate new camera position
-    glm::vec3 newPosition = star->getPosition() + direction * offsetDistance;
+    glm::dvec3 newPosition = star->getPosition() + direction * static_cast<double>(offsetDistance);
 
     // Calculate new front vector
-    glm::vec3 newFront = star->getPosition() - newPosition;
+    glm::vec3 newFront = glm::vec3(star->getPosition() - newPosition);
 
     // Set the camera's position and front vectors using the Camera method
     camera.setPositionAndFront(newPosition, newFront);
@@ -0,0 +1,27 @@
+// BlackbodyTexture.cpp
+
+#include "BlackbodyTexture.h"
+#include "BlackbodyTable.h"
+
+BlackbodyTexture::BlackbodyTexture()
+    : textureID(0)
+{
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_1D, textureID);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB16F, BlackbodyTable::SIZE, 0, GL_RGB, GL_FLOAT,
+                 BlackbodyTable::get().getData());
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
+
+BlackbodyTexture::~BlackbodyTexture()
+{
+    glDeleteTextures(1, &textureID);
+}
+
+GLuint BlackbodyTexture::getID() const
+{
+    return textureID;
+}
@@ -0,0 +1,292 @@
+// BlockCompression.cpp
+
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Gather a 4x4 block, clamping at the image edge
+void loadBlock(const unsigned char* rgba, int width, int height, int bx, int by,
+               unsigned char block[16][4])
+{
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block[y * 4 + x], rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+uint16_t packRgb565(const float color[3])
+{
+    int r = static_cast<int>(std::floor(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f));
+    int g = static_cast<int>(std::floor(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f));
+    int b = static_cast<int>(std::floor(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, int color[3])
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// Four-color palette of a BC1 block (three colors plus black if c0 <= c1)
+void buildPalette(uint16_t c0, uint16_t c1, bool forceFourColors, int palette[4][3])
+{
+    unpackRgb565(c0, palette[0]);
+    unpackRgb565(c1, palette[1]);
+    for (int i = 0; i < 3; ++i) {
+        if (c0 > c1 || forceFourColors) {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        } else {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+    }
+}
+
+int colorDistance(const unsigned char* a, const int* b)
+{
+    int dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+    return dr * dr * 2 + dg * dg * 4 + db * db; // Rough luminance weighting
+}
+
+// Endpoints along the principal axis of the block's colors, refined once
+// by least squares on the chosen indices
+void compressColorBlock(const unsigned char block[16][4], unsigned char* output)
+{
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += block[i][c] / 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // Power iteration for the dominant eigenvector
+    float axis[3] = { 0.577f, 0.577f, 0.577f };
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::sqrt(x * x + y * y + z * z);
+        if (length < 1e-6f)
+            break;
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    float minProjection = 1e9f, maxProjection = -1e9f;
+    for (int i = 0; i < 16; ++i) {
+        float t = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] +
+                  (block[i][2] - mean[2]) * axis[2];
+        minProjection = std::min(minProjection, t);
+        maxProjection = std::max(maxProjection, t);
+    }
+
+    float endpoints[2][3];
+    for (int c = 0; c < 3; ++c) {
+        endpoints[0][c] = mean[c] + axis[c] * maxProjection;
+        endpoints[1][c] = mean[c] + axis[c] * minProjection;
+    }
+
+    uint16_t c0 = 0, c1 = 0;
+    uint32_t indices = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        c0 = packRgb565(endpoints[0]);
+        c1 = packRgb565(endpoints[1]);
+        if (c0 < c1)
+            std::swap(c0, c1);
+
+        int palette[4][3];
+        buildPalette(c0, c1, true, palette);
+
+        indices = 0;
+        int chosen[16];
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = colorDistance(block[i], palette[0]);
+            for (int p = 1; p < 4; ++p) {
+                int distance = colorDistance(block[i], palette[p]);
+                if (distance < bestDistance) {
+                    best = p;
+                    bestDistance = distance;
+                }
+            }
+            chosen[i] = best;
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+        if (c0 == c1) {
+            indices = 0;
+            break;
+        }
+
+        // Least-squares endpoints for the chosen interpolation weights
+        static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, bb = 0, ab = 0, ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; ++i) {
+            float a = weights[chosen[i]], b = 1.0f - a;
+            aa += a * a; bb += b * b; ab += a * b;
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += a * block[i][c];
+                bx[c] += b * block[i][c];
+            }
+        }
+        float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f)
+            break;
+        for (int c = 0; c < 3; ++c) {
+            endpoints[0][c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            endpoints[1][c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+    }
+
+    output[0] = static_cast<unsigned char>(c0 & 0xFF);
+    output[1] = static_cast<unsigned char>(c0 >> 8);
+    output[2] = static_cast<unsigned char>(c1 & 0xFF);
+    output[3] = static_cast<unsigned char>(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        output[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+// Eight-value interpolated alpha block (BC3)
+void compressAlphaBlock(const unsigned char block[16][4], unsigned char* output)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, static_cast<int>(block[i][3]));
+        a1 = std::min(a1, static_cast<int>(block[i][3]));
+    }
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        int palette[8];
+        palette[0] = a0;
+        palette[1] = a1;
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = 256;
+            for (int p = 0; p < 8; ++p) {
+                int distance = std::abs(palette[p] - block[i][3]);
+                if (distance < bestDistance) {
+                    best = p;
+                    bestDistance = distance;
+                }
+            }
+            indices |= static_cast<uint64_t>(best) << (3 * i);
+        }
+    }
+
+    output[0] = static_cast<unsigned char>(a0);
+    output[1] = static_cast<unsigned char>(a1);
+    for (int i = 0; i < 6; ++i)
+        output[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+void decompressColorBlock(const unsigned char* input, bool forceFourColors, unsigned char block[16][4])
+{
+    uint16_t c0 = static_cast<uint16_t>(input[0] | (input[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(input[2] | (input[3] << 8));
+    int palette[4][3];
+    buildPalette(c0, c1, forceFourColors, palette);
+
+    uint32_t indices = input[4] | (input[5] << 8) | (input[6] << 16) | (static_cast<uint32_t>(input[7]) << 24);
+    for (int i = 0; i < 16; ++i) {
+        int index = (indices >> (2 * i)) & 3;
+        for (int c = 0; c < 3; ++c)
+            block[i][c] = static_cast<unsigned char>(palette[index][c]);
+        block[i][3] = (!forceFourColors && c0 <= c1 && index == 3) ? 0 : 255;
+    }
+}
+
+void decompressAlphaBlock(const unsigned char* input, unsigned char block[16][4])
+{
+    int a0 = input[0], a1 = input[1];
+    int palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    } else {
+        for (int i = 1; i < 5; ++i)
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= static_cast<uint64_t>(input[2 + i]) << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        block[i][3] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 7]);
+}
+
+}
+
+size_t BlockCompression::getBlockSize(Format format)
+{
+    return format == BC1 ? 8 : 16;
+}
+
+size_t BlockCompression::getCompressedSize(Format format, int width, int height)
+{
+    size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    return blocksX * blocksY * getBlockSize(format);
+}
+
+void BlockCompression::compress(Format format, const unsigned char* rgba, int width, int height,
+                                unsigned char* output)
+{
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            unsigned char block[16][4];
+            loadBlock(rgba, width, height, bx, by, block);
+            if (format == BC3) {
+                compressAlphaBlock(block, output);
+                output += 8;
+            }
+            compressColorBlock(block, output);
+            output += 8;
+        }
+    }
+}
+
+void BlockCompression::decompress(Format format, const unsigned char* blocks, int width, int height,
+                                  unsigned char* rgba)
+{
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            unsigned char block[16][4];
+            if (format == BC3) {
+                decompressColorBlock(blocks + 8, true, block);
+                decompressAlphaBlock(blocks, block);
+            } else {
+                decompressColorBlock(blocks, false, block);
+            }
+            blocks += getBlockSize(format);
+
+            for (int y = 0; y < 4 && by * 4 + y < height; ++y)
+                for (int x = 0; x < 4 && bx * 4 + x < width; ++x)
+                    std::memcpy(rgba + (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4,
+                                block[y * 4 + x], 4);
+        }
+    }
+}
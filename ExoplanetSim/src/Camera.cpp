@@ -3,7 +3,7 @@
 #include "Camera.h"
 
 Camera::Camera(
-    glm::vec3 position,
+    glm::dvec3 position,
     glm::vec3 up,
     float yaw,
     float pitch
@@ -22,23 +22,29 @@ Camera::Camera(
 
 glm::mat4 Camera::GetViewMatrix()
 {
-    return glm::lookAt(Position, Position + Front, Up);
+    // Rotation only; translation is applied on the CPU in double precision
+    return glm::lookAt(glm::vec3(0.0f), Front, Up);
+}
+
+glm::vec3 Camera::ToCameraRelative(const glm::dvec3& worldPosition) const
+{
+    return glm::vec3(worldPosition - Position);
 }
 
 void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime) {
-    float velocity = MovementSpeed * deltaTime;
+    double velocity = static_cast<double>(MovementSpeed * deltaTime);
     if (direction == FORWARD)
-        Position += Front * velocity;
+        Position += glm::dvec3(Front) * velocity;
     if (direction == BACKWARD)
-        Position -= Front * velocity;
+        Position -= glm::dvec3(Front) * velocity;
     if (direction == LEFT)
-        Position -= Right * velocity;
+        Position -= glm::dvec3(Right) * velocity;
     if (direction == RIGHT)
-        Position += Right * velocity;
+        Position += glm::dvec3(Right) * velocity;
     if (direction == UP)
-        Position += Up * velocity;
+        Position += glm::dvec3(Up) * velocity;
     if (direction == DOWN)
-        Position -= Up * velocity;
+        Position -= glm::dvec3(Up) * velocity;
 }
 
 void Camera::ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch)
@@ -78,7 +84,7 @@ void Camera::ProcessMouseScroll(float yoffset)
         Zoom = 90.0f;
 }
 
-void Camera::setPositionAndFront(const glm::vec3& position, const glm::vec3& front)
+void Camera::setPositionAndFront(const glm::dvec3& position, const glm::vec3& front)
 {
     Position = position;
     Front = glm::normalize(front);
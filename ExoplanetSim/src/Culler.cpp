@@ -0,0 +1,248 @@
+// Culler.cpp
+
+#include "Culler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Sorts system indices along one axis of their bounds' centers
+struct SystemAxisLess {
+    const std::vector<glm::vec3>* centers;
+    int axis;
+
+    bool operator()(int a, int b) const {
+        return (*centers)[a][axis] < (*centers)[b][axis];
+    }
+};
+
+const int BVH_LEAF_SIZE = 4;
+
+} // namespace
+
+Culler::Culler()
+    : cameraPos(0.0f)
+{}
+
+void Culler::beginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPos)
+{
+    frustum.update(viewProjection);
+    this->cameraPos = cameraPos;
+
+    systems.clear();
+    items.clear();
+    stats = CullStats();
+}
+
+int Culler::addSystem(const BoundingBox& bounds, const BoundingSphere& occluder)
+{
+    System system;
+    system.bounds = bounds;
+    system.occluder = occluder;
+    system.visible = false;
+    systems.push_back(system);
+    return static_cast<int>(systems.size()) - 1;
+}
+
+int Culler::addBody(int system, const BoundingSphere& sphere, bool occludable)
+{
+    Item item = Item();
+    item.kind = ITEM_BODY;
+    item.system = system;
+    item.sphere = sphere;
+    item.occludable = occludable;
+    items.push_back(item);
+    return static_cast<int>(items.size()) - 1;
+}
+
+int Culler::addOrbit(int system, const BoundingBox& box)
+{
+    Item item = Item();
+    item.kind = ITEM_ORBIT;
+    item.system = system;
+    item.box = box;
+    items.push_back(item);
+    return static_cast<int>(items.size()) - 1;
+}
+
+int Culler::addZone(int system, const glm::vec3& center, float innerRadius, float outerRadius)
+{
+    Item item = Item();
+    item.kind = ITEM_ZONE;
+    item.system = system;
+    item.center = center;
+    item.innerRadius = innerRadius;
+    item.outerRadius = outerRadius;
+    items.push_back(item);
+    return static_cast<int>(items.size()) - 1;
+}
+
+void Culler::cull()
+{
+    stats.systems = static_cast<int>(systems.size());
+
+    // Reject whole systems first
+    if (static_cast<int>(systems.size()) > BVH_THRESHOLD)
+        cullSystemsBVH();
+    else
+        cullSystemsLinear();
+
+    for (size_t i = 0; i < systems.size(); ++i) {
+        if (!systems[i].visible)
+            ++stats.systemsCulled;
+    }
+
+    // Then test the individual items of the surviving systems
+    for (size_t i = 0; i < items.size(); ++i) {
+        Item& item = items[i];
+        const System& system = systems[item.system];
+
+        bool inFrustum = system.visible;
+        if (inFrustum) {
+            if (item.kind == ITEM_BODY)
+                inFrustum = frustum.intersectsSphere(item.sphere);
+            else if (item.kind == ITEM_ORBIT)
+                inFrustum = frustum.intersectsBox(item.box);
+            else
+                inFrustum = frustum.intersectsAnnulus(item.center, item.innerRadius, item.outerRadius);
+        }
+
+        if (!inFrustum) {
+            item.visible = false;
+            ++stats.frustumCulled;
+            continue;
+        }
+
+        if (item.kind == ITEM_BODY && item.occludable &&
+            isOccluded(item.sphere, system.occluder)) {
+            item.visible = false;
+            ++stats.occluded;
+            continue;
+        }
+
+        item.visible = true;
+        ++stats.drawn;
+    }
+}
+
+bool Culler::isVisible(int item) const
+{
+    return item >= 0 && item < static_cast<int>(items.size()) && items[item].visible;
+}
+
+const CullStats& Culler::getStats() const
+{
+    return stats;
+}
+
+void Culler::cullSystemsLinear()
+{
+    for (size_t i = 0; i < systems.size(); ++i)
+        systems[i].visible = frustum.intersectsBox(systems[i].bounds);
+}
+
+void Culler::cullSystemsBVH()
+{
+    stats.usedBVH = true;
+
+    // The BVH is rebuilt each frame as bodies move; a median split over a
+    // few thousand systems is far cheaper than testing all of their items.
+    bvhNodes.clear();
+    bvhSystems.resize(systems.size());
+    bvhCenters.resize(systems.size());
+    for (size_t i = 0; i < systems.size(); ++i) {
+        bvhSystems[i] = static_cast<int>(i);
+        bvhCenters[i] = systems[i].bounds.getCenter();
+        systems[i].visible = false;
+    }
+
+    int root = buildBVH(0, static_cast<int>(systems.size()));
+    traverseBVH(root);
+}
+
+int Culler::buildBVH(int first, int count)
+{
+    BVHNode node;
+    node.bounds = systems[bvhSystems[first]].bounds;
+    for (int i = first + 1; i < first + count; ++i)
+        node.bounds.expand(systems[bvhSystems[i]].bounds);
+    node.left = node.right = -1;
+    node.first = first;
+    node.count = count;
+
+    int index = static_cast<int>(bvhNodes.size());
+    bvhNodes.push_back(node);
+
+    if (count <= BVH_LEAF_SIZE)
+        return index;
+
+    // Split at the median along the longest axis
+    glm::vec3 extent = node.bounds.max - node.bounds.min;
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    SystemAxisLess less;
+    less.centers = &bvhCenters;
+    less.axis = axis;
+
+    int half = count / 2;
+    std::nth_element(bvhSystems.begin() + first,
+                     bvhSystems.begin() + first + half,
+                     bvhSystems.begin() + first + count, less);
+
+    int left = buildBVH(first, half);
+    int right = buildBVH(first + half, count - half);
+    bvhNodes[index].left = left;
+    bvhNodes[index].right = right;
+    return index;
+}
+
+void Culler::traverseBVH(int nodeIndex)
+{
+    const BVHNode& node = bvhNodes[nodeIndex];
+    if (!frustum.intersectsBox(node.bounds))
+        return; // Every system below stays invisible
+
+    if (node.left < 0) {
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            System& system = systems[bvhSystems[i]];
+            system.visible = frustum.intersectsBox(system.bounds);
+        }
+        return;
+    }
+
+    int left = node.left;
+    int right = node.right;
+    traverseBVH(left);
+    traverseBVH(right);
+}
+
+bool Culler::isOccluded(const BoundingSphere& body, const BoundingSphere& occluder) const
+{
+    if (occluder.radius <= 0.0f)
+        return false;
+
+    glm::vec3 toOccluder = occluder.center - cameraPos;
+    float occluderDistance = glm::length(toOccluder);
+
+    // Camera inside (or touching) the star: nothing is hidden by it
+    if (occluderDistance <= occluder.radius)
+        return false;
+
+    glm::vec3 toBody = body.center - cameraPos;
+    float bodyDistance = glm::length(toBody);
+
+    // Any ray entering the star's silhouette hits its surface before
+    // reaching the distance of the star's center, so a body is hidden if
+    // all of it lies inside that cone and beyond that distance.
+    if (bodyDistance - body.radius < occluderDistance)
+        return false;
+
+    float occluderAngle = std::asin(occluder.radius / occluderDistance);
+    float bodyAngle = std::asin(std::fmin(1.0f, body.radius / bodyDistance));
+    float cosSeparation = glm::dot(toOccluder, toBody) / (occluderDistance * bodyDistance);
+    float separation = std::acos(glm::clamp(cosSeparation, -1.0f, 1.0f));
+
+    return separation + bodyAngle <= occluderAngle;
+}
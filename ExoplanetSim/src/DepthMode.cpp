@@ -0,0 +1,116 @@
+// DepthMode.cpp
+
+#include "DepthMode.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifndef GL_LOWER_LEFT
+#define GL_LOWER_LEFT 0x8CA1
+#endif
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+
+const float DepthMode::LOG_DEPTH_FAR = 1.0e8f;
+
+DepthMode::DepthMode()
+    : technique(LOGARITHMIC), clipControl(nullptr)
+{}
+
+void DepthMode::initialize(GLADloadproc loader)
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    bool supported = (major > 4 || (major == 4 && minor >= 5)) ||
+                     hasExtension("GL_ARB_clip_control");
+    if (supported) {
+        clipControl = reinterpret_cast<PFNGLCLIPCONTROLPROC>(loader("glClipControl"));
+    }
+
+    if (clipControl != nullptr) {
+        // Map clip-space depth straight to [0, 1] so the float depth
+        // buffer keeps its precision near 0, where far geometry lands
+        clipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        technique = REVERSE_Z;
+    } else {
+        technique = LOGARITHMIC;
+    }
+
+    std::cout << "Depth mode: " << getName() << std::endl;
+}
+
+DepthMode::Technique DepthMode::getTechnique() const
+{
+    return technique;
+}
+
+const char* DepthMode::getName() const
+{
+    return technique == REVERSE_Z ? "Reverse-Z (float32, infinite far)"
+                                  : "Logarithmic (float32)";
+}
+
+std::string DepthMode::getShaderDefines() const
+{
+    return technique == REVERSE_Z ? "#define REVERSE_Z\n" : "#define LOG_DEPTH\n";
+}
+
+glm::mat4 DepthMode::getProjection(float fovy, float aspect, float nearPlane) const
+{
+    if (technique == LOGARITHMIC)
+        return glm::infinitePerspective(fovy, aspect, nearPlane);
+
+    // Reverse-Z infinite projection: depth = near / -z_view, which is 1 at
+    // the near plane and tends to 0 at infinity
+    float f = 1.0f / std::tan(fovy * 0.5f);
+    glm::mat4 projection(0.0f);
+    projection[0][0] = f / aspect;
+    projection[1][1] = f;
+    projection[2][3] = -1.0f;
+    projection[3][2] = nearPlane;
+    return projection;
+}
+
+glm::mat4 DepthMode::getCullingProjection(float fovy, float aspect, float nearPlane) const
+{
+    return glm::infinitePerspective(fovy, aspect, nearPlane);
+}
+
+float DepthMode::getClearDepth() const
+{
+    return technique == REVERSE_Z ? 0.0f : 1.0f;
+}
+
+GLenum DepthMode::getDepthFunc() const
+{
+    return technique == REVERSE_Z ? GL_GREATER : GL_LESS;
+}
+
+GLenum DepthMode::getSkyDepthFunc() const
+{
+    return technique == REVERSE_Z ? GL_GEQUAL : GL_LEQUAL;
+}
+
+void DepthMode::setUniforms(const Shader& shader) const
+{
+    if (technique == LOGARITHMIC) {
+        shader.setFloat("logDepthCoef", 2.0f / std::log2(LOG_DEPTH_FAR + 1.0f));
+    }
+}
+
+bool DepthMode::hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension != nullptr && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
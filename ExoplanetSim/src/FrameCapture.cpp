@@ -0,0 +1,271 @@
+// FrameCapture.cpp
+
+#include "FrameCapture.h"
+#include "ImageWriter.h"
+
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+FrameCapture::FrameCapture()
+    : active(false), width(0), height(0), format(FORMAT_PNG), pool(nullptr),
+      nextSlot(0), captured(0), stalls(0), queued(0), written(0), failed(0)
+{
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        slots[i].pbo = 0;
+        slots[i].fence = 0;
+        slots[i].frame = 0;
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    stop();
+    for (size_t i = 0; i < freeBuffers.size(); ++i)
+        delete freeBuffers[i];
+}
+
+bool FrameCapture::start(const std::string& directory, int width, int height,
+                         Format format, ThreadPool& pool)
+{
+    if (active)
+        stop();
+    if (width <= 0 || height <= 0)
+        return false;
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Error: Cannot create capture directory " << directory
+                  << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    this->directory = directory;
+    this->width = width;
+    this->height = height;
+    this->format = format;
+    this->pool = &pool;
+
+    // Drop recycled buffers of a different size
+    for (size_t i = 0; i < freeBuffers.size(); ++i)
+        delete freeBuffers[i];
+    freeBuffers.clear();
+
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        glGenBuffers(1, &slots[i].pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, getFrameSize(), nullptr, GL_STREAM_READ);
+        slots[i].fence = 0;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    nextSlot = 0;
+    captured = 0;
+    stalls = 0;
+    written = 0;
+    failed = 0;
+    startTime = std::chrono::steady_clock::now();
+    active = true;
+
+    std::cout << "Capturing " << width << "x" << height << " frames to " << directory
+              << " (" << (format == FORMAT_PNG ? "png" : "raw rgba") << ")" << std::endl;
+    return true;
+}
+
+void FrameCapture::captureFrame(GLuint framebuffer)
+{
+    if (!active)
+        return;
+
+    // Hand off whatever the GPU has finished, without waiting
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        if (slots[i].fence != 0)
+            collect(slots[i], false);
+    }
+
+    // The ring is full only when the GPU is PBO_COUNT frames behind
+    Slot& slot = slots[nextSlot];
+    if (slot.fence != 0) {
+        ++stalls;
+        collect(slot, true);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = captured++;
+    nextSlot = (nextSlot + 1) % PBO_COUNT;
+}
+
+bool FrameCapture::collect(Slot& slot, bool wait)
+{
+    GLuint64 timeout = wait ? 1000000000ull : 0; // 1 s
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (status == GL_TIMEOUT_EXPIRED && !wait)
+        return false;
+
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+    if (status == GL_WAIT_FAILED || status == GL_TIMEOUT_EXPIRED) {
+        ++failed;
+        return false;
+    }
+
+    // Bound the encoder backlog so memory stays flat if the disk is slow
+    std::vector<unsigned char>* pixels = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queued >= MAX_QUEUED_FRAMES) {
+            ++stalls;
+            frameDone.wait(lock, [this] { return queued < MAX_QUEUED_FRAMES; });
+        }
+        ++queued;
+        if (!freeBuffers.empty()) {
+            pixels = freeBuffers.back();
+            freeBuffers.pop_back();
+        }
+    }
+    if (pixels == nullptr)
+        pixels = new std::vector<unsigned char>(getFrameSize());
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, getFrameSize(), GL_MAP_READ_BIT);
+    bool mappedOk = mapped != nullptr;
+    if (mappedOk) {
+        std::memcpy(&(*pixels)[0], mapped, getFrameSize());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!mappedOk) {
+        ++failed;
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(pixels);
+        --queued;
+        return false;
+    }
+
+    int frame = slot.frame;
+    pool->enqueue([this, pixels, frame] { encode(pixels, frame); });
+    return true;
+}
+
+void FrameCapture::encode(std::vector<unsigned char>* pixels, int frame)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06d.%s", frame, format == FORMAT_PNG ? "png" : "rgba");
+    std::string path = directory + "/" + name;
+
+    // The scene is opaque, but blended passes (orbits, habitable zone)
+    // also scale the target's alpha; write every pixel fully opaque so
+    // video tools do not composite the frames against a background
+    std::vector<unsigned char>& rgba = *pixels;
+    for (size_t i = 3; i < rgba.size(); i += 4)
+        rgba[i] = 255;
+
+    // glReadPixels rows are bottom-up
+    bool ok = format == FORMAT_PNG
+        ? ImageWriter::writePng(path, width, height, 4, &(*pixels)[0], true)
+        : ImageWriter::writeRaw(path, width, height, 4, &(*pixels)[0], true);
+    if (ok)
+        ++written;
+    else
+        ++failed;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(pixels);
+        --queued;
+    }
+    frameDone.notify_all();
+}
+
+void FrameCapture::stop()
+{
+    if (!active)
+        return;
+
+    // Oldest first, so the files finish roughly in order
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        Slot& slot = slots[(nextSlot + i) % PBO_COUNT];
+        if (slot.fence != 0)
+            collect(slot, true);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameDone.wait(lock, [this] { return queued == 0; });
+    }
+
+    stopTime = std::chrono::steady_clock::now();
+    active = false;
+    destroy();
+
+    Stats stats = getStats();
+    std::cout << "Capture finished: " << stats.written << " frames written";
+    if (stats.failed > 0)
+        std::cout << ", " << stats.failed << " failed";
+    std::cout << ", " << stats.throughput << " fps sustained, "
+              << stats.stalls << " stalls" << std::endl;
+    if (format == FORMAT_RAW) {
+        std::cout << "  ffmpeg -f image2 -c:v rawvideo -pixel_format rgba -video_size "
+                  << width << "x" << height << " -i " << directory << "/frame_%06d.rgba out.mp4"
+                  << std::endl;
+    }
+}
+
+bool FrameCapture::isActive() const { return active; }
+int FrameCapture::getWidth() const { return width; }
+int FrameCapture::getHeight() const { return height; }
+
+FrameCapture::Stats FrameCapture::getStats() const
+{
+    Stats stats;
+    stats.captured = captured;
+    stats.written = written;
+    stats.failed = failed;
+    stats.stalls = stalls;
+
+    std::chrono::steady_clock::time_point end =
+        active ? std::chrono::steady_clock::now() : stopTime;
+    stats.seconds = std::chrono::duration<double>(end - startTime).count();
+    stats.throughput = stats.seconds > 0.0 ? stats.written / stats.seconds : 0.0;
+    return stats;
+}
+
+bool FrameCapture::parseFormat(const std::string& name, Format& format)
+{
+    if (name == "png") {
+        format = FORMAT_PNG;
+        return true;
+    }
+    if (name == "raw") {
+        format = FORMAT_RAW;
+        return true;
+    }
+    return false;
+}
+
+size_t FrameCapture::getFrameSize() const
+{
+    return static_cast<size_t>(width) * height * 4;
+}
+
+void FrameCapture::destroy()
+{
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        if (slots[i].fence != 0)
+            glDeleteSync(slots[i].fence);
+        if (slots[i].pbo != 0)
+            glDeleteBuffers(1, &slots[i].pbo);
+        slots[i].fence = 0;
+        slots[i].pbo = 0;
+    }
+}
@@ -0,0 +1,206 @@
+// FrameProfiler.cpp
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+void FrameProfiler::History::add(float value)
+{
+    samples[next] = value;
+    next = (next + 1) % HISTORY_SIZE;
+    if (count < HISTORY_SIZE)
+        ++count;
+}
+
+FrameProfiler::FrameProfiler()
+    : initialized(false), frameIndex(0), activeSection(-1), lastGpuFrameTime(0.0)
+{
+    for (int f = 0; f < FRAMES_IN_FLIGHT; ++f) {
+        for (int s = 0; s < GPU_SECTION_COUNT; ++s) {
+            queries[f][s] = 0;
+            pending[f][s] = false;
+        }
+    }
+}
+
+void FrameProfiler::initialize()
+{
+    glGenQueries(FRAMES_IN_FLIGHT * GPU_SECTION_COUNT, &queries[0][0]);
+    initialized = true;
+}
+
+void FrameProfiler::shutdown()
+{
+    if (!initialized)
+        return;
+
+    glDeleteQueries(FRAMES_IN_FLIGHT * GPU_SECTION_COUNT, &queries[0][0]);
+    for (int f = 0; f < FRAMES_IN_FLIGHT; ++f) {
+        for (int s = 0; s < GPU_SECTION_COUNT; ++s) {
+            queries[f][s] = 0;
+            pending[f][s] = false;
+        }
+    }
+    activeSection = -1;
+    initialized = false;
+}
+
+void FrameProfiler::beginFrame()
+{
+    if (!initialized)
+        return;
+
+    ++frameIndex;
+    int slot = static_cast<int>(frameIndex % FRAMES_IN_FLIGHT);
+
+    // The slot was last used FRAMES_IN_FLIGHT frames ago; its results are
+    // normally ready. If one is not, drop it rather than stall.
+    double frameTotal = 0.0;
+    bool anyResult = false;
+    for (int s = 0; s < GPU_SECTION_COUNT; ++s) {
+        if (!pending[slot][s])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot][s], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(queries[slot][s], GL_QUERY_RESULT, &elapsed);
+            gpuHistory[s].add(static_cast<float>(elapsed / 1.0e6));
+            frameTotal += elapsed / 1.0e6;
+            anyResult = true;
+        }
+        pending[slot][s] = false;
+    }
+    if (anyResult)
+        lastGpuFrameTime = frameTotal;
+}
+
+void FrameProfiler::beginGpu(GpuSection section)
+{
+    if (!initialized)
+        return;
+    if (activeSection >= 0)
+        endGpu();
+
+    int slot = static_cast<int>(frameIndex % FRAMES_IN_FLIGHT);
+
+    // A section timed twice in one frame keeps its first measurement
+    if (pending[slot][section])
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot][section]);
+    activeSection = section;
+}
+
+void FrameProfiler::endGpu()
+{
+    if (activeSection < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[frameIndex % FRAMES_IN_FLIGHT][activeSection] = true;
+    activeSection = -1;
+}
+
+void FrameProfiler::addCpuSample(CpuSection section, double milliseconds)
+{
+    cpuHistory[section].add(static_cast<float>(milliseconds));
+}
+
+FrameProfiler::Summary FrameProfiler::getGpuSummary(GpuSection section) const
+{
+    return summarize(gpuHistory[section]);
+}
+
+double FrameProfiler::getLastGpuFrameTime() const
+{
+    return lastGpuFrameTime;
+}
+
+FrameProfiler::Summary FrameProfiler::getCpuSummary(CpuSection section) const
+{
+    return summarize(cpuHistory[section]);
+}
+
+const char* FrameProfiler::getGpuSectionName(GpuSection section)
+{
+    static const char* names[GPU_SECTION_COUNT] = {
+        "Star", "Planets", "Skybox", "Starfield", "Orbits", "Habitable zone", "ImGui"
+    };
+    return names[section];
+}
+
+const char* FrameProfiler::getCpuSectionName(CpuSection section)
+{
+    static const char* names[CPU_SECTION_COUNT] = {
+        "Frame", "Update", "UI build", "Scene record+submit", "ImGui render"
+    };
+    return names[section];
+}
+
+bool FrameProfiler::exportCsv(const std::string& path) const
+{
+    std::ofstream file(path.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not write timings to " << path << std::endl;
+        return false;
+    }
+
+    file << "kind,section,samples,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (int s = 0; s < CPU_SECTION_COUNT; ++s) {
+        Summary summary = summarize(cpuHistory[s]);
+        file << "cpu," << getCpuSectionName(static_cast<CpuSection>(s)) << ','
+             << summary.samples << ',' << summary.average << ',' << summary.p50 << ','
+             << summary.p95 << ',' << summary.p99 << ',' << summary.max << '\n';
+    }
+    for (int s = 0; s < GPU_SECTION_COUNT; ++s) {
+        Summary summary = summarize(gpuHistory[s]);
+        file << "gpu," << getGpuSectionName(static_cast<GpuSection>(s)) << ','
+             << summary.samples << ',' << summary.average << ',' << summary.p50 << ','
+             << summary.p95 << ',' << summary.p99 << ',' << summary.max << '\n';
+    }
+
+    std::cout << "Timings written to " << path << std::endl;
+    return true;
+}
+
+FrameProfiler::Summary FrameProfiler::summarize(const History& history)
+{
+    return summarize(std::vector<float>(history.samples.begin(),
+                                        history.samples.begin() + history.count));
+}
+
+FrameProfiler::Summary FrameProfiler::summarize(std::vector<float> samples)
+{
+    Summary summary = Summary();
+    summary.samples = static_cast<int>(samples.size());
+    if (samples.empty())
+        return summary;
+
+    std::sort(samples.begin(), samples.end()); // A copy; the caller's order is kept
+
+    double total = 0.0;
+    for (size_t i = 0; i < samples.size(); ++i)
+        total += samples[i];
+
+    size_t last = samples.size() - 1;
+    summary.average = total / samples.size();
+    summary.p50 = samples[last * 50 / 100];
+    summary.p95 = samples[last * 95 / 100];
+    summary.p99 = samples[last * 99 / 100];
+    summary.max = samples[last];
+    return summary;
+}
+
+ScopedCpuTimer::ScopedCpuTimer(FrameProfiler& profiler, FrameProfiler::CpuSection section)
+    : profiler(profiler), section(section), start(std::chrono::steady_clock::now())
+{}
+
+ScopedCpuTimer::~ScopedCpuTimer()
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    profiler.addCpuSample(section, elapsed.count());
+}
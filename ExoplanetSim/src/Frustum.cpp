@@ -0,0 +1,78 @@
+// Frustum.cpp
+
+#include "Frustum.h"
+#include <cmath>
+
+Frustum::Frustum()
+    : planeCount(0)
+{}
+
+void Frustum::update(const glm::mat4& viewProjection)
+{
+    // Rows of the matrix (GLM is column-major)
+    glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    glm::vec4 candidates[6] = {
+        row3 + row0, // Left
+        row3 - row0, // Right
+        row3 + row1, // Bottom
+        row3 - row1, // Top
+        row3 + row2, // Near
+        row3 - row2  // Far
+    };
+
+    planeCount = 0;
+    for (int i = 0; i < 6; ++i) {
+        float length = glm::length(glm::vec3(candidates[i]));
+
+        // Skip degenerate planes (e.g. the far plane of an infinite projection)
+        if (length < 1e-6f)
+            continue;
+
+        planes[planeCount++] = candidates[i] / length;
+    }
+}
+
+bool Frustum::intersectsSphere(const BoundingSphere& sphere) const
+{
+    for (int i = 0; i < planeCount; ++i) {
+        float distance = glm::dot(glm::vec3(planes[i]), sphere.center) + planes[i].w;
+        if (distance < -sphere.radius)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsBox(const BoundingBox& box) const
+{
+    for (int i = 0; i < planeCount; ++i) {
+        // Corner of the box furthest along the plane normal
+        glm::vec3 positive(
+            planes[i].x >= 0.0f ? box.max.x : box.min.x,
+            planes[i].y >= 0.0f ? box.max.y : box.min.y,
+            planes[i].z >= 0.0f ? box.max.z : box.min.z
+        );
+        if (glm::dot(glm::vec3(planes[i]), positive) + planes[i].w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsAnnulus(const glm::vec3& center, float innerRadius, float outerRadius) const
+{
+    (void)innerRadius; // The hole never makes the annulus more visible
+
+    for (int i = 0; i < planeCount; ++i) {
+        // Extent of a disc in the XZ plane along the plane normal
+        float ny = planes[i].y;
+        float extent = outerRadius * std::sqrt(std::fmax(0.0f, 1.0f - ny * ny));
+
+        float distance = glm::dot(glm::vec3(planes[i]), center) + planes[i].w;
+        if (distance < -extent)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,161 @@
+// GLStateCache.cpp
+
+#include "GLStateCache.h"
+
+GLStateCache::GLStateCache()
+{
+    invalidate();
+}
+
+void GLStateCache::invalidate()
+{
+    program = 0;
+    vertexArray = 0;
+    activeUnit = 0;
+    programValid = vertexArrayValid = activeUnitValid = false;
+    for (int i = 0; i < MAX_TEXTURE_UNITS; ++i) {
+        textureTargets[i] = 0;
+        textures[i] = 0;
+        texturesValid[i] = false;
+    }
+    blend = -1;
+    blendSource = blendDestination = ~0u; // Not a GL enum; GL_ZERO is a real factor
+    depthFunc = 0;
+    depthMask = -1;
+    pointSize = -1.0f;
+    lineWidth = -1.0f;
+}
+
+void GLStateCache::useProgram(GLuint program)
+{
+    ++stats.requested;
+    if (programValid && this->program == program)
+        return;
+
+    glUseProgram(program);
+    this->program = program;
+    programValid = true;
+    ++stats.issued;
+}
+
+void GLStateCache::bindVertexArray(GLuint vao)
+{
+    ++stats.requested;
+    if (vertexArrayValid && vertexArray == vao)
+        return;
+
+    glBindVertexArray(vao);
+    vertexArray = vao;
+    vertexArrayValid = true;
+    ++stats.issued;
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    if (unit >= static_cast<GLuint>(MAX_TEXTURE_UNITS))
+        return;
+
+    ++stats.requested;
+    if (texturesValid[unit] && textureTargets[unit] == target && textures[unit] == texture)
+        return;
+
+    if (!activeUnitValid || activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+        activeUnitValid = true;
+        ++stats.issued;
+    }
+
+    glBindTexture(target, texture);
+    textureTargets[unit] = target;
+    textures[unit] = texture;
+    texturesValid[unit] = true;
+    ++stats.issued;
+}
+
+void GLStateCache::setBlend(bool enabled)
+{
+    ++stats.requested;
+    int value = enabled ? 1 : 0;
+    if (blend == value)
+        return;
+
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+    blend = value;
+    ++stats.issued;
+}
+
+void GLStateCache::setBlendFunc(GLenum source, GLenum destination)
+{
+    ++stats.requested;
+    if (blendSource == source && blendDestination == destination)
+        return;
+
+    glBlendFunc(source, destination);
+    blendSource = source;
+    blendDestination = destination;
+    ++stats.issued;
+}
+
+void GLStateCache::setDepthFunc(GLenum func)
+{
+    ++stats.requested;
+    if (depthFunc == func)
+        return;
+
+    glDepthFunc(func);
+    depthFunc = func;
+    ++stats.issued;
+}
+
+void GLStateCache::setDepthMask(bool enabled)
+{
+    ++stats.requested;
+    int value = enabled ? 1 : 0;
+    if (depthMask == value)
+        return;
+
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    depthMask = value;
+    ++stats.issued;
+}
+
+void GLStateCache::setPointSize(float size)
+{
+    ++stats.requested;
+    if (pointSize == size)
+        return;
+
+    glPointSize(size);
+    pointSize = size;
+    ++stats.issued;
+}
+
+void GLStateCache::setLineWidth(float width)
+{
+    ++stats.requested;
+    if (lineWidth == width)
+        return;
+
+    glLineWidth(width);
+    lineWidth = width;
+    ++stats.issued;
+}
+
+void GLStateCache::countDraw()
+{
+    ++stats.drawCalls;
+}
+
+const GLCallStats& GLStateCache::getStats() const
+{
+    return stats;
+}
+
+void GLStateCache::resetStats()
+{
+    stats = GLCallStats();
+}
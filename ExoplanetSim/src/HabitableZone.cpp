@@ -2,9 +2,11 @@
 
 #include "HabitableZone.h"
 
+#include <glm/gtc/matrix_transform.hpp>
+
 HabitableZone::HabitableZone(float innerRadius, float outerRadius,
                              Shader *shader)
-	: shader(shader) {
+	: shader(shader), innerRadius(innerRadius), outerRadius(outerRadius) {
 	ringMesh = new RingMesh(innerRadius, outerRadius);
 	modelMatrix = glm::mat4(1.0f); // Identity matrix
 }
@@ -13,27 +15,41 @@ HabitableZone::~HabitableZone() {
 	delete ringMesh;
 }
 
-void HabitableZone::Draw(const glm::mat4 &view, const glm::mat4 &projection) {
-	shader->use();
-	shader->setMat4("model", modelMatrix);
-	shader->setMat4("view", view);
-	shader->setMat4("projection", projection);
-
-	// Set color and transparency
-	shader->setVec4(
-		"color", glm::vec4(0.0f, 1.0f, 0.0f, 0.4f)); // Green color, 40% opacity
-
-	// Enable blending for transparency
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	ringMesh->Draw();
-
-	// Disable blending
-	glDisable(GL_BLEND);
+void HabitableZone::Record(RenderQueue &queue, float depth) const {
+	DrawCommand command;
+	command.shader = shader;
+	command.vertexArray = ringMesh->GetVAO();
+	command.count = ringMesh->GetIndexCount();
+	command.indexed = true;
+
+	glm::mat4 model = modelMatrix;
+	command.setUniforms = [model](const Shader &s) {
+		s.setMat4("model", model);
+		// Set color and transparency
+		s.setVec4("color", glm::vec4(0.0f, 1.0f, 0.0f, 0.4f)); // Green color, 40% opacity
+	};
+
+	// Blending is enabled by the habitable zone pass
+	queue.push(PASS_HABITABLE_ZONE, depth, command);
 }
 
+Shader *HabitableZone::GetShader() const { return shader; }
+
 void HabitableZone::UpdateRadii(float innerRadius, float outerRadius) {
+	// Called every frame; only rebuild the mesh when the radii change
+	if (innerRadius == this->innerRadius && outerRadius == this->outerRadius)
+		return;
+
+	this->innerRadius = innerRadius;
+	this->outerRadius = outerRadius;
 	delete ringMesh;
 	ringMesh = new RingMesh(innerRadius, outerRadius);
 }
+
+void HabitableZone::SetCenter(const glm::vec3 &center) {
+	modelMatrix = glm::translate(glm::mat4(1.0f), center);
+}
+
+float HabitableZone::GetInnerRadius() const { return innerRadius; }
+
+float HabitableZone::GetOuterRadius() const { return outerRadius; }
@@ -0,0 +1,123 @@
+// HeadlessContext.cpp
+
+#include "HeadlessContext.h"
+
+#include <iostream>
+
+#ifdef EXOSIM_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext()
+    : display(nullptr), context(nullptr)
+{}
+
+#ifdef EXOSIM_HAS_EGL
+
+HeadlessContext::~HeadlessContext()
+{
+    EGLDisplay eglDisplay = static_cast<EGLDisplay>(display);
+    if (eglDisplay == EGL_NO_DISPLAY)
+        return;
+
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != nullptr)
+        eglDestroyContext(eglDisplay, static_cast<EGLContext>(context));
+    eglTerminate(eglDisplay);
+}
+
+bool HeadlessContext::initialize()
+{
+    // Prefer the surfaceless platform: no X11/Wayland connection required
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay != nullptr)
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (eglDisplay == EGL_NO_DISPLAY)
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "Error: Failed to initialize EGL." << std::endl;
+        return false;
+    }
+    display = eglDisplay;
+
+    const EGLint configAttribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "Error: No suitable EGL config." << std::endl;
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "Error: EGL does not support desktop OpenGL." << std::endl;
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "Error: Failed to create an OpenGL 3.3 core EGL context." << std::endl;
+        return false;
+    }
+    context = eglContext;
+
+    // Surfaceless: everything is drawn into framebuffer objects
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        std::cerr << "Error: Failed to make the EGL context current "
+                     "(EGL_KHR_surfaceless_context required)." << std::endl;
+        return false;
+    }
+
+    std::cout << "Headless EGL " << major << "." << minor << " context created." << std::endl;
+    return true;
+}
+
+void* HeadlessContext::getProcAddress(const char* name)
+{
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+bool HeadlessContext::isAvailable()
+{
+    return true;
+}
+
+#else
+
+HeadlessContext::~HeadlessContext()
+{}
+
+bool HeadlessContext::initialize()
+{
+    std::cerr << "Error: Headless mode requires a build with EGL." << std::endl;
+    return false;
+}
+
+void* HeadlessContext::getProcAddress(const char* name)
+{
+    (void)name;
+    return nullptr;
+}
+
+bool HeadlessContext::isAvailable()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,592 @@
+// ImageWriter.cpp
+
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct CrcTable {
+    uint32_t values[256];
+
+    CrcTable()
+    {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+    }
+};
+
+// CRC-32 (PNG chunks); the table is a thread-safe function-local static
+uint32_t crc32(uint32_t crc, const unsigned char* data, size_t length)
+{
+    static const CrcTable table;
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i)
+        crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void putUint32(std::vector<unsigned char>& out, uint32_t value)
+{
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void writeChunk(FILE* file, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> header;
+    putUint32(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+    fwrite(&header[0], 1, header.size(), file);
+    if (!data.empty())
+        fwrite(&data[0], 1, data.size(), file);
+
+    uint32_t crc = crc32(0, reinterpret_cast<const unsigned char*>(type), 4);
+    if (!data.empty())
+        crc = crc32(crc, &data[0], data.size());
+    std::vector<unsigned char> trailer;
+    putUint32(trailer, crc);
+    fwrite(&trailer[0], 1, trailer.size(), file);
+}
+
+const unsigned char* sourceRow(const unsigned char* pixels, int y, int height,
+                               size_t stride, bool flipVertically)
+{
+    int row = flipVertically ? height - 1 - y : y;
+    return pixels + static_cast<size_t>(row) * stride;
+}
+
+// PNG filter types
+enum RowFilter {
+    FILTER_NONE = 0,
+    FILTER_SUB = 1,
+    FILTER_UP = 2,
+    FILTER_AVERAGE = 3,
+    FILTER_PAETH = 4
+};
+
+unsigned char paethPredictor(int left, int up, int upLeft)
+{
+    int estimate = left + up - upLeft;
+    int distanceLeft = std::abs(estimate - left);
+    int distanceUp = std::abs(estimate - up);
+    int distanceUpLeft = std::abs(estimate - upLeft);
+    if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft)
+        return static_cast<unsigned char>(left);
+    return static_cast<unsigned char>(distanceUp <= distanceUpLeft ? up : upLeft);
+}
+
+// One row with the given filter; previous is all zeros for the first row
+void filterRow(RowFilter filter, const unsigned char* row, const unsigned char* previous,
+               size_t stride, int bytesPerPixel, unsigned char* out)
+{
+    for (size_t i = 0; i < stride; ++i) {
+        int left = i >= static_cast<size_t>(bytesPerPixel) ? row[i - bytesPerPixel] : 0;
+        int up = previous[i];
+        int upLeft = i >= static_cast<size_t>(bytesPerPixel) ? previous[i - bytesPerPixel] : 0;
+        int predicted = 0;
+        switch (filter) {
+        case FILTER_NONE: predicted = 0; break;
+        case FILTER_SUB: predicted = left; break;
+        case FILTER_UP: predicted = up; break;
+        case FILTER_AVERAGE: predicted = (left + up) / 2; break;
+        case FILTER_PAETH: predicted = paethPredictor(left, up, upLeft); break;
+        }
+        out[i] = static_cast<unsigned char>(row[i] - predicted);
+    }
+}
+
+// Sum of the filtered bytes as signed values: the usual estimate of which
+// filter compresses a row best
+uint32_t filterCost(const unsigned char* filtered, size_t stride)
+{
+    uint32_t cost = 0;
+    for (size_t i = 0; i < stride; ++i)
+        cost += static_cast<uint32_t>(std::abs(static_cast<int>(static_cast<signed char>(filtered[i]))));
+    return cost;
+}
+
+// Deflate (RFC 1951): greedy LZ77 over a 32 KB window with hash chains,
+// then a dynamic Huffman code per block
+
+const int WINDOW_SIZE = 32768;
+const int MIN_MATCH = 3;
+const int MAX_MATCH = 258;
+const int HASH_BITS = 15;
+const int MAX_CHAIN = 32;           // Candidates tried per position
+const size_t BLOCK_TOKENS = 1 << 16;
+
+const int LENGTH_CODES = 29;
+const int DISTANCE_CODES = 30;
+const int LITERAL_LENGTH_SYMBOLS = 286; // 256 literals, end of block, length codes
+const int END_OF_BLOCK = 256;
+
+const uint16_t LENGTH_BASE[LENGTH_CODES] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const uint8_t LENGTH_EXTRA[LENGTH_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const uint16_t DISTANCE_BASE[DISTANCE_CODES] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const uint8_t DISTANCE_EXTRA[DISTANCE_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Order in which the code-length code lengths are stored
+const uint8_t CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// A literal (distance 0) or a match
+struct Token {
+    uint16_t value;    // Literal byte or match length
+    uint16_t distance;
+};
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : out(out), buffer(0), count(0) {}
+
+    // Plain values go least significant bit first
+    void put(uint32_t bits, int length)
+    {
+        buffer |= static_cast<uint64_t>(bits) << count;
+        count += length;
+        while (count >= 8) {
+            out.push_back(static_cast<unsigned char>(buffer));
+            buffer >>= 8;
+            count -= 8;
+        }
+    }
+
+    // Huffman codes go most significant bit first
+    void putCode(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i)
+            reversed |= ((code >> i) & 1u) << (length - 1 - i);
+        put(reversed, length);
+    }
+
+    void flush()
+    {
+        if (count > 0)
+            out.push_back(static_cast<unsigned char>(buffer));
+        buffer = 0;
+        count = 0;
+    }
+
+private:
+    std::vector<unsigned char>& out;
+    uint64_t buffer;
+    int count;
+};
+
+// Huffman code lengths for the frequencies, at most maxBits long. Over
+// the limit, the frequencies are flattened and the code rebuilt. Single
+// symbols get a partner so every code is complete.
+void buildCodeLengths(const std::vector<uint32_t>& frequencies, int maxBits, std::vector<uint8_t>& lengths)
+{
+    size_t count = frequencies.size();
+    lengths.assign(count, 0);
+
+    std::vector<uint32_t> weights(frequencies);
+    std::vector<int> used;
+    for (size_t i = 0; i < count; ++i) {
+        if (weights[i] > 0)
+            used.push_back(static_cast<int>(i));
+    }
+    if (used.empty())
+        return;
+    if (used.size() == 1) {
+        lengths[used[0]] = 1;
+        lengths[used[0] == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    for (;;) {
+        // Nodes 0..n-1 are leaves; parents are appended
+        typedef std::pair<uint32_t, int> Node; // Weight, index
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node> > queue;
+        std::vector<int> parent(used.size() * 2, -1);
+        for (size_t i = 0; i < used.size(); ++i)
+            queue.push(Node(weights[used[i]], static_cast<int>(i)));
+        int next = static_cast<int>(used.size());
+        while (queue.size() > 1) {
+            Node a = queue.top();
+            queue.pop();
+            Node b = queue.top();
+            queue.pop();
+            parent[a.second] = parent[b.second] = next;
+            queue.push(Node(a.first + b.first, next++));
+        }
+
+        // Parents come after their children, so depths fill in backwards
+        std::vector<int> depth(next, 0);
+        for (int node = next - 2; node >= 0; --node)
+            depth[node] = depth[parent[node]] + 1;
+
+        int longest = 0;
+        for (size_t i = 0; i < used.size(); ++i)
+            longest = std::max(longest, depth[i]);
+        if (longest <= maxBits) {
+            for (size_t i = 0; i < used.size(); ++i)
+                lengths[used[i]] = static_cast<uint8_t>(depth[i]);
+            return;
+        }
+        for (size_t i = 0; i < used.size(); ++i)
+            weights[used[i]] = (weights[used[i]] >> 1) | 1u;
+    }
+}
+
+// Canonical codes from the lengths (RFC 1951, 3.2.2)
+void assignCodes(const std::vector<uint8_t>& lengths, std::vector<uint16_t>& codes)
+{
+    int lengthCounts[16] = { 0 };
+    for (size_t i = 0; i < lengths.size(); ++i)
+        ++lengthCounts[lengths[i]];
+    lengthCounts[0] = 0;
+
+    int nextCode[16] = { 0 };
+    int code = 0;
+    for (int bits = 1; bits < 16; ++bits) {
+        code = (code + lengthCounts[bits - 1]) << 1;
+        nextCode[bits] = code;
+    }
+
+    codes.assign(lengths.size(), 0);
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        if (lengths[i] != 0)
+            codes[i] = static_cast<uint16_t>(nextCode[lengths[i]]++);
+    }
+}
+
+int lengthCode(int length)
+{
+    return static_cast<int>(std::upper_bound(LENGTH_BASE, LENGTH_BASE + LENGTH_CODES, length) - LENGTH_BASE) - 1;
+}
+
+int distanceCode(int distance)
+{
+    return static_cast<int>(std::upper_bound(DISTANCE_BASE, DISTANCE_BASE + DISTANCE_CODES, distance) -
+                            DISTANCE_BASE) - 1;
+}
+
+// Run-length coded code lengths (symbols 16-18 repeat), each entry a
+// symbol and its extra-bit value
+void encodeCodeLengths(const std::vector<uint8_t>& lengths, std::vector<std::pair<int, int> >& symbols)
+{
+    size_t i = 0;
+    while (i < lengths.size()) {
+        int value = lengths[i];
+        size_t run = 1;
+        while (i + run < lengths.size() && lengths[i + run] == value)
+            ++run;
+
+        if (value == 0 && run >= 3) {
+            size_t remaining = run;
+            while (remaining >= 11) {
+                size_t chunk = std::min<size_t>(remaining, 138);
+                symbols.push_back(std::make_pair(18, static_cast<int>(chunk - 11)));
+                remaining -= chunk;
+            }
+            if (remaining >= 3) {
+                symbols.push_back(std::make_pair(17, static_cast<int>(remaining - 3)));
+                remaining = 0;
+            }
+            for (; remaining > 0; --remaining)
+                symbols.push_back(std::make_pair(0, 0));
+        } else if (value != 0 && run >= 4) {
+            symbols.push_back(std::make_pair(value, 0));
+            size_t remaining = run - 1;
+            while (remaining >= 3) {
+                size_t chunk = std::min<size_t>(remaining, 6);
+                symbols.push_back(std::make_pair(16, static_cast<int>(chunk - 3)));
+                remaining -= chunk;
+            }
+            for (; remaining > 0; --remaining)
+                symbols.push_back(std::make_pair(value, 0));
+        } else {
+            for (size_t r = 0; r < run; ++r)
+                symbols.push_back(std::make_pair(value, 0));
+        }
+        i += run;
+    }
+}
+
+void writeBlock(BitWriter& bits, const std::vector<Token>& tokens, bool last)
+{
+    std::vector<uint32_t> literalFrequencies(LITERAL_LENGTH_SYMBOLS, 0);
+    std::vector<uint32_t> distanceFrequencies(DISTANCE_CODES, 0);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].distance == 0) {
+            ++literalFrequencies[tokens[i].value];
+        } else {
+            ++literalFrequencies[257 + lengthCode(tokens[i].value)];
+            ++distanceFrequencies[distanceCode(tokens[i].distance)];
+        }
+    }
+    literalFrequencies[END_OF_BLOCK] = 1;
+
+    std::vector<uint8_t> literalLengths, distanceLengths;
+    buildCodeLengths(literalFrequencies, 15, literalLengths);
+    buildCodeLengths(distanceFrequencies, 15, distanceLengths);
+    if (distanceLengths[0] == 0 && distanceLengths[1] == 0) {
+        // No matches: one unused distance code keeps decoders happy
+        distanceLengths[0] = 1;
+    }
+
+    int literalCount = LITERAL_LENGTH_SYMBOLS;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0)
+        --literalCount;
+    int distanceCount = DISTANCE_CODES;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0)
+        --distanceCount;
+
+    // Both code-length sequences are run-length coded as one
+    std::vector<uint8_t> allLengths(literalLengths.begin(), literalLengths.begin() + literalCount);
+    allLengths.insert(allLengths.end(), distanceLengths.begin(), distanceLengths.begin() + distanceCount);
+    std::vector<std::pair<int, int> > lengthSymbols;
+    encodeCodeLengths(allLengths, lengthSymbols);
+
+    std::vector<uint32_t> lengthFrequencies(19, 0);
+    for (size_t i = 0; i < lengthSymbols.size(); ++i)
+        ++lengthFrequencies[lengthSymbols[i].first];
+    std::vector<uint8_t> lengthLengths;
+    std::vector<uint16_t> lengthCodes;
+    buildCodeLengths(lengthFrequencies, 7, lengthLengths);
+    assignCodes(lengthLengths, lengthCodes);
+
+    int lengthCount = 19;
+    while (lengthCount > 4 && lengthLengths[CODE_LENGTH_ORDER[lengthCount - 1]] == 0)
+        --lengthCount;
+
+    bits.put(last ? 1 : 0, 1);
+    bits.put(2, 2); // Dynamic Huffman
+    bits.put(static_cast<uint32_t>(literalCount - 257), 5);
+    bits.put(static_cast<uint32_t>(distanceCount - 1), 5);
+    bits.put(static_cast<uint32_t>(lengthCount - 4), 4);
+    for (int i = 0; i < lengthCount; ++i)
+        bits.put(lengthLengths[CODE_LENGTH_ORDER[i]], 3);
+    for (size_t i = 0; i < lengthSymbols.size(); ++i) {
+        int symbol = lengthSymbols[i].first;
+        bits.putCode(lengthCodes[symbol], lengthLengths[symbol]);
+        if (symbol == 16)
+            bits.put(static_cast<uint32_t>(lengthSymbols[i].second), 2);
+        else if (symbol == 17)
+            bits.put(static_cast<uint32_t>(lengthSymbols[i].second), 3);
+        else if (symbol == 18)
+            bits.put(static_cast<uint32_t>(lengthSymbols[i].second), 7);
+    }
+
+    std::vector<uint16_t> literalCodes, distanceCodes;
+    assignCodes(literalLengths, literalCodes);
+    assignCodes(distanceLengths, distanceCodes);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.distance == 0) {
+            bits.putCode(literalCodes[token.value], literalLengths[token.value]);
+            continue;
+        }
+        int length = lengthCode(token.value);
+        bits.putCode(literalCodes[257 + length], literalLengths[257 + length]);
+        bits.put(static_cast<uint32_t>(token.value - LENGTH_BASE[length]), LENGTH_EXTRA[length]);
+        int distance = distanceCode(token.distance);
+        bits.putCode(distanceCodes[distance], distanceLengths[distance]);
+        bits.put(static_cast<uint32_t>(token.distance - DISTANCE_BASE[distance]), DISTANCE_EXTRA[distance]);
+    }
+    bits.putCode(literalCodes[END_OF_BLOCK], literalLengths[END_OF_BLOCK]);
+}
+
+// Hash of the three bytes a match starts with
+uint32_t hashAt(const unsigned char* p)
+{
+    return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & ((1u << HASH_BITS) - 1);
+}
+
+void deflate(const std::vector<unsigned char>& data, std::vector<unsigned char>& out)
+{
+    BitWriter bits(out);
+    const int size = static_cast<int>(data.size());
+    const unsigned char* bytes = data.empty() ? nullptr : &data[0];
+
+    // Newest position per hash of the next three bytes, and the previous
+    // position with the same hash per window slot
+    std::vector<int32_t> head(1 << HASH_BITS, -1);
+    std::vector<int32_t> previous(WINDOW_SIZE, -1);
+
+    std::vector<Token> tokens;
+    tokens.reserve(BLOCK_TOKENS);
+    int position = 0;
+    while (position < size) {
+        int bestLength = 0, bestDistance = 0;
+        if (position + MIN_MATCH <= size) {
+            uint32_t hash = hashAt(bytes + position);
+            int limit = std::min(MAX_MATCH, size - position);
+            int candidate = head[hash];
+            for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 &&
+                                position - candidate <= WINDOW_SIZE; ++chain) {
+                if (bytes[candidate + bestLength] == bytes[position + bestLength]) {
+                    int length = 0;
+                    while (length < limit && bytes[candidate + length] == bytes[position + length])
+                        ++length;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = position - candidate;
+                        if (length == limit)
+                            break;
+                    }
+                }
+                // A slot reused by a newer position ends the chain
+                int older = previous[candidate & (WINDOW_SIZE - 1)];
+                if (older >= candidate)
+                    break;
+                candidate = older;
+            }
+            previous[position & (WINDOW_SIZE - 1)] = head[hash];
+            head[hash] = position;
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            Token token = { static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance) };
+            tokens.push_back(token);
+            for (int i = 1; i < bestLength; ++i) {
+                int inserted = position + i;
+                if (inserted + MIN_MATCH > size)
+                    break;
+                uint32_t hash = hashAt(bytes + inserted);
+                previous[inserted & (WINDOW_SIZE - 1)] = head[hash];
+                head[hash] = inserted;
+            }
+            position += bestLength;
+        } else {
+            Token token = { bytes[position], 0 };
+            tokens.push_back(token);
+            ++position;
+        }
+
+        if (tokens.size() >= BLOCK_TOKENS) {
+            writeBlock(bits, tokens, position >= size);
+            tokens.clear();
+        }
+    }
+    if (!tokens.empty() || size == 0)
+        writeBlock(bits, tokens, true);
+    bits.flush();
+}
+
+}
+
+bool ImageWriter::writePng(const std::string& path, int width, int height, int channels,
+                           const unsigned char* pixels, bool flipVertically)
+{
+    static const unsigned char colorTypes[5] = { 0, 0, 4, 2, 6 };
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4 || pixels == nullptr)
+        return false;
+
+    // Filtered scanlines: each row with whichever filter looks cheapest
+    size_t stride = static_cast<size_t>(width) * channels;
+    std::vector<unsigned char> raw;
+    raw.reserve((stride + 1) * height);
+    std::vector<unsigned char> zeros(stride, 0), candidate(stride), best(stride);
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = sourceRow(pixels, y, height, stride, flipVertically);
+        const unsigned char* previous = y > 0 ? sourceRow(pixels, y - 1, height, stride, flipVertically)
+                                              : &zeros[0];
+        RowFilter bestFilter = FILTER_NONE;
+        uint32_t bestCost = 0;
+        for (int f = FILTER_NONE; f <= FILTER_PAETH; ++f) {
+            filterRow(static_cast<RowFilter>(f), row, previous, stride, channels, &candidate[0]);
+            uint32_t cost = filterCost(&candidate[0], stride);
+            if (f == FILTER_NONE || cost < bestCost) {
+                bestFilter = static_cast<RowFilter>(f);
+                bestCost = cost;
+                best.swap(candidate);
+            }
+        }
+        raw.push_back(static_cast<unsigned char>(bestFilter));
+        raw.insert(raw.end(), best.begin(), best.end());
+    }
+
+    // zlib stream: header (32 KB window, default level), deflate, Adler-32
+    std::vector<unsigned char> zlib;
+    zlib.reserve(raw.size() / 2 + 64);
+    zlib.push_back(0x78);
+    zlib.push_back(0x9C);
+    deflate(raw, zlib);
+
+    // Adler-32, reduced often enough to stay within 32 bits
+    uint32_t adlerA = 1, adlerB = 0;
+    for (size_t i = 0; i < raw.size(); i += 5552) {
+        size_t end = std::min(i + 5552, raw.size());
+        for (size_t j = i; j < end; ++j) {
+            adlerA += raw[j];
+            adlerB += adlerA;
+        }
+        adlerA %= 65521;
+        adlerB %= 65521;
+    }
+    putUint32(zlib, (adlerB << 16) | adlerA);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    fwrite(signature, 1, sizeof(signature), file);
+
+    std::vector<unsigned char> header;
+    putUint32(header, static_cast<uint32_t>(width));
+    putUint32(header, static_cast<uint32_t>(height));
+    header.push_back(8);                    // Bit depth
+    header.push_back(colorTypes[channels]); // Color type
+    header.push_back(0);                    // Compression
+    header.push_back(0);                    // Filter
+    header.push_back(0);                    // Interlace
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", std::vector<unsigned char>());
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+bool ImageWriter::writeRaw(const std::string& path, int width, int height, int channels,
+                           const unsigned char* pixels, bool flipVertically)
+{
+    if (width <= 0 || height <= 0 || channels < 1 || pixels == nullptr)
+        return false;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    size_t stride = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height; ++y)
+        fwrite(sourceRow(pixels, y, height, stride, flipVertically), 1, stride, file);
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
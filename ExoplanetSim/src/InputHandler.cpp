@@ -46,30 +46,81 @@ void InputHandler::processInput(GLFWwindow* window)
         mKeyPressed = false;
     }
 
+    // Toggle the debug overlay with 'F3' key
+    static bool f3KeyPressed = false;
+
+    if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS && !f3KeyPressed)
+    {
+        f3KeyPressed = true;
+        app->showDebugOverlay = !app->showDebugOverlay;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_RELEASE)
+    {
+        f3KeyPressed = false;
+    }
+
+    // Switch between the starfield and the cubemap skybox with 'B' key
+    static bool bKeyPressed = false;
+
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && !bKeyPressed && !io.WantCaptureKeyboard &&
+        !app->isReplaying())
+    {
+        bKeyPressed = true;
+        app->setParameter(Application::PARAM_SKYBOX, app->skyboxEnabled ? 0.0f : 1.0f);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_RELEASE)
+    {
+        bKeyPressed = false;
+    }
+
+    // Pause the simulation with 'P' key
+    static bool pKeyPressed = false;
+
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !pKeyPressed && !io.WantCaptureKeyboard &&
+        !app->isReplaying())
+    {
+        pKeyPressed = true;
+        app->setParameter(Application::PARAM_PAUSED, app->paused ? 0.0f : 1.0f);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE)
+    {
+        pKeyPressed = false;
+    }
+
     // Process keyboard input only if ImGui is not capturing it
     if (!io.WantCaptureKeyboard)
     {
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
 
+        // A replay drives the camera itself
+        if (app->isReplaying())
+            return;
+
         if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::FORWARD, app->deltaTime);
+            app->moveCamera(Camera::FORWARD, app->deltaTime);
         if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::BACKWARD, app->deltaTime);
+            app->moveCamera(Camera::BACKWARD, app->deltaTime);
         if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::LEFT, app->deltaTime);
+            app->moveCamera(Camera::LEFT, app->deltaTime);
         if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::RIGHT, app->deltaTime);
+            app->moveCamera(Camera::RIGHT, app->deltaTime);
         if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::DOWN, app->deltaTime);
+            app->moveCamera(Camera::DOWN, app->deltaTime);
         if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
-            app->camera.ProcessKeyboard(Camera::UP, app->deltaTime);
+            app->moveCamera(Camera::UP, app->deltaTime);
     }
 }
 
 void InputHandler::framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
+
+    if (instance)
+        instance->app->requestRedraw();
 }
 
 void InputHandler::mouse_callback(GLFWwindow* window, double xpos, double ypos)
@@ -81,8 +132,9 @@ void InputHandler::mouse_callback(GLFWwindow* window, double xpos, double ypos)
         return;
 
     Application* app = instance->app;
+    app->requestRedraw();
 
-    if (app->cursorEnabled)
+    if (app->cursorEnabled || app->isReplaying())
         return; // Do not process mouse movement when cursor is visible
 
     if (app->firstMouse)
@@ -99,7 +151,7 @@ void InputHandler::mouse_callback(GLFWwindow* window, double xpos, double ypos)
     app->lastX = static_cast<float>(xpos);
     app->lastY = static_cast<float>(ypos);
 
-    app->camera.ProcessMouseMovement(xoffset, yoffset);
+    app->turnCamera(xoffset, yoffset);
 }
 
 void InputHandler::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
@@ -111,27 +163,44 @@ void InputHandler::scroll_callback(GLFWwindow* window, double xoffset, double yo
         return;
 
     Application* app = instance->app;
+    app->requestRedraw();
 
-    if (app->cursorEnabled)
+    if (app->cursorEnabled || app->isReplaying())
         return; // Do not process scroll when cursor is visible
 
-    app->camera.ProcessMouseScroll(static_cast<float>(yoffset));
+    app->zoomCamera(static_cast<float>(yoffset));
 }
 
 void InputHandler::key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
     // Forward key events to ImGui
     ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
+
+    if (instance)
+        instance->app->requestRedraw();
 }
 
 void InputHandler::char_callback(GLFWwindow* window, unsigned int c)
 {
     // Forward character input to ImGui
     ImGui_ImplGlfw_CharCallback(window, c);
+
+    if (instance)
+        instance->app->requestRedraw();
 }
 
 void InputHandler::mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
     // Forward mouse button events to ImGui
     ImGui_ImplGlfw_MouseButtonCallback(window, button, action, mods);
+
+    if (instance)
+        instance->app->requestRedraw();
+}
+
+void InputHandler::refresh_callback(GLFWwindow*)
+{
+    // The window was exposed or damaged; its contents must be redrawn
+    if (instance)
+        instance->app->requestRedraw();
 }
@@ -0,0 +1,182 @@
+// KtxFile.cpp
+
+#include "KtxFile.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const unsigned char IDENTIFIER[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+const uint32_t ENDIANNESS = 0x04030201;
+
+struct Header {
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+uint32_t swap32(uint32_t value)
+{
+    return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+}
+
+size_t padding4(size_t size)
+{
+    return (4 - size % 4) % 4;
+}
+
+}
+
+int KtxFile::getLevelWidth(int level) const
+{
+    int w = width >> level;
+    return w > 0 ? w : 1;
+}
+
+int KtxFile::getLevelHeight(int level) const
+{
+    int h = height >> level;
+    return h > 0 ? h : 1;
+}
+
+size_t KtxFile::getTotalSize() const
+{
+    size_t total = 0;
+    for (size_t level = 0; level < levels.size(); ++level)
+        for (size_t face = 0; face < levels[level].size(); ++face)
+            total += levels[level][face].size();
+    return total;
+}
+
+bool KtxFile::read(const std::string& path, std::string& error)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error = "cannot open file";
+        return false;
+    }
+
+    unsigned char identifier[12];
+    Header header;
+    if (fread(identifier, 1, sizeof(identifier), file) != sizeof(identifier) ||
+        std::memcmp(identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0 ||
+        fread(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        error = "not a KTX 1.1 file";
+        return false;
+    }
+
+    // Files written on a machine of the other endianness
+    bool swap = header.endianness != ENDIANNESS;
+    if (swap) {
+        uint32_t* fields = reinterpret_cast<uint32_t*>(&header);
+        for (size_t i = 0; i < sizeof(header) / sizeof(uint32_t); ++i)
+            fields[i] = swap32(fields[i]);
+    }
+
+    if (header.glType != 0 || header.pixelDepth > 1 || header.numberOfArrayElements > 1 ||
+        (header.numberOfFaces != 1 && header.numberOfFaces != 6)) {
+        fclose(file);
+        error = "only compressed 2D textures and cubemaps are supported";
+        return false;
+    }
+
+    internalFormat = header.glInternalFormat;
+    baseInternalFormat = header.glBaseInternalFormat;
+    width = static_cast<int>(header.pixelWidth);
+    height = static_cast<int>(header.pixelHeight > 0 ? header.pixelHeight : 1);
+    faces = static_cast<int>(header.numberOfFaces);
+    int levelCount = header.numberOfMipmapLevels > 0 ? static_cast<int>(header.numberOfMipmapLevels) : 1;
+
+    fseek(file, static_cast<long>(header.bytesOfKeyValueData), SEEK_CUR);
+
+    levels.assign(levelCount, std::vector<std::vector<unsigned char> >(faces));
+    for (int level = 0; level < levelCount; ++level) {
+        uint32_t imageSize = 0;
+        if (fread(&imageSize, sizeof(imageSize), 1, file) != 1) {
+            fclose(file);
+            error = "truncated file";
+            return false;
+        }
+        if (swap)
+            imageSize = swap32(imageSize);
+
+        // For non-array cubemaps imageSize is the size of one face
+        for (int face = 0; face < faces; ++face) {
+            std::vector<unsigned char>& data = levels[level][face];
+            data.resize(imageSize);
+            if (imageSize > 0 && fread(&data[0], 1, imageSize, file) != imageSize) {
+                fclose(file);
+                error = "truncated file";
+                return false;
+            }
+            if (faces == 6)
+                fseek(file, static_cast<long>(padding4(imageSize)), SEEK_CUR); // cubePadding
+        }
+        fseek(file, static_cast<long>(padding4(imageSize)), SEEK_CUR); // mipPadding
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool KtxFile::write(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    Header header;
+    header.endianness = ENDIANNESS;
+    header.glType = 0;     // Compressed
+    header.glTypeSize = 1;
+    header.glFormat = 0;   // Compressed
+    header.glInternalFormat = internalFormat;
+    header.glBaseInternalFormat = baseInternalFormat;
+    header.pixelWidth = static_cast<uint32_t>(width);
+    header.pixelHeight = static_cast<uint32_t>(height);
+    header.pixelDepth = 0;
+    header.numberOfArrayElements = 0;
+    header.numberOfFaces = static_cast<uint32_t>(faces);
+    header.numberOfMipmapLevels = static_cast<uint32_t>(levels.size());
+    header.bytesOfKeyValueData = 0;
+
+    fwrite(IDENTIFIER, 1, sizeof(IDENTIFIER), file);
+    fwrite(&header, sizeof(header), 1, file);
+
+    static const unsigned char zeros[4] = { 0, 0, 0, 0 };
+    for (size_t level = 0; level < levels.size(); ++level) {
+        uint32_t imageSize = static_cast<uint32_t>(levels[level][0].size());
+        fwrite(&imageSize, sizeof(imageSize), 1, file);
+        for (size_t face = 0; face < levels[level].size(); ++face) {
+            const std::vector<unsigned char>& data = levels[level][face];
+            if (!data.empty())
+                fwrite(&data[0], 1, data.size(), file);
+            if (faces == 6)
+                fwrite(zeros, 1, padding4(data.size()), file); // cubePadding
+        }
+        fwrite(zeros, 1, padding4(imageSize), file); // mipPadding
+    }
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+bool KtxFile::isKtxPath(const std::string& path)
+{
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".ktx") == 0;
+}
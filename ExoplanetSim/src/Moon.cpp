@@ -0,0 +1,52 @@
+// Moon.cpp
+
+#include "Moon.h"
+
+Moon::Moon(float radius, float distance, float period, float phase,
+           float inclination, const glm::vec3& color)
+    : MoonModel(radius, distance, period, phase, inclination),
+      sphereMesh(1.0f, 36, 18), // Unit sphere, scaled by the model matrix
+      textureID(0)
+{
+    unsigned char texel[3] = {
+        static_cast<unsigned char>(glm::clamp(color.r, 0.0f, 1.0f) * 255.0f),
+        static_cast<unsigned char>(glm::clamp(color.g, 0.0f, 1.0f) * 255.0f),
+        static_cast<unsigned char>(glm::clamp(color.b, 0.0f, 1.0f) * 255.0f)
+    };
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, texel);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+Moon::~Moon()
+{
+    glDeleteTextures(1, &textureID);
+}
+
+void Moon::record(RenderQueue& queue, const Shader& shader, const glm::mat4& model,
+                  float depth, int occluderIndex) const
+{
+    DrawCommand command;
+    command.shader = &shader;
+    command.textureTarget = GL_TEXTURE_2D;
+    command.texture = textureID;
+    command.vertexArray = sphereMesh.getVAO();
+    command.count = static_cast<GLsizei>(sphereMesh.getIndexCount());
+    command.indexed = true;
+    command.setUniforms = [model, occluderIndex](const Shader& s) {
+        s.setMat4("model", model);
+        s.setInt("selfOccluder", occluderIndex);
+    };
+
+    queue.push(PASS_PLANETS, depth, command);
+}
+
+void Moon::setMeshResolution(unsigned int sectors, unsigned int stacks)
+{
+    sphereMesh.setResolution(sectors, stacks);
+}
@@ -0,0 +1,318 @@
+// OrbitBatch.cpp
+
+#include "OrbitBatch.h"
+
+#include <algorithm>
+
+namespace {
+
+// Initial room in the shared buffer, in vertices
+const GLsizei INITIAL_CAPACITY = 4096;
+
+} // namespace
+
+OrbitBatch::OrbitBatch()
+    : VAO(0), vertexBuffer(0), orbitIdBuffer(0), vertexTexture(0), orbitIdTexture(0),
+      vertexCapacity(0), vertexEnd(0), stateBuffer(0), stateTexture(0), stateDirty(true)
+{
+    glGenVertexArrays(1, &VAO);
+    glGenTextures(1, &vertexTexture);
+    glGenTextures(1, &orbitIdTexture);
+    grow(INITIAL_CAPACITY);
+
+    glGenBuffers(1, &stateBuffer);
+    glGenTextures(1, &stateTexture);
+    glBindBuffer(GL_TEXTURE_BUFFER, stateBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, 4 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, stateTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, stateBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+OrbitBatch::~OrbitBatch()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &orbitIdBuffer);
+    glDeleteTextures(1, &vertexTexture);
+    glDeleteTextures(1, &orbitIdTexture);
+    glDeleteTextures(1, &stateTexture);
+    glDeleteBuffers(1, &stateBuffer);
+}
+
+int OrbitBatch::add(const std::vector<glm::vec3>& path)
+{
+    // Reuse the handle of a removed orbit
+    int orbit = 0;
+    while (orbit < static_cast<int>(orbits.size()) && orbits[orbit].used)
+        ++orbit;
+    if (orbit == static_cast<int>(orbits.size())) {
+        orbits.push_back(Orbit());
+        state.resize(orbits.size() * TEXELS_PER_ORBIT * 4, 0.0f);
+    }
+
+    Orbit& entry = orbits[orbit];
+    entry.used = true;
+    entry.visible = true;
+    entry.count = static_cast<GLsizei>(path.size());
+    entry.first = allocate(entry.count, entry.capacity);
+
+    setOrigin(orbit, glm::vec3(0.0f));
+    setPhase(orbit, 0.0f);
+    setColors(orbit, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f)); // Red traveled, white ahead
+    setStyle(orbit, 2.0f, 0);
+    writeVertices(orbit, path);
+    return orbit;
+}
+
+void OrbitBatch::remove(int orbit)
+{
+    Orbit& entry = orbits[orbit];
+    if (!entry.used)
+        return;
+    release(entry.first, entry.capacity);
+    entry.used = false;
+    entry.count = 0;
+    entry.capacity = 0;
+}
+
+void OrbitBatch::setPath(int orbit, const std::vector<glm::vec3>& path)
+{
+    Orbit& entry = orbits[orbit];
+    GLsizei count = static_cast<GLsizei>(path.size());
+    if (count > entry.capacity) {
+        release(entry.first, entry.capacity);
+        entry.first = allocate(count, entry.capacity);
+    }
+    entry.count = count;
+    writeVertices(orbit, path);
+}
+
+void OrbitBatch::setOrigin(int orbit, const glm::vec3& cameraRelativeCenter)
+{
+    float* texels = getState(orbit);
+    texels[0] = cameraRelativeCenter.x;
+    texels[1] = cameraRelativeCenter.y;
+    texels[2] = cameraRelativeCenter.z;
+    stateDirty = true;
+}
+
+void OrbitBatch::setPhase(int orbit, float phase)
+{
+    getState(orbit)[3] = phase;
+    stateDirty = true;
+}
+
+void OrbitBatch::setVisible(int orbit, bool visible)
+{
+    orbits[orbit].visible = visible;
+}
+
+void OrbitBatch::setColors(int orbit, const glm::vec3& completed, const glm::vec3& upcoming)
+{
+    float* texels = getState(orbit);
+    texels[4] = completed.r;
+    texels[5] = completed.g;
+    texels[6] = completed.b;
+    texels[8] = upcoming.r;
+    texels[9] = upcoming.g;
+    texels[10] = upcoming.b;
+    stateDirty = true;
+}
+
+void OrbitBatch::setStyle(int orbit, float width, int dashCount)
+{
+    float* texels = getState(orbit);
+    texels[7] = width;
+    texels[11] = static_cast<float>(dashCount);
+    stateDirty = true;
+}
+
+void OrbitBatch::record(RenderQueue& queue, const Shader& shader)
+{
+    // One range per orbit in segment-vertex space: gl_VertexID / 6 is the
+    // index of the segment's first point in the shared buffer
+    firsts.clear();
+    counts.clear();
+    for (size_t i = 0; i < orbits.size(); ++i) {
+        const Orbit& entry = orbits[i];
+        if (entry.used && entry.visible && entry.count > 1) {
+            firsts.push_back(entry.first * VERTICES_PER_SEGMENT);
+            counts.push_back((entry.count - 1) * VERTICES_PER_SEGMENT);
+        }
+    }
+    if (firsts.empty())
+        return;
+
+    // Centers move with the camera every frame; the whole table is small
+    if (stateDirty) {
+        glBindBuffer(GL_TEXTURE_BUFFER, stateBuffer);
+        glBufferData(GL_TEXTURE_BUFFER, state.size() * sizeof(float), &state[0], GL_STREAM_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        stateDirty = false;
+    }
+
+    DrawCommand command;
+    command.shader = &shader;
+    command.textureTarget = GL_TEXTURE_BUFFER;
+    command.texture = stateTexture;
+    command.extraTextureTargets[0] = GL_TEXTURE_BUFFER;
+    command.extraTextures[0] = vertexTexture;
+    command.extraTextureTargets[1] = GL_TEXTURE_BUFFER;
+    command.extraTextures[1] = orbitIdTexture;
+    command.vertexArray = VAO;
+    command.primitive = GL_TRIANGLES;
+    command.firsts = &firsts[0];
+    command.counts = &counts[0];
+    command.drawCount = static_cast<GLsizei>(firsts.size());
+    queue.push(PASS_ORBITS, 0.0f, command);
+}
+
+int OrbitBatch::getOrbitCount() const
+{
+    int count = 0;
+    for (size_t i = 0; i < orbits.size(); ++i)
+        count += orbits[i].used ? 1 : 0;
+    return count;
+}
+
+int OrbitBatch::getVisibleCount() const
+{
+    return static_cast<int>(firsts.size());
+}
+
+size_t OrbitBatch::getVertexCapacity() const
+{
+    return static_cast<size_t>(vertexCapacity);
+}
+
+GLint OrbitBatch::allocate(GLsizei count, GLsizei& capacity)
+{
+    capacity = count;
+
+    // First fit; the remainder of the block stays free
+    for (size_t i = 0; i < freeBlocks.size(); ++i) {
+        Block& block = freeBlocks[i];
+        if (block.capacity < count)
+            continue;
+        GLint first = block.first;
+        block.first += count;
+        block.capacity -= count;
+        if (block.capacity == 0)
+            freeBlocks.erase(freeBlocks.begin() + i);
+        return first;
+    }
+
+    if (vertexEnd + count > vertexCapacity)
+        grow(std::max(vertexCapacity * 2, vertexEnd + count));
+    GLint first = vertexEnd;
+    vertexEnd += count;
+    return first;
+}
+
+void OrbitBatch::release(GLint first, GLsizei capacity)
+{
+    if (capacity <= 0)
+        return;
+
+    Block block;
+    block.first = first;
+    block.capacity = capacity;
+    freeBlocks.push_back(block);
+    std::sort(freeBlocks.begin(), freeBlocks.end(),
+              [](const Block& a, const Block& b) { return a.first < b.first; });
+
+    // Merge neighbours so large paths can reuse the space
+    std::vector<Block> merged;
+    for (size_t i = 0; i < freeBlocks.size(); ++i) {
+        if (!merged.empty() && merged.back().first + merged.back().capacity == freeBlocks[i].first)
+            merged.back().capacity += freeBlocks[i].capacity;
+        else
+            merged.push_back(freeBlocks[i]);
+    }
+
+    // A free tail just lowers the high-water mark
+    if (!merged.empty() && merged.back().first + merged.back().capacity == vertexEnd) {
+        vertexEnd = merged.back().first;
+        merged.pop_back();
+    }
+    freeBlocks.swap(merged);
+}
+
+void OrbitBatch::grow(GLsizei minimumCapacity)
+{
+    GLuint newVertices, newIds;
+    glGenBuffers(1, &newVertices);
+    glGenBuffers(1, &newIds);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newVertices);
+    glBufferData(GL_COPY_WRITE_BUFFER, minimumCapacity * 4 * sizeof(float), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newIds);
+    glBufferData(GL_COPY_WRITE_BUFFER, minimumCapacity * sizeof(GLint), nullptr, GL_STATIC_DRAW);
+
+    // Existing ranges keep their offsets
+    if (vertexEnd > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, vertexBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newVertices);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            vertexEnd * 4 * sizeof(float));
+        glBindBuffer(GL_COPY_READ_BUFFER, orbitIdBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, newIds);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                            vertexEnd * sizeof(GLint));
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &orbitIdBuffer);
+    vertexBuffer = newVertices;
+    orbitIdBuffer = newIds;
+    vertexCapacity = minimumCapacity;
+
+    // Point the texture buffer views at the new storage
+    glBindTexture(GL_TEXTURE_BUFFER, vertexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, vertexBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, orbitIdTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, orbitIdBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void OrbitBatch::writeVertices(int orbit, const std::vector<glm::vec3>& path)
+{
+    const Orbit& entry = orbits[orbit];
+    if (entry.count == 0)
+        return;
+
+    // Phase runs from 0 at the first point to 1 at the last
+    std::vector<float> vertices(path.size() * 4);
+    float step = path.size() > 1 ? 1.0f / static_cast<float>(path.size() - 1) : 0.0f;
+    for (size_t i = 0; i < path.size(); ++i) {
+        vertices[i * 4 + 0] = path[i].x;
+        vertices[i * 4 + 1] = path[i].y;
+        vertices[i * 4 + 2] = path[i].z;
+        vertices[i * 4 + 3] = static_cast<float>(i) * step;
+    }
+    std::vector<GLint> ids(path.size(), orbit);
+
+    // The shader needs the range for joins; a closed loop joins its ends
+    float* texels = getState(orbit);
+    texels[12] = static_cast<float>(entry.first);
+    texels[13] = static_cast<float>(entry.count);
+    float gap = glm::length(path.front() - path.back());
+    texels[14] = gap <= 1e-3f * glm::length(path.front()) ? 1.0f : 0.0f;
+    stateDirty = true;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, entry.first * 4 * sizeof(float),
+                    vertices.size() * sizeof(float), &vertices[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, orbitIdBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, entry.first * sizeof(GLint), ids.size() * sizeof(GLint), &ids[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+float* OrbitBatch::getState(int orbit)
+{
+    return &state[static_cast<size_t>(orbit) * TEXELS_PER_ORBIT * 4];
+}
@@ -0,0 +1,417 @@
+// PlanetTextureGenerator.cpp
+
+#include "PlanetTextureGenerator.h"
+#include "ImageWriter.h"
+#include "stb_image.h"
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+namespace {
+
+const float PI = 3.14159265358979f;
+
+// Rows per task; enough work per task to amortize the queue
+const int ROWS_PER_TASK = 16;
+
+struct Color {
+    float r, g, b;
+    Color(float r, float g, float b) : r(r), g(g), b(b) {}
+};
+
+Color mixColor(const Color& a, const Color& b, float t)
+{
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    return Color(a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t);
+}
+
+float smoothStep(float edge0, float edge1, float x)
+{
+    float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Improved Perlin gradient noise with a seeded permutation table
+class Noise3D {
+public:
+    explicit Noise3D(unsigned int seed)
+    {
+        for (int i = 0; i < 256; ++i)
+            perm[i] = i;
+        std::mt19937 rng(seed);
+        std::shuffle(perm, perm + 256, rng);
+        for (int i = 0; i < 256; ++i)
+            perm[256 + i] = perm[i];
+    }
+
+    // Roughly in [-1, 1]
+    float noise(float x, float y, float z) const
+    {
+        float fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+        int X = static_cast<int>(fx) & 255;
+        int Y = static_cast<int>(fy) & 255;
+        int Z = static_cast<int>(fz) & 255;
+        x -= fx;
+        y -= fy;
+        z -= fz;
+        float u = fade(x), v = fade(y), w = fade(z);
+
+        int A = perm[X] + Y, AA = perm[A] + Z, AB = perm[A + 1] + Z;
+        int B = perm[X + 1] + Y, BA = perm[B] + Z, BB = perm[B + 1] + Z;
+
+        return lerp(w,
+                    lerp(v, lerp(u, grad(perm[AA], x, y, z), grad(perm[BA], x - 1, y, z)),
+                            lerp(u, grad(perm[AB], x, y - 1, z), grad(perm[BB], x - 1, y - 1, z))),
+                    lerp(v, lerp(u, grad(perm[AA + 1], x, y, z - 1), grad(perm[BA + 1], x - 1, y, z - 1)),
+                            lerp(u, grad(perm[AB + 1], x, y - 1, z - 1), grad(perm[BB + 1], x - 1, y - 1, z - 1))));
+    }
+
+    // Fractal Brownian motion, normalized to roughly [-1, 1]
+    float fbm(float x, float y, float z, int octaves, float lacunarity = 2.0f, float gain = 0.5f) const
+    {
+        float sum = 0.0f, amplitude = 1.0f, total = 0.0f;
+        for (int i = 0; i < octaves; ++i) {
+            sum += amplitude * noise(x, y, z);
+            total += amplitude;
+            x *= lacunarity;
+            y *= lacunarity;
+            z *= lacunarity;
+            amplitude *= gain;
+        }
+        return sum / total;
+    }
+
+    // Sharp creases where the noise crosses zero, in [0, 1]
+    float ridged(float x, float y, float z, int octaves) const
+    {
+        float sum = 0.0f, amplitude = 0.5f, total = 0.0f;
+        for (int i = 0; i < octaves; ++i) {
+            float n = 1.0f - std::fabs(noise(x, y, z));
+            sum += amplitude * n * n;
+            total += amplitude;
+            x *= 2.0f;
+            y *= 2.0f;
+            z *= 2.0f;
+            amplitude *= 0.5f;
+        }
+        return sum / total;
+    }
+
+private:
+    int perm[512];
+
+    static float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+    static float lerp(float t, float a, float b) { return a + t * (b - a); }
+
+    static float grad(int hash, float x, float y, float z)
+    {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+};
+
+// Point on the unit sphere plus latitude, matching SphereMesh texture
+// coordinates (t = 0 at the +z pole, s along the longitude)
+struct SurfacePoint {
+    float x, y, z;
+    float latitude;  // -pi/2 .. pi/2
+    float longitude; // 0 .. 2pi
+};
+
+// Per-map constants shared by every pixel
+struct Surface {
+    const Noise3D& noise;
+    float temperature;
+    float stormLatitude;
+    float stormLongitude;
+
+    Surface(const Noise3D& noise, float temperature, unsigned int seed)
+        : noise(noise), temperature(temperature)
+    {
+        std::mt19937 rng(seed ^ 0x9E3779B9u);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        stormLatitude = (unit(rng) * 0.8f - 0.4f) * PI * 0.5f;
+        stormLongitude = unit(rng) * 2.0f * PI;
+    }
+};
+
+Color terrestrialColor(const Surface& surface, const SurfacePoint& p)
+{
+    const Noise3D& noise = surface.noise;
+    float temperature = surface.temperature;
+
+    // Warmer worlds have less ocean and smaller ice caps
+    float seaLevel = 0.05f - smoothStep(300.0f, 400.0f, temperature) * 0.6f;
+    float iceLatitude = 0.35f + smoothStep(150.0f, 330.0f, temperature) * 0.55f; // fraction of pi/2
+
+    float elevation = noise.fbm(p.x * 1.8f, p.y * 1.8f, p.z * 1.8f, 7);
+    float moisture = noise.fbm(p.x * 2.5f + 31.7f, p.y * 2.5f, p.z * 2.5f, 4);
+
+    Color color(0, 0, 0);
+    if (elevation < seaLevel) {
+        float depth = smoothStep(seaLevel - 0.4f, seaLevel, elevation);
+        color = mixColor(Color(0.02f, 0.06f, 0.25f), Color(0.08f, 0.30f, 0.55f), depth);
+    } else {
+        float height = (elevation - seaLevel) / (1.0f - seaLevel);
+        Color lowland = mixColor(Color(0.62f, 0.52f, 0.33f), Color(0.16f, 0.38f, 0.12f),
+                                 smoothStep(-0.2f, 0.3f, moisture) * (1.0f - smoothStep(320.0f, 380.0f, temperature)));
+        color = mixColor(lowland, Color(0.42f, 0.34f, 0.25f), smoothStep(0.05f, 0.35f, height));
+        color = mixColor(color, Color(0.55f, 0.53f, 0.50f), smoothStep(0.35f, 0.6f, height));
+        if (temperature < 330.0f)
+            color = mixColor(color, Color(0.95f, 0.95f, 0.97f), smoothStep(0.55f, 0.7f, height));
+    }
+
+    // Polar caps with a noisy edge
+    float polar = std::fabs(p.latitude) / (PI * 0.5f) + noise.fbm(p.x * 4.0f, p.y * 4.0f, p.z * 4.0f, 3) * 0.08f;
+    color = mixColor(color, Color(0.92f, 0.95f, 0.98f), smoothStep(iceLatitude, iceLatitude + 0.04f, polar));
+    return color;
+}
+
+Color gasGiantColor(const Surface& surface, const SurfacePoint& p)
+{
+    const Noise3D& noise = surface.noise;
+    float temperature = surface.temperature;
+
+    // Palette by temperature: ice giant blue, Jovian tan, hot Jupiter dark red
+    Color light(0.85f, 0.78f, 0.62f), dark(0.60f, 0.40f, 0.25f);
+    if (temperature < 150.0f) {
+        light = Color(0.62f, 0.82f, 0.92f);
+        dark = Color(0.25f, 0.45f, 0.75f);
+    } else if (temperature > 1000.0f) {
+        light = Color(0.55f, 0.28f, 0.18f);
+        dark = Color(0.18f, 0.08f, 0.08f);
+    }
+
+    // Latitude bands displaced by turbulence
+    float turbulence = noise.fbm(p.x * 3.0f, p.y * 3.0f, p.z * 12.0f, 5);
+    float band = std::sin(p.latitude * 14.0f + turbulence * 2.5f) * 0.5f + 0.5f;
+    float detail = noise.fbm(p.x * 6.0f, p.y * 6.0f, p.z * 30.0f, 4) * 0.15f;
+    Color color = mixColor(dark, light, band + detail);
+
+    // One large oval storm at a seeded position, elongated along the bands
+    float dLongitude = std::fabs(p.longitude - surface.stormLongitude);
+    dLongitude = std::min(dLongitude, 2.0f * PI - dLongitude) * std::cos(p.latitude);
+    float dLatitude = (p.latitude - surface.stormLatitude) * 2.0f;
+    float stormDistance = std::sqrt(dLongitude * dLongitude + dLatitude * dLatitude);
+    color = mixColor(color, Color(dark.r * 1.2f, dark.g * 0.8f, dark.b * 0.7f),
+                     1.0f - smoothStep(0.12f, 0.22f, stormDistance + turbulence * 0.05f));
+    return color;
+}
+
+Color icyColor(const Surface& surface, const SurfacePoint& p)
+{
+    const Noise3D& noise = surface.noise;
+    float temperature = surface.temperature;
+
+    float base = noise.fbm(p.x * 2.0f, p.y * 2.0f, p.z * 2.0f, 5);
+    Color color = mixColor(Color(0.70f, 0.78f, 0.85f), Color(0.95f, 0.97f, 1.0f), base * 0.5f + 0.5f);
+
+    // Fracture lines (ridged noise) tinted by deposits, redder when warmer
+    float cracks = noise.ridged(p.x * 3.0f, p.y * 3.0f, p.z * 3.0f, 5);
+    Color deposit = mixColor(Color(0.35f, 0.45f, 0.60f), Color(0.55f, 0.35f, 0.25f),
+                             smoothStep(80.0f, 200.0f, temperature));
+    return mixColor(color, deposit, smoothStep(0.75f, 0.95f, cracks));
+}
+
+std::string toLower(const std::string& text)
+{
+    std::string lower = text;
+    for (size_t i = 0; i < lower.size(); ++i)
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(lower[i])));
+    return lower;
+}
+
+// mkdir -p
+bool makeDirectories(const std::string& path)
+{
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i < path.size() && path[i] != '/')
+            continue;
+        std::string partial = path.substr(0, i);
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST)
+            return false;
+    }
+    return true;
+}
+
+}
+
+std::string PlanetSurfaceParams::getCacheKey() const
+{
+    // Readable and file-name safe
+    std::string type;
+    for (size_t i = 0; i < planetType.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(planetType[i]);
+        type += std::isalnum(c) ? static_cast<char>(std::tolower(c)) : '_';
+    }
+
+    std::ostringstream key;
+    // Exact temperature (9 digits round-trip a float): a rounded one
+    // would hand back a map generated for a slightly different planet
+    key << type << "_" << std::setprecision(9) << temperature << "K_s" << seed
+        << "_" << width << "x" << height << "_v" << PlanetTextureGenerator::GENERATOR_VERSION << ".png";
+    return key.str();
+}
+
+PlanetTextureGenerator::PlanetTextureGenerator(ThreadPool& pool, const std::string& cacheDirectory)
+    : pool(pool), cacheDirectory(cacheDirectory)
+{}
+
+PlanetTextureGenerator::SurfaceStyle PlanetTextureGenerator::chooseStyle(const std::string& planetType,
+                                                                         float temperature)
+{
+    std::string type = toLower(planetType);
+    if (type.find("gas") != std::string::npos || type.find("giant") != std::string::npos ||
+        type.find("jovian") != std::string::npos || type.find("neptun") != std::string::npos)
+        return SURFACE_GAS_GIANT;
+    if (type.find("ice") != std::string::npos || type.find("icy") != std::string::npos ||
+        type.find("frozen") != std::string::npos)
+        return SURFACE_ICY;
+
+    // Rocky worlds far below freezing are ice-covered
+    return temperature < 180.0f ? SURFACE_ICY : SURFACE_TERRESTRIAL;
+}
+
+bool PlanetTextureGenerator::generatePixels(const PlanetSurfaceParams& params,
+                                            std::vector<unsigned char>& pixels)
+{
+    std::string path = cacheDirectory + "/" + params.getCacheKey();
+    if (loadCached(path, params, pixels))
+        return true;
+
+    const int width = params.width;
+    const int height = params.height;
+    pixels.assign(static_cast<size_t>(width) * height * 3, 0);
+
+    const SurfaceStyle style = chooseStyle(params.planetType, params.temperature);
+    const Noise3D noise(params.seed);
+    const Surface surface(noise, params.temperature, params.seed);
+    unsigned char* output = &pixels[0];
+
+    int taskCount = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    pool.parallelFor(taskCount, [&](int task) {
+        int rowEnd = std::min(height, (task + 1) * ROWS_PER_TASK);
+        for (int row = task * ROWS_PER_TASK; row < rowEnd; ++row) {
+            SurfacePoint p;
+            p.latitude = PI * 0.5f - (row + 0.5f) / height * PI;
+            float cosLat = std::cos(p.latitude);
+            p.z = std::sin(p.latitude);
+
+            unsigned char* out = output + static_cast<size_t>(row) * width * 3;
+            for (int column = 0; column < width; ++column) {
+                p.longitude = (column + 0.5f) / width * 2.0f * PI;
+                p.x = cosLat * std::cos(p.longitude);
+                p.y = cosLat * std::sin(p.longitude);
+
+                Color color = style == SURFACE_GAS_GIANT ? gasGiantColor(surface, p)
+                            : style == SURFACE_ICY ? icyColor(surface, p)
+                            : terrestrialColor(surface, p);
+
+                out[0] = static_cast<unsigned char>(std::min(std::max(color.r, 0.0f), 1.0f) * 255.0f + 0.5f);
+                out[1] = static_cast<unsigned char>(std::min(std::max(color.g, 0.0f), 1.0f) * 255.0f + 0.5f);
+                out[2] = static_cast<unsigned char>(std::min(std::max(color.b, 0.0f), 1.0f) * 255.0f + 0.5f);
+                out += 3;
+            }
+        }
+    });
+
+    storeCached(path, params, pixels);
+    return false;
+}
+
+GLuint PlanetTextureGenerator::createTexture(const PlanetSurfaceParams& params)
+{
+    std::vector<unsigned char> pixels;
+    bool cached = generatePixels(params, pixels);
+    GLuint textureID = uploadTexture(params, pixels);
+
+    std::cout << "Planet surface " << (cached ? "loaded from cache: " : "generated: ")
+              << params.getCacheKey() << std::endl;
+    return textureID;
+}
+
+GLuint PlanetTextureGenerator::uploadTexture(const PlanetSurfaceParams& params,
+                                             const std::vector<unsigned char>& pixels)
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB rows are not 4-byte aligned
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, params.width, params.height, 0, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // Wrap around the longitude, clamp at the poles
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return textureID;
+}
+
+bool PlanetTextureGenerator::loadCached(const std::string& path, const PlanetSurfaceParams& params,
+                                        std::vector<unsigned char>& pixels) const
+{
+    // stb_image's per-thread flip setting cannot be cleared once set, and
+    // it would override the process-wide one for the rest of this
+    // thread's loads. Decode on a worker, where every load sets it.
+    if (pool.getWorkerIndex() < 0) {
+        bool loaded = false;
+        std::shared_ptr<TaskCounter> done = std::make_shared<TaskCounter>(1);
+        pool.enqueue([&, done] {
+            loaded = loadCached(path, params, pixels);
+            done->done();
+        });
+        pool.wait(*done);
+        return loaded;
+    }
+
+    // Cached maps are stored in texture row order
+    stbi_set_flip_vertically_on_load_thread(false);
+
+    int width, height, components;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &components, 3);
+    if (data == nullptr)
+        return false;
+
+    bool valid = width == params.width && height == params.height;
+    if (valid)
+        pixels.assign(data, data + static_cast<size_t>(width) * height * 3);
+    stbi_image_free(data);
+    return valid;
+}
+
+void PlanetTextureGenerator::storeCached(const std::string& path, const PlanetSurfaceParams& params,
+                                         const std::vector<unsigned char>& pixels)
+{
+    if (!makeDirectories(cacheDirectory)) {
+        std::cerr << "Warning: Cannot create texture cache " << cacheDirectory << std::endl;
+        return;
+    }
+
+    // Write in the background; the rename keeps readers from ever seeing
+    // a partial file
+    int width = params.width;
+    int height = params.height;
+    std::vector<unsigned char> copy(pixels);
+    pool.enqueue([path, width, height, copy] {
+        std::string temporary = path + ".tmp";
+        if (ImageWriter::writePng(temporary, width, height, 3, &copy[0], false))
+            std::rename(temporary.c_str(), path.c_str());
+        else
+            std::remove(temporary.c_str());
+    });
+}
@@ -0,0 +1,126 @@
+// QualityGovernor.cpp
+
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+// Lowest level first
+const QualitySettings LEVELS[QualityGovernor::LEVEL_COUNT] = {
+    { 0.50f, 16,  8,  90, 0.20f },
+    { 0.60f, 24, 12, 120, 0.35f },
+    { 0.70f, 32, 16, 180, 0.50f },
+    { 0.85f, 48, 24, 240, 0.75f },
+    { 1.00f, 72, 36, 360, 1.00f }
+};
+
+const double SMOOTHING = 0.1;        // Weight of the newest frame
+const double OVER_THRESHOLD = 1.1;   // Of the target
+const double UNDER_THRESHOLD = 0.7;
+const int FRAMES_TO_DROP = 15;
+const int FRAMES_TO_RAISE = 120;
+const int COOLDOWN_AFTER_DROP = 30;  // Lets the average settle at the new level
+const int COOLDOWN_AFTER_RAISE = 60;
+
+// Sleep no closer to the deadline than this; spin the rest
+const std::chrono::microseconds SPIN_MARGIN(1500);
+} // namespace
+
+QualityGovernor::QualityGovernor()
+    : enabled(false), target(1000.0 / 60.0), level(LEVEL_COUNT - 1),
+      smoothed(0.0), framesOver(0), framesUnder(0), cooldown(0)
+{
+}
+
+void QualityGovernor::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    if (!enabled)
+        setLevel(LEVEL_COUNT - 1, 0);
+}
+
+bool QualityGovernor::isEnabled() const { return enabled; }
+
+void QualityGovernor::setTargetFrameTime(double milliseconds)
+{
+    target = std::max(milliseconds, 1.0);
+    framesOver = 0;
+    framesUnder = 0;
+}
+
+double QualityGovernor::getTargetFrameTime() const { return target; }
+
+bool QualityGovernor::update(double cpuMilliseconds, double gpuMilliseconds)
+{
+    // GPU times arrive a few frames late and may be missing
+    double cost = std::max(cpuMilliseconds, gpuMilliseconds);
+    smoothed = smoothed > 0.0 ? smoothed + SMOOTHING * (cost - smoothed) : cost;
+
+    if (!enabled)
+        return false;
+
+    framesOver = smoothed > target * OVER_THRESHOLD ? framesOver + 1 : 0;
+    framesUnder = smoothed < target * UNDER_THRESHOLD ? framesUnder + 1 : 0;
+    if (cooldown > 0) {
+        --cooldown;
+        return false;
+    }
+
+    if (framesOver >= FRAMES_TO_DROP && level > 0) {
+        setLevel(level - 1, COOLDOWN_AFTER_DROP);
+        return true;
+    }
+    if (framesUnder >= FRAMES_TO_RAISE && level < LEVEL_COUNT - 1) {
+        setLevel(level + 1, COOLDOWN_AFTER_RAISE);
+        return true;
+    }
+    return false;
+}
+
+int QualityGovernor::getLevel() const { return level; }
+const QualitySettings& QualityGovernor::getSettings() const { return LEVELS[level]; }
+double QualityGovernor::getSmoothedFrameTime() const { return smoothed; }
+
+void QualityGovernor::setLevel(int newLevel, int cooldownFrames)
+{
+    level = newLevel;
+    cooldown = cooldownFrames;
+    framesOver = 0;
+    framesUnder = 0;
+}
+
+FrameLimiter::FrameLimiter()
+    : maxFps(0.0), nextFrame(Clock::now())
+{
+}
+
+void FrameLimiter::setMaxFps(double fps)
+{
+    maxFps = std::max(fps, 0.0);
+    nextFrame = Clock::now();
+}
+
+double FrameLimiter::getMaxFps() const { return maxFps; }
+
+void FrameLimiter::wait()
+{
+    if (maxFps <= 0.0)
+        return;
+
+    Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / maxFps));
+    nextFrame += period;
+
+    // After a long frame, start a new schedule instead of catching up
+    Clock::time_point now = Clock::now();
+    if (nextFrame < now) {
+        nextFrame = now;
+        return;
+    }
+
+    if (nextFrame - now > SPIN_MARGIN)
+        std::this_thread::sleep_until(nextFrame - SPIN_MARGIN);
+    while (Clock::now() < nextFrame)
+        std::this_thread::yield();
+}
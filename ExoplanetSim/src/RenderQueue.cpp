@@ -0,0 +1,154 @@
+// RenderQueue.cpp
+
+#include "RenderQueue.h"
+#include "DepthMode.h"
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(static_cast<int>(PASS_COUNT) == static_cast<int>(FrameProfiler::GPU_IMGUI),
+              "Render passes must map onto the profiler's GPU sections");
+
+RenderQueue::RenderQueue()
+{}
+
+void RenderQueue::clear()
+{
+    commands.clear();
+    order.clear();
+}
+
+void RenderQueue::push(RenderPass pass, float depth, const DrawCommand& command)
+{
+    // Blended geometry is drawn back to front, everything else front to back
+    if (pass == PASS_HABITABLE_ZONE)
+        depth = -depth;
+
+    DrawCommand recorded = command;
+    GLuint program = command.shader != nullptr ? command.shader->ID : 0;
+    recorded.key = makeKey(pass, program, command.texture, depth);
+
+    SortEntry entry;
+    entry.key = recorded.key;
+    entry.index = static_cast<uint32_t>(commands.size());
+
+    commands.push_back(recorded);
+    order.push_back(entry);
+}
+
+void RenderQueue::execute(GLStateCache& state, const DepthMode& depthMode,
+                          FrameProfiler* profiler)
+{
+    // Stable so that draws with equal keys keep their recording order
+    std::stable_sort(order.begin(), order.end());
+
+    int currentPass = -1;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const DrawCommand& command = commands[order[i].index];
+
+        int pass = static_cast<int>(command.key >> 60);
+        if (pass != currentPass) {
+            // Passes map one-to-one onto the profiler's GPU sections
+            if (profiler != nullptr)
+                profiler->beginGpu(static_cast<FrameProfiler::GpuSection>(pass));
+            applyPassState(static_cast<RenderPass>(pass), state, depthMode);
+            currentPass = pass;
+        }
+
+        if (command.shader != nullptr) {
+            state.useProgram(command.shader->ID);
+            if (command.setUniforms)
+                command.setUniforms(*command.shader);
+        }
+
+        if (command.textureTarget != 0)
+            state.bindTexture(0, command.textureTarget, command.texture);
+        for (int t = 0; t < DrawCommand::MAX_EXTRA_TEXTURES; ++t) {
+            if (command.extraTextureTargets[t] != 0)
+                state.bindTexture(1 + t, command.extraTextureTargets[t], command.extraTextures[t]);
+        }
+
+        state.bindVertexArray(command.vertexArray);
+
+        if (command.primitive == GL_POINTS)
+            state.setPointSize(command.pointSize);
+        else if (command.primitive == GL_LINES || command.primitive == GL_LINE_STRIP)
+            state.setLineWidth(command.lineWidth);
+
+        if (command.drawCount > 0) {
+            glMultiDrawArrays(command.primitive, command.firsts, command.counts, command.drawCount);
+        } else if (command.instanceCount > 0) {
+            if (command.indexed)
+                glDrawElementsInstanced(command.primitive, command.count, GL_UNSIGNED_INT, 0,
+                                        command.instanceCount);
+            else
+                glDrawArraysInstanced(command.primitive, command.first, command.count,
+                                      command.instanceCount);
+        } else if (command.indexed) {
+            glDrawElements(command.primitive, command.count, GL_UNSIGNED_INT, 0);
+        } else {
+            glDrawArrays(command.primitive, command.first, command.count);
+        }
+        state.countDraw();
+    }
+
+    if (profiler != nullptr)
+        profiler->endGpu();
+}
+
+size_t RenderQueue::size() const
+{
+    return commands.size();
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, GLuint program, GLuint texture, float depth)
+{
+    // Map the float to an unsigned integer with the same ordering
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    depthBits = (depthBits & 0x80000000u) ? ~depthBits : (depthBits | 0x80000000u);
+
+    return (static_cast<uint64_t>(pass & 0xF) << 60) |
+           (static_cast<uint64_t>(program & 0xFFF) << 48) |
+           (static_cast<uint64_t>(texture & 0xFFFF) << 32) |
+           static_cast<uint64_t>(depthBits);
+}
+
+void RenderQueue::applyPassState(RenderPass pass, GLStateCache& state, const DepthMode& depthMode)
+{
+    switch (pass) {
+    case PASS_SKYBOX:
+        // Drawn at infinite depth behind everything already in the buffer
+        state.setBlend(false);
+        state.setDepthMask(true);
+        state.setDepthFunc(depthMode.getSkyDepthFunc());
+        break;
+    case PASS_STARFIELD:
+        // Light added at infinite depth; nothing behind it to occlude
+        state.setBlend(true);
+        state.setBlendFunc(GL_ONE, GL_ONE);
+        state.setDepthMask(false);
+        state.setDepthFunc(depthMode.getSkyDepthFunc());
+        break;
+    case PASS_ORBITS:
+        // Coverage-blended edges; depth-tested against the bodies only
+        state.setBlend(true);
+        state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        state.setDepthMask(false);
+        state.setDepthFunc(depthMode.getDepthFunc());
+        break;
+    case PASS_HABITABLE_ZONE:
+        // Translucent: blend and keep the depth buffer untouched
+        state.setBlend(true);
+        state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        state.setDepthMask(false);
+        state.setDepthFunc(depthMode.getDepthFunc());
+        break;
+    default:
+        state.setBlend(false);
+        state.setDepthMask(true);
+        state.setDepthFunc(depthMode.getDepthFunc());
+        break;
+    }
+}
@@ -0,0 +1,96 @@
+// RenderTarget.cpp
+
+#include "RenderTarget.h"
+#include <iostream>
+
+RenderTarget::RenderTarget()
+    : fbo(0), colorTexture(0), depthRenderbuffer(0), width(0), height(0)
+{}
+
+RenderTarget::~RenderTarget()
+{
+    destroy();
+}
+
+void RenderTarget::resize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return;
+    if (fbo != 0 && width == this->width && height == this->height)
+        return;
+
+    destroy();
+    this->width = width;
+    this->height = height;
+
+    // Color attachment
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 32-bit float depth attachment
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Error: Scene framebuffer is incomplete (" << width << "x" << height << ")." << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+}
+
+void RenderTarget::blitToScreen(int screenWidth, int screenHeight) const
+{
+    // Letterbox if the aspect ratios differ (e.g. capturing at 4K)
+    int dstWidth = screenWidth;
+    int dstHeight = screenHeight;
+    if (static_cast<long long>(width) * screenHeight > static_cast<long long>(screenWidth) * height)
+        dstHeight = static_cast<int>(static_cast<long long>(screenWidth) * height / width);
+    else
+        dstWidth = static_cast<int>(static_cast<long long>(screenHeight) * width / height);
+    int x = (screenWidth - dstWidth) / 2;
+    int y = (screenHeight - dstHeight) / 2;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, x, y, x + dstWidth, y + dstHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+GLuint RenderTarget::getFramebuffer() const { return fbo; }
+GLuint RenderTarget::getColorTexture() const { return colorTexture; }
+int RenderTarget::getWidth() const { return width; }
+int RenderTarget::getHeight() const { return height; }
+
+void RenderTarget::destroy()
+{
+    if (fbo != 0)
+        glDeleteFramebuffers(1, &fbo);
+    if (colorTexture != 0)
+        glDeleteTextures(1, &colorTexture);
+    if (depthRenderbuffer != 0)
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+
+    fbo = colorTexture = depthRenderbuffer = 0;
+    width = height = 0;
+}
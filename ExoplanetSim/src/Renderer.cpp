@@ -2,6 +2,9 @@
 
 #include "Renderer.h"
 #include "Application.h"
+#include "TraceProfiler.h"
+
+#include <algorithm>
 
 Renderer::Renderer(Application* app)
     : app(app)
@@ -12,79 +15,208 @@ Renderer::Renderer(Application* app)
 
 void Renderer::renderScene(float deltaTime)
 {
-    // Clear the color and depth buffers
+    TRACE_ZONE("Renderer::renderScene");
+    int screenWidth, screenHeight;
+    app->getFramebufferSize(screenWidth, screenHeight);
+    if (screenWidth <= 0 || screenHeight <= 0)
+        return; // Minimized window
+
+    // Captures render at their own resolution and are scaled for display;
+    // otherwise the quality governor may lower the resolution
+    FrameCapture& capture = app->capture;
+    float renderScale = app->governor.getSettings().renderScale;
+    int width = capture.isActive() ? capture.getWidth()
+                                   : std::max(1, static_cast<int>(screenWidth * renderScale + 0.5f));
+    int height = capture.isActive() ? capture.getHeight()
+                                    : std::max(1, static_cast<int>(screenHeight * renderScale + 0.5f));
+
+    // Draw into the float depth target
+    sceneTarget.resize(width, height);
+    sceneTarget.bind();
+
+    // ImGui and mesh rebuilds change GL state behind the cache's back
+    state.invalidate();
+    state.resetStats();
+
+    // Clear the color and depth buffers (depth writes must be enabled)
+    const DepthMode& depthMode = app->depthMode;
+    state.setDepthMask(true);
     glClearColor(0.01f, 0.01f, 0.01f, 1.0f); // Dark background
+    glClearDepth(depthMode.getClearDepth());
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Calculate the maximum distance in the scene
-    float maxPlanetDistance = app->planet->getOrbitalDistance() * (1.0f + app->planet->getEccentricity());
-    float starRadius = app->star->getRadius();
+    // Near plane only; the far plane is at infinity. With reverse-Z (or the
+    // logarithmic fallback) precision no longer depends on the orbit size.
+    float nearPlane = 0.01f;
+    float fovy = glm::radians(app->camera.Zoom);
+    float aspect = static_cast<float>(width) / static_cast<float>(height);
+
+    // Set view and projection matrices
+    glm::mat4 view = app->camera.GetViewMatrix();
+    glm::mat4 projection = depthMode.getProjection(fovy, aspect, nearPlane);
+    glm::mat4 cullingProjection = depthMode.getCullingProjection(fovy, aspect, nearPlane);
 
-    // Calculate a suitable far plane distance
-    float maxDistance = (maxPlanetDistance + starRadius) * 2.5f;
+    // Floating origin: rebase double-precision world positions relative to
+    // the camera so every float model matrix stays precise near the viewer
+    const Camera& camera = app->camera;
+    glm::vec3 starPos = camera.ToCameraRelative(app->star->getPosition());
+    glm::vec3 planetPos = camera.ToCameraRelative(app->planet->getPosition());
+    glm::vec3 orbitCenter = camera.ToCameraRelative(app->planet->getOrbitCenter());
 
-    // Set near and far clipping planes
-    float nearPlane = 0.1f;                   // Adjusted for better depth precision
-    float farPlane = maxDistance * 5.0f;      // Ensure farPlane is larger than maxDistance
+    // Cull the star, planet, orbit and habitable zone against the view
+    BoundingSphere starBounds(starPos, app->star->getRadius());
+    BoundingSphere planetBounds(planetPos, app->planet->getRadius());
+    BoundingBox orbitBounds = app->planet->getOrbitBounds();
+    orbitBounds.min += orbitCenter;
+    orbitBounds.max += orbitCenter;
 
-    // Prevent nearPlane from being greater than or equal to farPlane
-    if (nearPlane >= farPlane)
-    {
-        nearPlane = farPlane / 1000.0f; // Adjust nearPlane accordingly
+    // The habitable zone surrounds the star
+    glm::vec3 zoneCenter = starPos;
+    float zoneOuter = habitableZone->GetOuterRadius();
+
+    // Moons follow the planet
+    std::vector<glm::vec3> moonPositions(app->moons.size());
+    std::vector<BoundingSphere> moonBounds;
+    for (size_t i = 0; i < app->moons.size(); ++i) {
+        moonPositions[i] = camera.ToCameraRelative(app->moons[i]->getPosition(app->planet->getPosition()));
+        moonBounds.push_back(BoundingSphere(moonPositions[i], app->moons[i]->getRadius()));
     }
 
-    // Set view and projection matrices
-    glm::mat4 view = app->camera.GetViewMatrix();
-    int width, height;
-    glfwGetFramebufferSize(app->window, &width, &height);
-    glm::mat4 projection = glm::perspective(
-        glm::radians(app->camera.Zoom),
-        static_cast<float>(width) / static_cast<float>(height),
-        nearPlane,
-        farPlane
-    );
-
-    // Render the star
-    app->starShader->use();
-    app->starShader->setMat4("view", view);
-    app->starShader->setMat4("projection", projection);
-    app->starShader->setVec3("cameraPos", app->camera.Position);
-
-    // Render the star (first pass)
-    glm::mat4 starModel = glm::mat4(1.0f);
-    starModel = glm::translate(starModel, app->star->getPosition());
-    starModel = glm::scale(starModel, glm::vec3(app->star->getRadius()));
-
-    app->star->render(*app->starShader, starModel);
-
-    // Render the planet
-    app->planetShader->use();
-    app->planetShader->setMat4("view", view);
-    app->planetShader->setMat4("projection", projection);
-    glm::mat4 planetModel = glm::mat4(1.0f);
-    planetModel = glm::translate(planetModel, app->planet->getPosition());
-    planetModel = glm::scale(planetModel, glm::vec3(app->planet->getRadius()));
-    app->planetShader->setMat4("model", planetModel);
-    app->planetShader->setVec3("lightPos", app->star->getPosition());
+    BoundingBox systemBounds = orbitBounds;
+    systemBounds.expand(starBounds);
+    systemBounds.expand(planetBounds);
+    for (size_t i = 0; i < moonBounds.size(); ++i)
+        systemBounds.expand(moonBounds[i]);
+    systemBounds.expand(BoundingBox(zoneCenter - glm::vec3(zoneOuter, 0.0f, zoneOuter),
+                                    zoneCenter + glm::vec3(zoneOuter, 0.0f, zoneOuter)));
+
+    culler.beginFrame(cullingProjection * view, glm::vec3(0.0f));
+    int system = culler.addSystem(systemBounds, starBounds);
+    int starItem = culler.addBody(system, starBounds, false);
+    int planetItem = culler.addBody(system, planetBounds);
+    int orbitItem = culler.addOrbit(system, orbitBounds);
+    int zoneItem = culler.addZone(system, zoneCenter, habitableZone->GetInnerRadius(), zoneOuter);
+
+    std::vector<int> moonItems(app->moons.size());
+    for (size_t i = 0; i < app->moons.size(); ++i)
+        moonItems[i] = culler.addBody(system, moonBounds[i]);
+    culler.cull();
+
+    // Every body except the star can eclipse the others. The list is
+    // built whether or not the bodies are visible: an off-screen moon
+    // still shadows the planet.
+    std::vector<glm::vec4> occluders;
+    occluders.push_back(glm::vec4(planetPos, app->planet->getRadius()));
+    for (size_t i = 0; i < moonPositions.size() && occluders.size() < MAX_OCCLUDERS; ++i)
+        occluders.push_back(glm::vec4(moonPositions[i], app->moons[i]->getRadius()));
+
+    // Upload per-frame uniforms once per program
+    const Shader* frameShaders[] = {
+        app->starShader, app->planetShader, app->orbitShader,
+        app->habitableZoneShader
+    };
+    for (size_t i = 0; i < sizeof(frameShaders) / sizeof(frameShaders[0]); ++i) {
+        state.useProgram(frameShaders[i]->ID);
+        frameShaders[i]->setMat4("view", view);
+        frameShaders[i]->setMat4("projection", projection);
+    }
+
+    state.useProgram(app->planetShader->ID);
+    app->planetShader->setVec3("lightPos", starPos);
     app->planetShader->setVec3("lightColor", app->star->getColor());
-    app->planetShader->setVec3("viewPos", app->camera.Position);
-    app->planet->render(*app->planetShader);
-
-    // Render the orbit line
-    app->orbitShader->use();
-    app->orbitShader->setMat4("view", view);
-    app->orbitShader->setMat4("projection", projection);
-    app->planet->renderOrbit(*app->orbitShader, view, projection);
-
-    // Render the habitable zone
-    habitableZone->Draw(view, projection);
-
-    // Render the skybox last
-    glDepthFunc(GL_LEQUAL);
-    app->skyboxShader->use();
-    glm::mat4 skyboxView = glm::mat4(glm::mat3(view)); // Remove translation from the view matrix
-    app->skyboxShader->setMat4("view", skyboxView);
-    app->skyboxShader->setMat4("projection", projection);
-    app->skybox->render();
-    glDepthFunc(GL_LESS);
+    app->planetShader->setVec3("viewPos", glm::vec3(0.0f)); // Camera is the origin
+    app->planetShader->setFloat("lightRadius", app->star->getRadius());
+    app->planetShader->setVec4Array("occluders", &occluders[0], static_cast<int>(occluders.size()));
+    app->planetShader->setInt("occluderCount", static_cast<int>(occluders.size()));
+
+    // Orbit lines are expanded to a fixed pixel width in the vertex shader
+    state.useProgram(app->orbitShader->ID);
+    app->orbitShader->setVec2("viewportSize", glm::vec2(width, height));
+
+    // The background only follows the camera's rotation
+    glm::mat4 skyView = glm::mat4(glm::mat3(view)); // View is rotation-only already
+    if (app->skyboxEnabled) {
+        state.useProgram(app->skyboxShader->ID);
+        app->skyboxShader->setMat4("view", skyView);
+        app->skyboxShader->setMat4("projection", projection);
+    } else {
+        state.useProgram(app->starfieldShader->ID);
+        app->starfieldShader->setMat4("view", skyView);
+        app->starfieldShader->setMat4("projection", projection);
+        app->starfieldShader->setVec2("viewportSize", glm::vec2(width, height));
+        state.useProgram(app->milkyWayShader->ID);
+        app->milkyWayShader->setMat4("view", skyView);
+        app->milkyWayShader->setMat4("projection", projection);
+    }
+
+    // Record the visible objects
+    queue.clear();
+
+    if (culler.isVisible(starItem))
+    {
+        glm::mat4 starModel = glm::mat4(1.0f);
+        starModel = glm::translate(starModel, starPos);
+        starModel = glm::scale(starModel, glm::vec3(app->star->getRadius()));
+        app->star->record(queue, *app->starShader, starModel, glm::length(starPos));
+    }
+
+    if (culler.isVisible(planetItem))
+    {
+        glm::mat4 planetModel = glm::mat4(1.0f);
+        planetModel = glm::translate(planetModel, planetPos);
+        planetModel = glm::scale(planetModel, glm::vec3(app->planet->getRadius()));
+        app->planet->record(queue, *app->planetShader, planetModel, glm::length(planetPos), 0);
+    }
+
+    for (size_t i = 0; i < app->moons.size(); ++i)
+    {
+        if (!culler.isVisible(moonItems[i]))
+            continue;
+        glm::mat4 moonModel = glm::translate(glm::mat4(1.0f), moonPositions[i]);
+        moonModel = glm::scale(moonModel, glm::vec3(app->moons[i]->getRadius()));
+        int occluderIndex = i + 1 < MAX_OCCLUDERS ? static_cast<int>(i + 1) : -1;
+        app->moons[i]->record(queue, *app->planetShader, moonModel,
+                              glm::length(moonPositions[i]), occluderIndex);
+    }
+
+    // All orbits share one buffer and one draw; centers follow the camera
+    OrbitBatch& orbits = *app->orbits;
+    orbits.setOrigin(app->planetOrbit, orbitCenter);
+    orbits.setVisible(app->planetOrbit, culler.isVisible(orbitItem));
+    for (size_t i = 0; i < app->stressOrbits.size(); ++i)
+        orbits.setOrigin(app->stressOrbits[i], starPos);
+    orbits.record(queue, *app->orbitShader);
+
+    if (culler.isVisible(zoneItem))
+    {
+        habitableZone->SetCenter(zoneCenter);
+        habitableZone->Record(queue, glm::length(zoneCenter));
+    }
+
+    if (app->skyboxEnabled)
+        app->skybox->record(queue, *app->skyboxShader);
+    else
+        app->starfield->record(queue, *app->starfieldShader, *app->milkyWayShader);
+
+    // Sort and submit through the state cache
+    queue.execute(state, depthMode, &app->profiler);
+
+    // Start the asynchronous readback before presenting
+    if (capture.isActive())
+        capture.captureFrame(sceneTarget.getFramebuffer());
+
+    // Present the scene; ImGui is drawn on top in the default framebuffer.
+    // Headless runs have no default framebuffer and keep the image here.
+    if (!app->isHeadless())
+        sceneTarget.blitToScreen(screenWidth, screenHeight);
+}
+
+const CullStats& Renderer::getCullStats() const
+{
+    return culler.getStats();
+}
+
+const GLCallStats& Renderer::getCallStats() const
+{
+    return state.getStats();
 }
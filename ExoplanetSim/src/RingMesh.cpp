@@ -8,33 +8,7 @@
 RingMesh::RingMesh(float innerRadius, float outerRadius, int segments) {
 	std::vector<glm::vec3> vertices;
 	std::vector<unsigned int> indices;
-
-	float deltaAngle = 2.0f * glm::pi<float>() / segments;
-
-	// Generate vertices
-	for (int i = 0; i <= segments; ++i) {
-		float angle = i * deltaAngle;
-		float xInner = innerRadius * cos(angle);
-		float zInner = innerRadius * sin(angle);
-		float xOuter = outerRadius * cos(angle);
-		float zOuter = outerRadius * sin(angle);
-
-		// Inner vertex
-		vertices.emplace_back(glm::vec3(xInner, 0.0f, zInner));
-		// Outer vertex
-		vertices.emplace_back(glm::vec3(xOuter, 0.0f, zOuter));
-	}
-
-	// Generate indices for triangles
-	for (int i = 0; i < segments * 2; i += 2) {
-		indices.push_back(i);
-		indices.push_back(i + 1);
-		indices.push_back(i + 2);
-
-		indices.push_back(i + 1);
-		indices.push_back(i + 3);
-		indices.push_back(i + 2);
-	}
+	GenerateRing(innerRadius, outerRadius, segments, vertices, indices);
 
 	indexCount = static_cast<int>(indices.size());
 
@@ -68,6 +42,46 @@ RingMesh::~RingMesh() {
 	glDeleteBuffers(1, &EBO);
 }
 
+void RingMesh::GenerateRing(float innerRadius, float outerRadius, int segments,
+                            std::vector<glm::vec3> &vertices,
+                            std::vector<unsigned int> &indices) {
+	vertices.clear();
+	indices.clear();
+	vertices.reserve((segments + 1) * 2);
+	indices.reserve(segments * 6);
+
+	float deltaAngle = 2.0f * glm::pi<float>() / segments;
+
+	// Generate vertices
+	for (int i = 0; i <= segments; ++i) {
+		float angle = i * deltaAngle;
+		float xInner = innerRadius * cos(angle);
+		float zInner = innerRadius * sin(angle);
+		float xOuter = outerRadius * cos(angle);
+		float zOuter = outerRadius * sin(angle);
+
+		// Inner vertex
+		vertices.emplace_back(glm::vec3(xInner, 0.0f, zInner));
+		// Outer vertex
+		vertices.emplace_back(glm::vec3(xOuter, 0.0f, zOuter));
+	}
+
+	// Generate indices for triangles
+	for (int i = 0; i < segments * 2; i += 2) {
+		indices.push_back(i);
+		indices.push_back(i + 1);
+		indices.push_back(i + 2);
+
+		indices.push_back(i + 1);
+		indices.push_back(i + 3);
+		indices.push_back(i + 2);
+	}
+}
+
+unsigned int RingMesh::GetVAO() const { return VAO; }
+
+int RingMesh::GetIndexCount() const { return indexCount; }
+
 void RingMesh::Draw() {
 	glBindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
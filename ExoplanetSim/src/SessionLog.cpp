@@ -0,0 +1,229 @@
+// SessionLog.cpp
+
+#include "SessionLog.h"
+
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace {
+const char MAGIC[8] = { 'E', 'X', 'O', 'S', 'L', 'O', 'G', '1' };
+
+// Fixed-width little-endian fields, independent of the host
+void putU32(std::string& buffer, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void putU16(std::string& buffer, uint16_t value)
+{
+    buffer.push_back(static_cast<char>(value & 0xFF));
+    buffer.push_back(static_cast<char>(value >> 8));
+}
+
+void putF32(std::string& buffer, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(buffer, bits);
+}
+
+uint32_t getU32(const unsigned char* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint16_t getU16(const unsigned char* data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+float getF32(const unsigned char* data)
+{
+    uint32_t bits = getU32(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+const size_t HEADER_SIZE = 8 + 3 * 4;
+const size_t FRAME_HEADER_SIZE = 4 + 2;
+const size_t EVENT_SIZE = 1 + 1 + 4 + 4;
+} // namespace
+
+SessionLog::SessionLog()
+    : recording(false), frameOpen(false), frameIndex(-1), width(0), height(0)
+{
+}
+
+SessionLog::~SessionLog()
+{
+    stop();
+}
+
+bool SessionLog::startRecording(const std::string& path, int width, int height)
+{
+    stop();
+
+    output.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cerr << "Error: Could not create session log " << path << std::endl;
+        return false;
+    }
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU32(header, VERSION);
+    putU32(header, static_cast<uint32_t>(width));
+    putU32(header, static_cast<uint32_t>(height));
+    output.write(header.data(), header.size());
+
+    this->width = width;
+    this->height = height;
+    recording = true;
+    frameOpen = false;
+    return true;
+}
+
+void SessionLog::beginFrame(float deltaTime)
+{
+    if (!recording)
+        return;
+
+    if (frameOpen)
+        writeFrame();
+
+    // Events from between the frames (window callbacks during event
+    // polling) first take effect in this frame, so replay applies them
+    // at its start
+    current.deltaTime = deltaTime;
+    current.events.swap(pending);
+    pending.clear();
+    frameOpen = true;
+}
+
+void SessionLog::endFrame()
+{
+    if (!recording || !frameOpen)
+        return;
+
+    writeFrame();
+    frameOpen = false;
+}
+
+void SessionLog::add(const Event& event)
+{
+    if (!recording)
+        return;
+
+    std::vector<Event>& events = frameOpen ? current.events : pending;
+    if (events.size() < 0xFFFF)
+        events.push_back(event);
+}
+
+bool SessionLog::load(const std::string& path)
+{
+    stop();
+
+    std::ifstream input(path.c_str(), std::ios::binary);
+    if (!input) {
+        std::cerr << "Error: Could not open session log " << path << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(input)),
+                                    std::istreambuf_iterator<char>());
+
+    if (data.size() < HEADER_SIZE || std::memcmp(&data[0], MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Error: " << path << " is not a session log." << std::endl;
+        return false;
+    }
+    uint32_t version = getU32(&data[8]);
+    if (version != VERSION) {
+        std::cerr << "Error: Unsupported session log version " << version << " in " << path
+                  << std::endl;
+        return false;
+    }
+    width = static_cast<int>(getU32(&data[12]));
+    height = static_cast<int>(getU32(&data[16]));
+
+    size_t offset = HEADER_SIZE;
+    while (offset + FRAME_HEADER_SIZE <= data.size()) {
+        Frame frame;
+        frame.deltaTime = getF32(&data[offset]);
+        uint16_t count = getU16(&data[offset + 4]);
+        if (offset + FRAME_HEADER_SIZE + count * EVENT_SIZE > data.size())
+            break; // Cut off mid-frame, e.g. by a crash while recording
+        offset += FRAME_HEADER_SIZE;
+
+        frame.events.resize(count);
+        for (uint16_t i = 0; i < count; ++i, offset += EVENT_SIZE) {
+            Event& event = frame.events[i];
+            event.type = data[offset];
+            event.code = data[offset + 1];
+            event.x = getF32(&data[offset + 2]);
+            event.y = getF32(&data[offset + 6]);
+        }
+        frames.push_back(frame);
+    }
+    if (offset != data.size())
+        std::cerr << "Warning: Ignoring a truncated frame at the end of " << path << std::endl;
+
+    frameIndex = -1;
+    return true;
+}
+
+bool SessionLog::nextFrame()
+{
+    if (frameIndex + 1 >= static_cast<int>(frames.size()))
+        return false;
+    ++frameIndex;
+    return true;
+}
+
+float SessionLog::getFrameTime() const
+{
+    return frames[frameIndex].deltaTime;
+}
+
+const std::vector<SessionLog::Event>& SessionLog::getEvents() const
+{
+    return frames[frameIndex].events;
+}
+
+int SessionLog::getFrameIndex() const { return frameIndex; }
+int SessionLog::getFrameCount() const { return static_cast<int>(frames.size()); }
+
+void SessionLog::stop()
+{
+    if (recording) {
+        if (frameOpen)
+            writeFrame();
+        output.close();
+        recording = false;
+        frameOpen = false;
+        pending.clear(); // Never took effect in a recorded frame
+    }
+    frames.clear();
+    frameIndex = -1;
+}
+
+bool SessionLog::isRecording() const { return recording; }
+bool SessionLog::isReplaying() const { return !frames.empty(); }
+int SessionLog::getWidth() const { return width; }
+int SessionLog::getHeight() const { return height; }
+
+void SessionLog::writeFrame()
+{
+    std::string buffer;
+    buffer.reserve(FRAME_HEADER_SIZE + current.events.size() * EVENT_SIZE);
+    putF32(buffer, current.deltaTime);
+    putU16(buffer, static_cast<uint16_t>(current.events.size()));
+    for (size_t i = 0; i < current.events.size(); ++i) {
+        const Event& event = current.events[i];
+        buffer.push_back(static_cast<char>(event.type));
+        buffer.push_back(static_cast<char>(event.code));
+        putF32(buffer, event.x);
+        putF32(buffer, event.y);
+    }
+    output.write(buffer.data(), buffer.size());
+}
@@ -1,16 +1,13 @@
 // Shader.cpp
 
 #include "Shader.h"
+#include "TraceProfiler.h"
 
 #include <glm/gtc/type_ptr.hpp> // For glm::value_ptr
 #include <stdexcept>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+bool ShaderSource::read(const char* vertexPath, const char* fragmentPath)
 {
-    // 1. Retrieve the vertex/fragment source code from file paths
-    std::string vertexCode;
-    std::string fragmentCode;
-
     std::ifstream vShaderFile;
     std::ifstream fShaderFile;
 
@@ -34,12 +31,46 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
         fShaderFile.close();
 
         // Convert streams into strings
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        vertex = vShaderStream.str();
+        fragment = fShaderStream.str();
 
     } catch (std::ifstream::failure& e) {
         std::cerr << "ERROR::SHADER::FILE_NOT_READ: " << e.what() << std::endl;
+        valid = false;
+        return false;
+    }
+
+    valid = true;
+    return true;
+}
+
+static ShaderSource readSource(const char* vertexPath, const char* fragmentPath)
+{
+    ShaderSource source;
+    source.read(vertexPath, fragmentPath);
+    return source;
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath,
+               const std::string& defines)
+    : Shader(readSource(vertexPath, fragmentPath), defines)
+{
+}
+
+Shader::Shader(const ShaderSource& source, const std::string& defines)
+{
+    TRACE_ZONE("Shader compile");
+
+    // 1. Take the vertex/fragment source code read from the files
+    if (!source.valid)
         throw std::runtime_error("Failed to read shader files");
+
+    std::string vertexCode = source.vertex;
+    std::string fragmentCode = source.fragment;
+
+    if (!defines.empty()) {
+        vertexCode = injectDefines(vertexCode, defines);
+        fragmentCode = injectDefines(fragmentCode, defines);
     }
 
     const char* vShaderCode = vertexCode.c_str();
@@ -95,6 +126,20 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
     glDeleteShader(fragment);
 }
 
+std::string Shader::injectDefines(const std::string& source, const std::string& defines)
+{
+    // #version must stay the first directive, so add the defines after it
+    size_t version = source.find("#version");
+    if (version == std::string::npos)
+        return defines + source;
+
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos)
+        return source + "\n" + defines;
+
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
 void Shader::use() const
 {
     glUseProgram(ID);
@@ -132,6 +177,11 @@ void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
+void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+{
+    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+}
+
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 {
     glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
@@ -142,3 +192,8 @@ void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
 {
     glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
 }
+
+void Shader::setVec4Array(const std::string &name, const glm::vec4* values, int count) const
+{
+    glUniform4fv(glGetUniformLocation(ID, name.c_str()), count, glm::value_ptr(values[0]));
+}
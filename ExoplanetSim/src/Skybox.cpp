@@ -1,5 +1,4 @@
 #include "Skybox.h"
-#include <stb_image.h>
 #include <iostream>
 
 // Vertex data for a cube (skybox)
@@ -47,9 +46,10 @@ float skyboxVertices[] = {
     -1.0f, -1.0f, 1.0f,
     1.0f, -1.0f, 1.0f};
 
-Skybox::Skybox(const std::vector<std::string> &faces)
+Skybox::Skybox(const std::vector<std::string> &faces, TextureLoader &textures)
 {
-    loadCubemap(faces);
+    // Black until the faces have streamed in
+    cubemapTexture = textures.loadCubemap(faces);
     setupMesh();
 }
 
@@ -57,46 +57,7 @@ Skybox::~Skybox()
 {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-}
-
-void Skybox::loadCubemap(const std::vector<std::string> &faces)
-{
-    glGenTextures(1, &cubemapTexture);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-
-    int width, height, nrChannels;
-    for (GLuint i = 0; i < faces.size(); i++)
-    {
-        stbi_set_flip_vertically_on_load(false); // Ensure images are not flipped
-        unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data)
-        {
-            GLenum format = GL_RGB;
-            if (nrChannels == 1)
-                format = GL_RED;
-            else if (nrChannels == 3)
-                format = GL_RGB;
-            else if (nrChannels == 4)
-                format = GL_RGBA;
-
-            glTexImage2D(
-                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
-        }
-        else
-        {
-            std::cerr << "Cubemap texture failed to load at path: " << faces[i] << std::endl;
-            std::cerr << "Reason: " << stbi_failure_reason() << std::endl;
-            stbi_image_free(data);
-        }
-    }
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glDeleteTextures(1, &cubemapTexture);
 }
 
 void Skybox::setupMesh()
@@ -116,16 +77,14 @@ void Skybox::setupMesh()
 
     glBindVertexArray(0);
 }
-void Skybox::render()
+void Skybox::record(RenderQueue& queue, const Shader& shader) const
 {
-    // Assume the shader is already in use and uniforms are set
-    glDepthFunc(GL_LEQUAL); // Change depth function for skybox rendering
-
-    glBindVertexArray(VAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
-
-    glDepthFunc(GL_LESS); // Restore default depth function
+    DrawCommand command;
+    command.shader = &shader;
+    command.textureTarget = GL_TEXTURE_CUBE_MAP;
+    command.texture = cubemapTexture;
+    command.vertexArray = VAO;
+    command.count = 36;
+
+    queue.push(PASS_SKYBOX, 0.0f, command);
 }
@@ -28,6 +28,35 @@ void SphereMesh::Draw() const
     glBindVertexArray(0);
 }
 
+unsigned int SphereMesh::getVAO() const
+{
+    return VAO;
+}
+
+unsigned int SphereMesh::getIndexCount() const
+{
+    return indexCount;
+}
+
+void SphereMesh::setResolution(unsigned int sectorCount, unsigned int stackCount)
+{
+    if (sectorCount == this->sectorCount && stackCount == this->stackCount)
+        return;
+
+    this->sectorCount = sectorCount;
+    this->stackCount = stackCount;
+    generateSphere();
+
+    // Same layout, new contents; the VAO keeps pointing at these buffers
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
 // Initializes OpenGL buffers and attribute pointers
 void SphereMesh::init()
 {
@@ -86,6 +115,18 @@ void SphereMesh::init()
 // Generates the sphere's vertex and index data
 void SphereMesh::generateSphere()
 {
+    generateSphere(radius, sectorCount, stackCount, vertices, indices);
+    indexCount = static_cast<unsigned int>(indices.size());
+}
+
+void SphereMesh::generateSphere(float radius, unsigned int sectorCount, unsigned int stackCount,
+                                std::vector<float>& vertices, std::vector<unsigned int>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.reserve((stackCount + 1) * (sectorCount + 1) * 8);
+    indices.reserve(stackCount * sectorCount * 6);
+
     float x, y, z, xy;                              // Vertex position
     float nx, ny, nz, lengthInv = 1.0f / radius;    // Vertex normal
     float s, t;                                     // Texture coordinates
@@ -153,6 +194,4 @@ void SphereMesh::generateSphere()
             }
         }
     }
-
-    indexCount = static_cast<unsigned int>(indices.size());
 }
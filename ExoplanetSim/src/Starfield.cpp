@@ -0,0 +1,377 @@
+// Starfield.cpp
+
+#include "Starfield.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// Obliquity of the ecliptic at J2000
+const double OBLIQUITY = 23.4393 * DEG_TO_RAD;
+
+// Galactic frame in J2000 equatorial coordinates
+const double GALACTIC_POLE_RA = 192.85948;
+const double GALACTIC_POLE_DEC = 27.12825;
+const double GALACTIC_CENTER_RA = 266.40499;
+const double GALACTIC_CENTER_DEC = -28.93617;
+
+// Magnitude with intensity 1; brighter stars grow instead of saturating
+const float REFERENCE_MAGNITUDE = 1.0f;
+
+// Bands averaged into a star's displayed flux
+const char* const DISPLAY_BANDS[] = { "B", "V", "R" };
+const int DISPLAY_BAND_COUNT = 3;
+
+// Milky Way band resolution and extent
+const int BAND_LONGITUDE_STEPS = 144;  // 2.5 degrees
+const int BAND_LATITUDE_STEPS = 24;
+const double BAND_HALF_WIDTH = 30.0;   // Degrees of galactic latitude
+
+// Ballesteros (2012): B-V color index to effective temperature
+float colorIndexToTemperature(float bv)
+{
+    return 4600.0f * (1.0f / (0.92f * bv + 1.7f) + 1.0f / (0.92f * bv + 0.62f));
+}
+
+void toUnitVector(double raDegrees, double decDegrees, double out[3])
+{
+    double ra = raDegrees * DEG_TO_RAD;
+    double dec = decDegrees * DEG_TO_RAD;
+    out[0] = std::cos(dec) * std::cos(ra);
+    out[1] = std::cos(dec) * std::sin(ra);
+    out[2] = std::sin(dec);
+}
+
+// Relative surface brightness of the band, a smooth stand-in for the
+// real distribution: brightest and widest toward the galactic center,
+// with the Great Rift darkening the plane from Cygnus to Sagittarius
+float bandIntensity(double longitude, double latitude)
+{
+    double l = std::fmod(longitude + 540.0, 360.0) - 180.0; // -180..180, 0 at the center
+    double bulge = std::exp(-(l * l) / (2.0 * 30.0 * 30.0));
+    double width = 5.0 + 7.0 * bulge;
+    double profile = std::exp(-(latitude * latitude) / (2.0 * width * width));
+    double disk = 0.3 + 0.35 * std::exp(-(l * l) / (2.0 * 70.0 * 70.0)) + 0.35 * bulge;
+
+    // Patchy structure along the plane
+    double clumps = 1.0 + 0.2 * std::sin(l * 0.11) * std::sin(l * 0.037 + 1.3)
+                        + 0.1 * std::sin(l * 0.29 + latitude * 0.4);
+
+    double rift = 1.0;
+    if (l > -10.0 && l < 80.0) {
+        double along = std::sin((l + 10.0) / 90.0 * 3.14159265358979323846);
+        rift -= 0.6 * along * std::exp(-((latitude - 1.5) * (latitude - 1.5)) / (2.0 * 2.5 * 2.5));
+    }
+
+    return static_cast<float>(disk * profile * clumps * rift);
+}
+
+} // namespace
+
+Starfield::Starfield()
+    : starVAO(0), quadVBO(0), instanceVBO(0), colorTable(0), bandVAO(0), bandVBO(0), bandEBO(0),
+      starCount(0), starLimit(-1), bandIndexCount(0), brightness(1.0f), milkyWayVisible(true)
+{
+    setupMilkyWay();
+}
+
+Starfield::~Starfield()
+{
+    glDeleteVertexArrays(1, &starVAO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteVertexArrays(1, &bandVAO);
+    glDeleteBuffers(1, &bandVBO);
+    glDeleteBuffers(1, &bandEBO);
+}
+
+bool Starfield::loadCatalog(const std::string& path)
+{
+    std::vector<StarInstance> stars;
+    if (!parseCatalog(path, stars))
+        return false;
+    setStars(stars);
+    return true;
+}
+
+bool Starfield::parseCatalog(const std::string& path, std::vector<StarInstance>& stars,
+                             const Photometry* photometry)
+{
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not open star catalog " << path << std::endl;
+        return false;
+    }
+
+    stars.clear();
+    std::vector<float> magnitudes; // V
+    std::string line;
+    int lineNumber = 0;
+    int skipped = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#' || line.compare(0, 5, "name,") == 0)
+            continue;
+
+        // The name may contain spaces but no commas
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+            fields.push_back(field);
+
+        char* end = nullptr;
+        double values[4];
+        bool valid = fields.size() >= 5;
+        for (int i = 0; valid && i < 4; ++i) {
+            values[i] = std::strtod(fields[i + 1].c_str(), &end);
+            valid = end != fields[i + 1].c_str();
+        }
+        if (!valid) {
+            if (skipped++ == 0)
+                std::cerr << "Warning: Skipping malformed catalog line " << lineNumber
+                          << " in " << path << std::endl;
+            continue;
+        }
+
+        StarInstance star;
+        equatorialToWorld(values[0], values[1], star.direction);
+
+        star.temperature = colorIndexToTemperature(static_cast<float>(values[3]));
+        stars.push_back(star);
+        magnitudes.push_back(static_cast<float>(values[2]));
+    }
+
+    if (stars.empty()) {
+        std::cerr << "Error: No stars in catalog " << path << std::endl;
+        return false;
+    }
+
+    std::vector<float> flux;
+    displayFlux(stars, magnitudes, photometry, flux);
+    for (size_t i = 0; i < stars.size(); ++i) {
+        // Faint stars keep a minimum footprint and fade instead; bright
+        // ones grow
+        stars[i].intensity = std::min(1.0f, std::sqrt(flux[i]));
+        stars[i].size = std::min(9.0f, 2.0f + 2.5f * std::pow(flux[i], 0.35f));
+    }
+
+    // Brightest first, so a star limit keeps the ones that matter most
+    std::stable_sort(stars.begin(), stars.end(),
+                     [](const StarInstance& a, const StarInstance& b) {
+                         return a.size > b.size;
+                     });
+
+    std::cout << "Star catalog loaded: " << stars.size() << " stars from " << path << std::endl;
+    return true;
+}
+
+void Starfield::displayFlux(const std::vector<StarInstance>& stars,
+                            const std::vector<float>& magnitudes,
+                            const Photometry* photometry, std::vector<float>& flux)
+{
+    int count = static_cast<int>(stars.size());
+    flux.assign(count, 0.0f);
+
+    // Synthetic magnitudes in the bands a display covers: the catalog's V
+    // plus the blackbody color of the star's temperature. Pogson: 5
+    // magnitudes are a factor of 100 in flux.
+    int reference = photometry ? photometry->findFilter("V") : -1;
+    int bandsUsed = 0;
+    if (reference >= 0) {
+        std::vector<float> temperatures(count);
+        for (int i = 0; i < count; ++i)
+            temperatures[i] = stars[i].temperature;
+        std::vector<float> colors(photometry->getFilterCount() * count);
+        photometry->evaluateColors(count, &temperatures[0], reference, &colors[0]);
+
+        for (int band = 0; band < DISPLAY_BAND_COUNT; ++band) {
+            int filter = photometry->findFilter(DISPLAY_BANDS[band]);
+            if (filter < 0)
+                continue;
+            const float* color = &colors[filter * count];
+            for (int i = 0; i < count; ++i)
+                flux[i] += std::pow(10.0f, -0.4f * (magnitudes[i] + color[i] - REFERENCE_MAGNITUDE));
+            ++bandsUsed;
+        }
+    }
+
+    // Without filters the catalog's V alone
+    if (bandsUsed == 0) {
+        for (int i = 0; i < count; ++i)
+            flux[i] = std::pow(10.0f, -0.4f * (magnitudes[i] - REFERENCE_MAGNITUDE));
+        return;
+    }
+    for (int i = 0; i < count; ++i)
+        flux[i] /= static_cast<float>(bandsUsed);
+}
+
+void Starfield::record(RenderQueue& queue, const Shader& starShader, const Shader& bandShader) const
+{
+    if (milkyWayVisible) {
+        DrawCommand band;
+        band.shader = &bandShader;
+        band.vertexArray = bandVAO;
+        band.count = bandIndexCount;
+        band.indexed = true;
+        queue.push(PASS_STARFIELD, 1.0f, band);
+    }
+
+    int drawn = getDrawnStarCount();
+    if (drawn == 0)
+        return;
+
+    float starBrightness = brightness;
+    DrawCommand stars;
+    stars.shader = &starShader;
+    stars.vertexArray = starVAO;
+    stars.primitive = GL_TRIANGLE_STRIP;
+    stars.count = 4;
+    stars.instanceCount = drawn;
+    stars.textureTarget = GL_TEXTURE_1D;
+    stars.texture = colorTable;
+    stars.setUniforms = [starBrightness](const Shader& s) {
+        s.setFloat("brightness", starBrightness);
+    };
+    queue.push(PASS_STARFIELD, 0.0f, stars);
+}
+
+int Starfield::getStarCount() const { return starCount; }
+void Starfield::setStarLimit(int limit) { starLimit = limit; }
+int Starfield::getDrawnStarCount() const { return starLimit < 0 ? starCount : std::min(starLimit, starCount); }
+void Starfield::setColorTable(GLuint texture) { colorTable = texture; }
+void Starfield::setBrightness(float value) { brightness = value; }
+float Starfield::getBrightness() const { return brightness; }
+void Starfield::setMilkyWayVisible(bool visible) { milkyWayVisible = visible; }
+bool Starfield::isMilkyWayVisible() const { return milkyWayVisible; }
+
+void Starfield::setStars(const std::vector<StarInstance>& stars)
+{
+    static const float corners[] = {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+        -1.0f,  1.0f,
+         1.0f,  1.0f
+    };
+
+    if (starVAO == 0) {
+        glGenVertexArrays(1, &starVAO);
+        glGenBuffers(1, &quadVBO);
+        glGenBuffers(1, &instanceVBO);
+    }
+    glBindVertexArray(starVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, stars.size() * sizeof(StarInstance), &stars[0], GL_STATIC_DRAW);
+
+    // Direction, temperature + intensity, size: advance once per instance
+    GLsizei stride = sizeof(StarInstance);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(StarInstance, direction));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(StarInstance, temperature));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(StarInstance, size));
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+    starCount = static_cast<int>(stars.size());
+}
+
+void Starfield::setupMilkyWay()
+{
+    // Galactic basis: x toward the center, z toward the north pole
+    double center[3], pole[3], y[3];
+    toUnitVector(GALACTIC_CENTER_RA, GALACTIC_CENTER_DEC, center);
+    toUnitVector(GALACTIC_POLE_RA, GALACTIC_POLE_DEC, pole);
+    y[0] = pole[1] * center[2] - pole[2] * center[1];
+    y[1] = pole[2] * center[0] - pole[0] * center[2];
+    y[2] = pole[0] * center[1] - pole[1] * center[0];
+
+    // Direction (3) and intensity (1) per vertex
+    std::vector<float> vertices;
+    vertices.reserve((BAND_LONGITUDE_STEPS + 1) * (BAND_LATITUDE_STEPS + 1) * 4);
+    for (int i = 0; i <= BAND_LONGITUDE_STEPS; ++i) {
+        double l = 360.0 * i / BAND_LONGITUDE_STEPS;
+        for (int j = 0; j <= BAND_LATITUDE_STEPS; ++j) {
+            double b = -BAND_HALF_WIDTH + 2.0 * BAND_HALF_WIDTH * j / BAND_LATITUDE_STEPS;
+            double cl = std::cos(l * DEG_TO_RAD), sl = std::sin(l * DEG_TO_RAD);
+            double cb = std::cos(b * DEG_TO_RAD), sb = std::sin(b * DEG_TO_RAD);
+
+            double equatorial[3];
+            for (int k = 0; k < 3; ++k)
+                equatorial[k] = cb * cl * center[k] + cb * sl * y[k] + sb * pole[k];
+            double ra = std::atan2(equatorial[1], equatorial[0]) / DEG_TO_RAD;
+            double dec = std::asin(std::max(-1.0, std::min(1.0, equatorial[2]))) / DEG_TO_RAD;
+
+            float direction[3];
+            equatorialToWorld(ra, dec, direction);
+            vertices.insert(vertices.end(), direction, direction + 3);
+            vertices.push_back(bandIntensity(l, b));
+        }
+    }
+
+    std::vector<unsigned int> indices;
+    int rowLength = BAND_LATITUDE_STEPS + 1;
+    for (int i = 0; i < BAND_LONGITUDE_STEPS; ++i) {
+        for (int j = 0; j < BAND_LATITUDE_STEPS; ++j) {
+            unsigned int a = i * rowLength + j;
+            unsigned int b = a + rowLength;
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(a + 1);
+            indices.push_back(a + 1);
+            indices.push_back(b);
+            indices.push_back(b + 1);
+        }
+    }
+    bandIndexCount = static_cast<int>(indices.size());
+
+    glGenVertexArrays(1, &bandVAO);
+    glGenBuffers(1, &bandVBO);
+    glGenBuffers(1, &bandEBO);
+    glBindVertexArray(bandVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, bandVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bandEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0],
+                 GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(3 * sizeof(float)));
+
+    glBindVertexArray(0);
+}
+
+void Starfield::equatorialToWorld(double raDegrees, double decDegrees, float out[3])
+{
+    double v[3];
+    toUnitVector(raDegrees, decDegrees, v);
+
+    // Rotate about the vernal equinox into ecliptic coordinates
+    double ey = v[1] * std::cos(OBLIQUITY) + v[2] * std::sin(OBLIQUITY);
+    double ez = -v[1] * std::sin(OBLIQUITY) + v[2] * std::cos(OBLIQUITY);
+
+    // Ecliptic north is world +y; the orbits lie in the xz plane
+    out[0] = static_cast<float>(v[0]);
+    out[1] = static_cast<float>(ez);
+    out[2] = static_cast<float>(-ey);
+}
@@ -0,0 +1,506 @@
+// TextureLoader.cpp
+
+#include "TextureLoader.h"
+#include "BlockCompression.h"
+#include "TraceProfiler.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+// EXT_texture_compression_s3tc is not part of the generated loader
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+TextureLoader::TextureLoader(ThreadPool& pool, size_t uploadBudget)
+    : pool(pool), uploadBudget(uploadBudget), uploadedLastFrame(0), residentBytes(0),
+      s3tcSupported(false), uploadBuffer(0), uploadBufferSize(0), readFramebuffer(0),
+      drawFramebuffer(0)
+{
+    glGenBuffers(1, &uploadBuffer);
+    glGenFramebuffers(1, &readFramebuffer);
+    glGenFramebuffers(1, &drawFramebuffer);
+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount && !s3tcSupported; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        s3tcSupported = name != nullptr && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0;
+    }
+    if (!s3tcSupported)
+        std::cout << "S3TC not supported, compressed textures are decoded on load" << std::endl;
+}
+
+TextureLoader::~TextureLoader()
+{
+    // Workers still decoding write into the requests
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        decodedSignal.wait(lock, [this] {
+            for (size_t i = 0; i < requests.size(); ++i) {
+                if (requests[i]->decodedCount < requests[i]->taskCount)
+                    return false;
+            }
+            return true;
+        });
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i]->staging != 0)
+            glDeleteTextures(1, &requests[i]->staging);
+        delete requests[i]->ktx;
+        delete requests[i];
+    }
+
+    glDeleteBuffers(1, &uploadBuffer);
+    glDeleteFramebuffers(1, &readFramebuffer);
+    glDeleteFramebuffers(1, &drawFramebuffer);
+}
+
+GLuint TextureLoader::load2D(const std::string& path, GLint wrap, bool flipVertically)
+{
+    static const unsigned char gray[4] = { 128, 128, 128, 255 };
+    GLuint texture = createPlaceholder(GL_TEXTURE_2D, gray);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    Request* request = addRequest(texture, GL_TEXTURE_2D, std::vector<std::string>(1, path));
+    if (request->ktx != nullptr)
+        pool.enqueue([this, request] { decodeKtx(request); });
+    else
+        pool.enqueue([this, request, flipVertically] { decode(request, 0, flipVertically); });
+    return texture;
+}
+
+GLuint TextureLoader::loadCubemap(const std::vector<std::string>& faces)
+{
+    static const unsigned char black[4] = { 0, 0, 0, 255 };
+    GLuint texture = createPlaceholder(GL_TEXTURE_CUBE_MAP, black);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    Request* request = addRequest(texture, GL_TEXTURE_CUBE_MAP, faces);
+    if (request->ktx != nullptr) {
+        pool.enqueue([this, request] { decodeKtx(request); });
+        return texture;
+    }
+
+    // One task per face so the faces decode in parallel
+    for (size_t i = 0; i < faces.size(); ++i) {
+        int index = static_cast<int>(i);
+        pool.enqueue([this, request, index] { decode(request, index, false); });
+    }
+    return texture;
+}
+
+void TextureLoader::update()
+{
+    TRACE_ZONE("TextureLoader::update");
+    size_t used = 0;
+    bool hadRequests = false;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Rows are tightly packed
+
+    for (size_t i = 0; i < requests.size() && used < uploadBudget; ) {
+        hadRequests = true;
+        Request* request = requests[i];
+        if (!isDecoded(request)) {
+            ++i; // Later requests may be ready first
+            continue;
+        }
+
+        if (request->ktx != nullptr)
+            used += uploadLevels(*request, uploadBudget - used);
+        else
+            used += uploadRows(*request, uploadBudget - used);
+        if (!isComplete(*request)) {
+            ++i; // Continues next frame
+            continue;
+        }
+
+        finish(*request);
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.erase(requests.begin() + i);
+        delete request->ktx;
+        delete request;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    uploadedLastFrame = used;
+
+    if (hadRequests && requests.empty()) {
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - firstRequestTime).count();
+        std::cout << "Textures streamed in " << ms << " ms" << std::endl;
+    }
+}
+
+void TextureLoader::finishAll()
+{
+    size_t budget = uploadBudget;
+    uploadBudget = static_cast<size_t>(-1);
+    while (getPendingCount() > 0) {
+        update();
+        if (getPendingCount() > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    uploadBudget = budget;
+}
+
+int TextureLoader::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(requests.size());
+}
+
+size_t TextureLoader::getBytesUploadedLastFrame() const { return uploadedLastFrame; }
+size_t TextureLoader::getResidentBytes() const { return residentBytes; }
+bool TextureLoader::isCompressionSupported() const { return s3tcSupported; }
+size_t TextureLoader::getUploadBudget() const { return uploadBudget; }
+void TextureLoader::setUploadBudget(size_t bytes) { uploadBudget = bytes; }
+
+GLuint TextureLoader::createPlaceholder(GLenum target, const unsigned char color[4]) const
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(target, texture);
+    if (target == GL_TEXTURE_CUBE_MAP) {
+        for (GLenum face = 0; face < 6; ++face)
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGBA8, 1, 1, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, color);
+    } else {
+        glTexImage2D(target, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, color);
+    }
+    glBindTexture(target, 0);
+    return texture;
+}
+
+TextureLoader::Request* TextureLoader::addRequest(GLuint texture, GLenum target,
+                                                  const std::vector<std::string>& paths)
+{
+    Request* request = new Request();
+    request->texture = texture;
+    request->target = target;
+    request->paths = paths;
+    request->ktx = nullptr;
+    request->ktxDecoded = false;
+    request->decodedCount = 0;
+    request->staging = 0;
+    request->face = 0;
+    request->row = 0;
+    request->level = -1;
+
+    if (paths.size() == 1 && KtxFile::isKtxPath(paths[0])) {
+        request->ktx = new KtxFile();
+        request->taskCount = 1;
+    } else {
+        request->images.resize(paths.size());
+        request->taskCount = static_cast<int>(paths.size());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (requests.empty())
+        firstRequestTime = std::chrono::steady_clock::now();
+    requests.push_back(request);
+    return request;
+}
+
+void TextureLoader::decode(Request* request, int index, bool flipVertically)
+{
+    // Worker thread: CPU only
+    TRACE_ZONE("Texture decode");
+    Image& image = request->images[index];
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
+    unsigned char* data = stbi_load(request->paths[index].c_str(),
+                                    &image.width, &image.height, &image.channels, 0);
+    image.failed = data == nullptr || getFormat(image.channels) == 0;
+    if (data != nullptr && !image.failed)
+        image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * image.channels);
+    else
+        image.error = data == nullptr ? stbi_failure_reason() : "unsupported channel count";
+    stbi_image_free(data);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++request->decodedCount;
+    }
+    decodedSignal.notify_all();
+}
+
+void TextureLoader::decodeKtx(Request* request)
+{
+    // Worker thread: CPU only
+    TRACE_ZONE("KTX read");
+    KtxFile& ktx = *request->ktx;
+    std::string error;
+    bool ok = ktx.read(request->paths[0], error);
+    int expectedFaces = request->target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+    bool bc1 = ktx.internalFormat == KtxFile::COMPRESSED_RGB_S3TC_DXT1;
+    bool bc3 = ktx.internalFormat == KtxFile::COMPRESSED_RGBA_S3TC_DXT5;
+    if (ok && ktx.faces != expectedFaces) {
+        ok = false;
+        error = expectedFaces == 6 ? "not a cubemap" : "not a 2D texture";
+    } else if (ok && !bc1 && !bc3) {
+        ok = false;
+        error = "unsupported internal format";
+    }
+
+    if (ok && !s3tcSupported) {
+        // Expand every level to RGBA8 so the upload path stays the same
+        BlockCompression::Format format = bc1 ? BlockCompression::BC1 : BlockCompression::BC3;
+        for (int level = 0; level < ktx.getLevelCount(); ++level) {
+            int width = ktx.getLevelWidth(level);
+            int height = ktx.getLevelHeight(level);
+            for (int face = 0; face < ktx.faces; ++face) {
+                std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+                BlockCompression::decompress(format, &ktx.levels[level][face][0], width, height, &pixels[0]);
+                ktx.levels[level][face].swap(pixels);
+            }
+        }
+        request->ktxDecoded = true;
+    }
+
+    if (ok)
+        request->level = ktx.getLevelCount() - 1;
+    else
+        request->ktxError = error;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++request->decodedCount;
+    }
+    decodedSignal.notify_all();
+}
+
+bool TextureLoader::isDecoded(const Request* request) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return request->decodedCount == request->taskCount;
+}
+
+bool TextureLoader::isComplete(const Request& request) const
+{
+    if (request.ktx != nullptr)
+        return request.level < 0;
+    return request.face >= static_cast<int>(request.images.size());
+}
+
+size_t TextureLoader::uploadRows(Request& request, size_t budget)
+{
+    if (request.staging == 0) {
+        glGenTextures(1, &request.staging);
+        glBindTexture(request.target, request.staging);
+        for (size_t i = 0; i < request.images.size(); ++i) {
+            const Image& image = request.images[i];
+            if (image.failed)
+                continue;
+            GLenum face = request.target == GL_TEXTURE_CUBE_MAP
+                ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(i) : GL_TEXTURE_2D;
+            GLenum format = getFormat(image.channels);
+            glTexImage2D(face, 0, format == GL_RED ? GL_R8 : format == GL_RGB ? GL_RGB8 : GL_RGBA8,
+                         image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
+    size_t used = 0;
+    glBindTexture(request.target, request.staging);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+
+    while (request.face < static_cast<int>(request.images.size()) && used < budget) {
+        Image& image = request.images[request.face];
+        if (image.failed) {
+            ++request.face;
+            continue;
+        }
+
+        // Whole rows that fit the remaining budget (at least one)
+        size_t rowBytes = static_cast<size_t>(image.width) * image.channels;
+        int rows = static_cast<int>(std::max<size_t>(1, (budget - used) / rowBytes));
+        rows = std::min(rows, image.height - request.row);
+        size_t bytes = rowBytes * rows;
+
+        // Orphan the buffer so the previous chunk can still be in flight
+        uploadBufferSize = std::max(uploadBufferSize, bytes);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, uploadBufferSize, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped != nullptr) {
+            std::memcpy(mapped, &image.pixels[rowBytes * request.row], bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+            GLenum face = request.target == GL_TEXTURE_CUBE_MAP
+                ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(request.face) : GL_TEXTURE_2D;
+            glTexSubImage2D(face, 0, 0, request.row, image.width, rows,
+                            getFormat(image.channels), GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        used += bytes;
+        request.row += rows;
+        if (request.row >= image.height) {
+            std::vector<unsigned char>().swap(image.pixels); // Release the CPU copy
+            ++request.face;
+            request.row = 0;
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(request.target, 0);
+    return used;
+}
+
+size_t TextureLoader::uploadLevels(Request& request, size_t budget)
+{
+    // The owner may have deleted the texture while it was decoding
+    if (request.level < 0 || !glIsTexture(request.texture)) {
+        request.level = -1;
+        return 0;
+    }
+
+    const KtxFile& ktx = *request.ktx;
+    int levelCount = ktx.getLevelCount();
+    size_t used = 0;
+    glBindTexture(request.target, request.texture);
+
+    // Whole levels, at least one per frame. The chain only grows finer,
+    // so the first upload is tiny and the last one is most of the data.
+    while (request.level >= 0 && used < budget) {
+        int level = request.level;
+        int width = ktx.getLevelWidth(level);
+        int height = ktx.getLevelHeight(level);
+        for (int face = 0; face < ktx.faces; ++face) {
+            GLenum target = request.target == GL_TEXTURE_CUBE_MAP
+                ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(face) : GL_TEXTURE_2D;
+            const std::vector<unsigned char>& data = ktx.levels[level][face];
+            if (request.ktxDecoded)
+                glTexImage2D(target, level, GL_RGBA8, width, height, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, &data[0]);
+            else
+                glCompressedTexImage2D(target, level, ktx.internalFormat, width, height, 0,
+                                       static_cast<GLsizei>(data.size()), &data[0]);
+            used += data.size();
+        }
+
+        // Sample only the levels resident so far; the placeholder at
+        // level 0 stays outside the range until it is replaced
+        glTexParameteri(request.target, GL_TEXTURE_BASE_LEVEL, level);
+        glTexParameteri(request.target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        if (level == levelCount - 1)
+            glTexParameteri(request.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+        for (int face = 0; face < ktx.faces; ++face)
+            std::vector<unsigned char>().swap(request.ktx->levels[level][face]);
+        --request.level;
+    }
+
+    glBindTexture(request.target, 0);
+    residentBytes += used;
+    return used;
+}
+
+void TextureLoader::finish(Request& request)
+{
+    if (request.ktx != nullptr) {
+        const KtxFile& ktx = *request.ktx;
+        if (!request.ktxError.empty()) {
+            std::cerr << "Texture failed to load at path: " << request.paths[0] << std::endl;
+            std::cerr << "Reason: " << request.ktxError << std::endl;
+            return;
+        }
+        const char* format = ktx.internalFormat == KtxFile::COMPRESSED_RGB_S3TC_DXT1 ? "BC1" : "BC3";
+        std::cout << "Texture loaded successfully: " << request.paths[0] << " (" << ktx.width
+                  << "x" << ktx.height << ", " << format << (request.ktxDecoded ? " decoded" : "")
+                  << ", " << ktx.getLevelCount() << " levels, "
+                  << ktx.getTotalSize() / (1024.0 * 1024.0) << " MB)" << std::endl;
+        return;
+    }
+
+
+    bool anyLoaded = false;
+    for (size_t i = 0; i < request.images.size(); ++i) {
+        const Image& image = request.images[i];
+        if (image.failed) {
+            std::cerr << "Texture failed to load at path: " << request.paths[i] << std::endl;
+            std::cerr << "Reason: " << image.error << std::endl;
+        } else {
+            anyLoaded = true;
+        }
+    }
+
+    // The owner may have deleted the texture while it was streaming
+    if (!anyLoaded || !glIsTexture(request.texture)) {
+        glDeleteTextures(1, &request.staging);
+        request.staging = 0;
+        return;
+    }
+
+    // Reallocate the caller's texture and copy the staged image in
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glBindTexture(request.target, request.texture);
+
+    for (size_t i = 0; i < request.images.size(); ++i) {
+        const Image& image = request.images[i];
+        if (image.failed)
+            continue;
+
+        GLenum face = request.target == GL_TEXTURE_CUBE_MAP
+            ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(i) : GL_TEXTURE_2D;
+        GLenum format = getFormat(image.channels);
+        glTexImage2D(face, 0, format == GL_RED ? GL_R8 : format == GL_RGB ? GL_RGB8 : GL_RGBA8,
+                     image.width, image.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, face, request.staging, 0);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, face, request.texture, 0);
+        glBlitFramebuffer(0, 0, image.width, image.height, 0, 0, image.width, image.height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        std::cout << "Texture loaded successfully: " << request.paths[i] << " (" << image.width
+                  << "x" << image.height << ", " << image.channels << " channels)" << std::endl;
+    }
+
+    // Detach so the names can be deleted freely
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Staged levels plus the generated mip chain (a third more)
+    for (size_t i = 0; i < request.images.size(); ++i) {
+        const Image& image = request.images[i];
+        if (!image.failed)
+            residentBytes += static_cast<size_t>(image.width) * image.height * image.channels
+                * (request.target == GL_TEXTURE_2D ? 4 : 3) / 3;
+    }
+
+    if (request.target == GL_TEXTURE_2D)
+        glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(request.target, 0);
+
+    glDeleteTextures(1, &request.staging);
+    request.staging = 0;
+}
+
+GLenum TextureLoader::getFormat(int channels)
+{
+    switch (channels) {
+    case 1: return GL_RED;
+    case 3: return GL_RGB;
+    case 4: return GL_RGBA;
+    default: return 0;
+    }
+}
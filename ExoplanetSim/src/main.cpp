@@ -2,9 +2,15 @@
 
 #include "Application.h"
 
-int main()
+int main(int argc, char** argv)
 {
-    Application app;
+    AppOptions options;
+    if (!AppOptions::parse(argc, argv, options))
+    {
+        return 1;
+    }
+
+    Application app(options);
 
     if (!app.initialize())
     {
@@ -0,0 +1,141 @@
+"""Reader for the simulator's live state feed (--state-feed NAME).
+
+The layout mirrors core/include/StateFeed.h (version 1). Frames are read
+with the same sequence-lock protocol as StateFeed::readLatest: a copy is
+kept only if the slot's sequence was even and unchanged around it.
+
+    python3 tools/statefeed.py /exosim          # print the newest frame
+    python3 tools/statefeed.py /exosim --watch  # keep printing at 10 Hz
+
+From other scripts:
+
+    feed = StateFeed("/exosim")
+    frame = feed.read_latest()
+    frame["bodies"][1]["flux"]
+"""
+
+import struct
+import sys
+import time
+from multiprocessing import resource_tracker, shared_memory
+
+MAGIC = b"EXOFEED\0"
+VERSION = 1
+MAX_BODIES = 8
+
+HEADER = struct.Struct("=8s6IQ24x")              # 64 bytes
+PUBLISHED_OFFSET = 32
+SEQUENCE = struct.Struct("=I4x")                 # 8 bytes before each frame
+FRAME = struct.Struct("=Qd3fI")                  # 32 bytes
+BODY = struct.Struct("=Ii3d10f")                 # 72 bytes
+SLOT_SIZE = SEQUENCE.size + FRAME.size + MAX_BODIES * BODY.size
+
+BODY_KINDS = ("star", "planet", "moon")
+BODY_FIELDS = ("mass", "radius", "temperature", "semi_major_axis", "eccentricity",
+               "period", "phase", "star_distance", "flux", "equilibrium_temperature")
+
+READ_ATTEMPTS = 16
+
+
+class StateFeed:
+    def __init__(self, name):
+        # Python names the object without the leading slash
+        self.name = name if name.startswith("/") else "/" + name
+        self.memory = shared_memory.SharedMemory(name=self.name.lstrip("/"))
+        # Attaching must not make this process remove the writer's object
+        # at exit
+        try:
+            resource_tracker.unregister(self.memory._name, "shared_memory")
+        except Exception:
+            pass
+        self.buffer = self.memory.buf
+
+        magic, version, header_size, slot_size, slot_count, max_bodies, pid, _ = \
+            HEADER.unpack_from(self.buffer, 0)
+        if (magic != MAGIC or version != VERSION or header_size != HEADER.size
+                or slot_size != SLOT_SIZE or max_bodies != MAX_BODIES or slot_count == 0):
+            self.close()
+            raise ValueError("%s is not a version %d state feed" % (self.name, VERSION))
+        self.slot_count = slot_count
+        self.writer_pid = pid
+
+    def close(self):
+        self.buffer = None
+        self.memory.close()
+
+    def published(self):
+        return struct.unpack_from("=Q", self.buffer, PUBLISHED_OFFSET)[0]
+
+    def read_latest(self):
+        """Newest complete frame as a dict, or None."""
+        for _ in range(READ_ATTEMPTS):
+            published = self.published()
+            if published == 0:
+                return None
+            offset = HEADER.size + ((published - 1) % self.slot_count) * SLOT_SIZE
+            before = SEQUENCE.unpack_from(self.buffer, offset)[0]
+            if before & 1:
+                continue
+            data = bytes(self.buffer[offset + SEQUENCE.size:offset + SLOT_SIZE])
+            if SEQUENCE.unpack_from(self.buffer, offset)[0] == before:
+                return parse_frame(data)
+        return None
+
+
+def parse_frame(data):
+    frame, sim_time, luminosity, inner, outer, count = FRAME.unpack_from(data, 0)
+    bodies = []
+    for i in range(min(count, MAX_BODIES)):
+        values = BODY.unpack_from(data, FRAME.size + i * BODY.size)
+        kind, parent = values[0], values[1]
+        body = {
+            "kind": BODY_KINDS[kind] if kind < len(BODY_KINDS) else kind,
+            "parent": parent,
+            "position": values[2:5],
+        }
+        body.update(zip(BODY_FIELDS, values[5:]))
+        bodies.append(body)
+    return {
+        "frame": frame,
+        "time": sim_time,
+        "luminosity": luminosity,
+        "habitable_zone": (inner, outer),
+        "bodies": bodies,
+    }
+
+
+def print_frame(frame):
+    inner, outer = frame["habitable_zone"]
+    print("frame %d  t=%.2f d  L=%.3g Lsun  HZ %.2f-%.2f AU"
+          % (frame["frame"], frame["time"], frame["luminosity"], inner, outer))
+    for i, body in enumerate(frame["bodies"]):
+        x, y, z = body["position"]
+        print("  %d %-6s (%8.3f %8.3f %8.3f)  d=%7.3f AU  flux=%8.3f  Teq=%6.1f K"
+              % (i, body["kind"], x, y, z, body["star_distance"], body["flux"],
+                 body["equilibrium_temperature"]))
+
+
+def main(argv):
+    if len(argv) < 2:
+        print("Usage: %s NAME [--watch]" % argv[0])
+        return 1
+    feed = StateFeed(argv[1])
+    try:
+        while True:
+            frame = feed.read_latest()
+            if frame is None:
+                print("No frame published yet")
+            else:
+                print_frame(frame)
+            if "--watch" not in argv[2:]:
+                break
+            time.sleep(0.1)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        feed.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
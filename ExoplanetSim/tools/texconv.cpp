@@ -0,0 +1,221 @@
+// texconv.cpp
+//
+// Offline converter from JPEG/PNG to KTX with a BC1/BC3 mip chain.
+//
+//   texconv [--bc1|--bc3] [--no-flip] input.jpg output.ktx
+//   texconv --cube [--bc1|--bc3] right left top bottom front back output.ktx
+//
+// 2D images are flipped vertically like the runtime loader did with
+// stbi_set_flip_vertically_on_load; cubemap faces are not. Without a
+// format flag, images with any transparency use BC3 and others BC1.
+
+#include "BlockCompression.h"
+#include "KtxFile.h"
+#include "stb_image.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Image {
+    int width;
+    int height;
+    std::vector<unsigned char> rgba;
+};
+
+// sRGB <-> linear so mips do not darken
+float toLinear(unsigned char value)
+{
+    float c = value / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+unsigned char toSrgb(float linear)
+{
+    float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+    c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+    return static_cast<unsigned char>(c * 255.0f + 0.5f);
+}
+
+// 2x2 box filter in linear light; odd edges repeat the last texel
+Image downsample(const Image& source)
+{
+    static float linear[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (int i = 0; i < 256; ++i)
+            linear[i] = toLinear(static_cast<unsigned char>(i));
+        tableReady = true;
+    }
+
+    Image result;
+    result.width = source.width > 1 ? source.width / 2 : 1;
+    result.height = source.height > 1 ? source.height / 2 : 1;
+    result.rgba.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+    for (int y = 0; y < result.height; ++y) {
+        for (int x = 0; x < result.width; ++x) {
+            float sum[4] = { 0, 0, 0, 0 };
+            for (int dy = 0; dy < 2; ++dy) {
+                int sy = std::min(y * 2 + dy, source.height - 1);
+                for (int dx = 0; dx < 2; ++dx) {
+                    int sx = std::min(x * 2 + dx, source.width - 1);
+                    const unsigned char* p = &source.rgba[(static_cast<size_t>(sy) * source.width + sx) * 4];
+                    for (int c = 0; c < 3; ++c)
+                        sum[c] += linear[p[c]];
+                    sum[3] += p[3];
+                }
+            }
+            unsigned char* out = &result.rgba[(static_cast<size_t>(y) * result.width + x) * 4];
+            for (int c = 0; c < 3; ++c)
+                out[c] = toSrgb(sum[c] / 4.0f);
+            out[3] = static_cast<unsigned char>(sum[3] / 4.0f + 0.5f);
+        }
+    }
+    return result;
+}
+
+bool loadImage(const std::string& path, bool flip, Image& image)
+{
+    stbi_set_flip_vertically_on_load(flip);
+    int channels;
+    unsigned char* data = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+    if (data == nullptr) {
+        std::cerr << "Error: Cannot read " << path << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    image.rgba.assign(data, data + static_cast<size_t>(image.width) * image.height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+bool hasTransparency(const Image& image)
+{
+    for (size_t i = 3; i < image.rgba.size(); i += 4)
+        if (image.rgba[i] != 255)
+            return true;
+    return false;
+}
+
+std::vector<unsigned char> compressLevel(BlockCompression::Format format, const Image& image)
+{
+    std::vector<unsigned char> blocks(BlockCompression::getCompressedSize(format, image.width, image.height));
+    BlockCompression::compress(format, &image.rgba[0], image.width, image.height, &blocks[0]);
+    return blocks;
+}
+
+// Peak signal-to-noise ratio of the compressed top level (RGB)
+double measurePsnr(BlockCompression::Format format, const Image& image, const std::vector<unsigned char>& blocks)
+{
+    std::vector<unsigned char> decoded(image.rgba.size());
+    BlockCompression::decompress(format, &blocks[0], image.width, image.height, &decoded[0]);
+
+    double squaredError = 0.0;
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        if (i % 4 == 3)
+            continue;
+        double d = static_cast<double>(decoded[i]) - image.rgba[i];
+        squaredError += d * d;
+    }
+    double mse = squaredError / (image.rgba.size() / 4 * 3);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+void printUsage()
+{
+    std::cout << "Usage: texconv [--bc1|--bc3] [--no-flip] input output.ktx\n"
+              << "       texconv --cube [--bc1|--bc3] +x -x +y -y +z -z output.ktx" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    bool cube = false, flip = true, formatForced = false;
+    BlockCompression::Format format = BlockCompression::BC1;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cube") {
+            cube = true;
+        } else if (arg == "--bc1") {
+            format = BlockCompression::BC1;
+            formatForced = true;
+        } else if (arg == "--bc3") {
+            format = BlockCompression::BC3;
+            formatForced = true;
+        } else if (arg == "--no-flip") {
+            flip = false;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    size_t inputCount = cube ? 6 : 1;
+    if (paths.size() != inputCount + 1) {
+        printUsage();
+        return 1;
+    }
+    std::string output = paths.back();
+
+    std::vector<Image> faces(inputCount);
+    for (size_t i = 0; i < inputCount; ++i) {
+        if (!loadImage(paths[i], cube ? false : flip, faces[i]))
+            return 1;
+        if (faces[i].width != faces[0].width || faces[i].height != faces[0].height) {
+            std::cerr << "Error: Cubemap faces must have the same size." << std::endl;
+            return 1;
+        }
+        if (!formatForced && hasTransparency(faces[i]))
+            format = BlockCompression::BC3;
+    }
+
+    KtxFile ktx;
+    ktx.internalFormat = format == BlockCompression::BC1 ? KtxFile::COMPRESSED_RGB_S3TC_DXT1
+                                                         : KtxFile::COMPRESSED_RGBA_S3TC_DXT5;
+    ktx.baseInternalFormat = format == BlockCompression::BC1 ? KtxFile::BASE_RGB : KtxFile::BASE_RGBA;
+    ktx.width = faces[0].width;
+    ktx.height = faces[0].height;
+    ktx.faces = static_cast<int>(inputCount);
+
+    // Full chain down to 1x1
+    double psnr = 0.0;
+    for (int level = 0; ; ++level) {
+        ktx.levels.push_back(std::vector<std::vector<unsigned char> >());
+        for (size_t face = 0; face < inputCount; ++face) {
+            ktx.levels.back().push_back(compressLevel(format, faces[face]));
+            if (level == 0)
+                psnr += measurePsnr(format, faces[face], ktx.levels.back().back()) / inputCount;
+        }
+
+        if (faces[0].width == 1 && faces[0].height == 1)
+            break;
+        for (size_t face = 0; face < inputCount; ++face)
+            faces[face] = downsample(faces[face]);
+    }
+
+    if (!ktx.write(output)) {
+        std::cerr << "Error: Cannot write " << output << std::endl;
+        return 1;
+    }
+
+    // What the same chain costs as RGBA8 in video memory
+    double uncompressed = 0.0;
+    for (int level = 0; level < ktx.getLevelCount(); ++level)
+        uncompressed += 4.0 * ktx.getLevelWidth(level) * ktx.getLevelHeight(level) * ktx.faces;
+
+    std::cout << output << ": " << (format == BlockCompression::BC1 ? "BC1" : "BC3") << " "
+              << ktx.width << "x" << ktx.height << (cube ? " cubemap" : "") << ", "
+              << ktx.getLevelCount() << " levels, " << ktx.getTotalSize() / 1024 << " KB ("
+              << uncompressed / ktx.getTotalSize() << "x smaller than RGBA8), PSNR "
+              << psnr << " dB" << std::endl;
+    return 0;
+}